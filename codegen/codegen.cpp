@@ -11,9 +11,10 @@
 
 // 代码生成器构造函数，初始化输出文件和配置
 CodeGenerator::CodeGenerator(std::ostream& outputStream,  
-                           const std::vector<std::shared_ptr<IRInstr>>& instructions,
+                           const std::vector<IRInstr*>& instructions,
+                           const IRNames& names,
                            const CodeGenConfig& config)
-    : output(outputStream), instructions(instructions), config(config) {
+    : output(outputStream), instructions(instructions), names(names), config(config) {
     
     
     std::cerr << "CodeGenerator构造函数开始\n";
@@ -110,7 +111,7 @@ void CodeGenerator::generate() {
 
 // 将单条IR指令处理结果写入指定流
 // 临时重定向输出，处理指令，然后恢复原始输出
-void CodeGenerator::processInstructionToStream(const std::shared_ptr<IRInstr>& instr, std::ostream& stream) {
+void CodeGenerator::processInstructionToStream(const IRInstr* instr, std::ostream& stream) {
     // 保存原始处理方法的输出
     std::streambuf* originalBuf = output.std::ostream::rdbuf();
     
@@ -162,7 +163,7 @@ void CodeGenerator::emitSection(const std::string& section) {
 
 // 处理IR指令
 // 根据指令的操作码类型调用相应的处理函数
-void CodeGenerator::processInstruction(const std::shared_ptr<IRInstr>& instr) {
+void CodeGenerator::processInstruction(const IRInstr* instr) {
     // 根据指令类型调用相应的处理函数
     switch (instr->opcode) {
         case OpCode::ADD:
@@ -178,48 +179,48 @@ void CodeGenerator::processInstruction(const std::shared_ptr<IRInstr>& instr) {
         case OpCode::NE:
         case OpCode::AND:
         case OpCode::OR:
-            processBinaryOp(std::dynamic_pointer_cast<BinaryOpInstr>(instr));
+            processBinaryOp(static_cast<const BinaryOpInstr*>(instr));
             break;
             
         case OpCode::NEG:
         case OpCode::NOT:
-            processUnaryOp(std::dynamic_pointer_cast<UnaryOpInstr>(instr));
+            processUnaryOp(static_cast<const UnaryOpInstr*>(instr));
             break;
             
         case OpCode::ASSIGN:
-            processAssign(std::dynamic_pointer_cast<AssignInstr>(instr));
+            processAssign(static_cast<const AssignInstr*>(instr));
             break;
             
         case OpCode::GOTO:
-            processGoto(std::dynamic_pointer_cast<GotoInstr>(instr));
+            processGoto(static_cast<const GotoInstr*>(instr));
             break;
             
         case OpCode::IF_GOTO:
-            processIfGoto(std::dynamic_pointer_cast<IfGotoInstr>(instr));
+            processIfGoto(static_cast<const IfGotoInstr*>(instr));
             break;
             
         case OpCode::PARAM:
-            processParam(std::dynamic_pointer_cast<ParamInstr>(instr));
+            processParam(static_cast<const ParamInstr*>(instr));
             break;
             
         case OpCode::CALL:
-            processCall(std::dynamic_pointer_cast<CallInstr>(instr));
+            processCall(static_cast<const CallInstr*>(instr));
             break;
             
         case OpCode::RETURN:
-            processReturn(std::dynamic_pointer_cast<ReturnInstr>(instr));
+            processReturn(static_cast<const ReturnInstr*>(instr));
             break;
             
         case OpCode::LABEL:
-            processLabel(std::dynamic_pointer_cast<LabelInstr>(instr));
+            processLabel(static_cast<const LabelInstr*>(instr));
             break;
             
         case OpCode::FUNCTION_BEGIN:
-            processFunctionBegin(std::dynamic_pointer_cast<FunctionBeginInstr>(instr));
+            processFunctionBegin(static_cast<const FunctionBeginInstr*>(instr));
             break;
             
         case OpCode::FUNCTION_END:
-            processFunctionEnd(std::dynamic_pointer_cast<FunctionEndInstr>(instr));
+            processFunctionEnd(static_cast<const FunctionEndInstr*>(instr));
             break;
             
         default:
@@ -231,8 +232,8 @@ void CodeGenerator::processInstruction(const std::shared_ptr<IRInstr>& instr) {
 // 处理二元操作指令
 // 为二元运算生成相应的RISC-V汇编代码
 // AND 和 OR 要短路求值
-void CodeGenerator::processBinaryOp(const std::shared_ptr<BinaryOpInstr>& instr) {
-    emitComment(instr->toString());
+void CodeGenerator::processBinaryOp(const BinaryOpInstr* instr) {
+    emitComment(instr->toString(names));
 
     // 获取临时寄存器
     std::string resultReg = allocTempReg();
@@ -358,8 +359,8 @@ void CodeGenerator::processBinaryOp(const std::shared_ptr<BinaryOpInstr>& instr)
 
 // 处理一元操作指令
 // 为一元运算生成相应的RISC-V汇编代码
-void CodeGenerator::processUnaryOp(const std::shared_ptr<UnaryOpInstr>& instr) {
-    emitComment(instr->toString());
+void CodeGenerator::processUnaryOp(const UnaryOpInstr* instr) {
+    emitComment(instr->toString(names));
     
     // 获取临时寄存器
     std::string resultReg = allocTempReg();
@@ -391,8 +392,8 @@ void CodeGenerator::processUnaryOp(const std::shared_ptr<UnaryOpInstr>& instr) {
 
 // 处理赋值指令
 // 将源操作数的值赋给目标操作数
-void CodeGenerator::processAssign(const std::shared_ptr<AssignInstr>& instr) {
-    emitComment(instr->toString());
+void CodeGenerator::processAssign(const AssignInstr* instr) {
+    emitComment(instr->toString(names));
     
     // 获取临时寄存器
     std::string reg = allocTempReg();
@@ -409,17 +410,17 @@ void CodeGenerator::processAssign(const std::shared_ptr<AssignInstr>& instr) {
 
 // 处理无条件跳转指令
 // 生成无条件跳转到目标标签的指令
-void CodeGenerator::processGoto(const std::shared_ptr<GotoInstr>& instr) {
-    emitComment(instr->toString());
+void CodeGenerator::processGoto(const GotoInstr* instr) {
+    emitComment(instr->toString(names));
     
     // 直接跳转到目标标签
-    emitInstruction("j " + instr->target->name);
+    emitInstruction("j " + names.labelName(instr->target.id));
 }
 
 // 处理条件跳转指令
 // 如果条件为真，则跳转到目标标签
-void CodeGenerator::processIfGoto(const std::shared_ptr<IfGotoInstr>& instr) {
-    emitComment(instr->toString());
+void CodeGenerator::processIfGoto(const IfGotoInstr* instr) {
+    emitComment(instr->toString(names));
     
     // 获取临时寄存器
     std::string condReg = allocTempReg();
@@ -428,7 +429,7 @@ void CodeGenerator::processIfGoto(const std::shared_ptr<IfGotoInstr>& instr) {
     loadOperand(instr->condition, condReg);
     
     // 如果条件为真（非零），则跳转到目标标签
-    emitInstruction("bnez " + condReg + ", " + instr->target->name);
+    emitInstruction("bnez " + condReg + ", " + names.labelName(instr->target.id));
     
     // 释放临时寄存器
     freeTempReg(condReg);
@@ -440,8 +441,8 @@ void CodeGenerator::processIfGoto(const std::shared_ptr<IfGotoInstr>& instr) {
 
 // 处理参数指令
 // 将参数添加到参数队列中，等待后续函数调用使用
-void CodeGenerator::processParam(const std::shared_ptr<ParamInstr>& instr) {
-    emitComment(instr->toString());
+void CodeGenerator::processParam(const ParamInstr* instr) {
+    emitComment(instr->toString(names));
     
     // 将参数添加到参数队列
     paramQueue.push_back(instr->param);
@@ -450,22 +451,22 @@ void CodeGenerator::processParam(const std::shared_ptr<ParamInstr>& instr) {
 
 // 处理函数调用指令
 // 准备参数，调用函数，处理返回值
-void CodeGenerator::processCall(const std::shared_ptr<CallInstr>& instr) {
+void CodeGenerator::processCall(const CallInstr* instr) {
     // 添加空指针检查
     if (!instr) {
         std::cerr << "错误: 空的函数调用指令" << std::endl;
         return;
     }
 
-    emitComment(instr->toString());
+    emitComment(instr->toString(names));
     
     // 获取参数个数
     int paramCount = instr->paramCount;
-    std::vector<std::shared_ptr<Operand>> params;
+    std::vector<Operand> params;
     
     // 优先使用 CallInstr 中存储的参数列表
     if (!instr->params.empty()) {
-        params = instr->params;
+        params.assign(instr->params.begin(), instr->params.end());
     } else if (!paramQueue.empty()) {
         // 兼容旧代码，使用 paramQueue
         if (paramQueue.size() >= paramCount) {
@@ -499,7 +500,7 @@ void CodeGenerator::processCall(const std::shared_ptr<CallInstr>& instr) {
     // 3. 传递参数
     // 3.1 寄存器参数（a0-a7）
     for (int i = 0; i < std::min(8, paramCount); ++i) {
-        if (!params[i]) continue;
+        if (params[i].isNone()) continue;
         loadOperand(params[i], "a" + std::to_string(i));
     }
 
@@ -507,7 +508,7 @@ void CodeGenerator::processCall(const std::shared_ptr<CallInstr>& instr) {
     // 越靠近栈顶的参数索引越小
     int stackParamOffset = 0;
     for (int i = 8; i < paramCount; ++i) {
-        if (!params[i]) continue;
+        if (params[i].isNone()) continue;
         std::string tempReg = allocTempReg();
         loadOperand(params[i], tempReg);
         emitInstruction("sw " + tempReg + ", " + std::to_string(stackParamOffset) + "(sp)");
@@ -516,13 +517,13 @@ void CodeGenerator::processCall(const std::shared_ptr<CallInstr>& instr) {
     }
 
     // 4. 调用函数
-    emitInstruction("call " + instr->funcName);
+    emitInstruction("call " + names.functionName(instr->callee));
 
     // 5. 恢复调用者寄存器
     restoreCallerSavedRegs();
 
     // 6. 处理返回值
-    if (instr->result) {
+    if (!instr->result.isNone()) {
         std::string resultReg = allocTempReg();
         //emitInstruction("mv " + resultReg + ", a0");      
         emitInstruction("addi " + resultReg + ", a0" + ", 0");
@@ -538,13 +539,13 @@ void CodeGenerator::processCall(const std::shared_ptr<CallInstr>& instr) {
 
 // 处理返回指令
 // 如果有返回值，将其加载到a0寄存器，然后跳转到函数结束处理
-void CodeGenerator::processReturn(const std::shared_ptr<ReturnInstr>& instr) {
-    emitComment(instr->toString());
+void CodeGenerator::processReturn(const ReturnInstr* instr) {
+    emitComment(instr->toString(names));
     
     // 如果有返回值，加载到a0
-    if (instr->value) {
+    if (!instr->value.isNone()) {
         loadOperand(instr->value, "a0");
-    }else if (currentFunctionReturnType != "void") {
+    }else if (currentFunctionReturnsValue) {
         // 如果函数返回类型不是void，但没有明确的返回值，默认返回0
         emitInstruction("li a0, 0");
     }
@@ -555,14 +556,14 @@ void CodeGenerator::processReturn(const std::shared_ptr<ReturnInstr>& instr) {
 
 // 处理标签指令
 // 在汇编代码中生成标签定义
-void CodeGenerator::processLabel(const std::shared_ptr<LabelInstr>& instr) {
+void CodeGenerator::processLabel(const LabelInstr* instr) {
     // 生成标签
-    emitLabel(instr->label);
+    emitLabel(names.labelName(instr->label));
 }
 
 // 处理函数开始指令
 // 初始化函数上下文，生成函数标签和序言
-void CodeGenerator::processFunctionBegin(const std::shared_ptr<FunctionBeginInstr>& instr) {
+void CodeGenerator::processFunctionBegin(const FunctionBeginInstr* instr) {
     // 添加空指针检查
     if (!instr) {
         std::cerr << "错误: 空的函数开始指令" << std::endl;
@@ -570,9 +571,9 @@ void CodeGenerator::processFunctionBegin(const std::shared_ptr<FunctionBeginInst
     }
     
     // 初始化函数上下文
-    currentFunction = instr->funcName;
-    currentFunctionReturnType = instr->returnType;
-    currentFunctionParams = instr->paramNames;
+    currentFunction = names.functionName(instr->func);
+    currentFunctionReturnsValue = instr->returnsValue;
+    currentFunctionParams.assign(instr->params.begin(), instr->params.end());
 
     // 重置栈相关状态
     //stackSize = 0;
@@ -598,11 +599,11 @@ void CodeGenerator::processFunctionBegin(const std::shared_ptr<FunctionBeginInst
     }
 
     // 生成函数标签
-    emitGlobal(instr->funcName);
-    emitLabel(instr->funcName);
+    emitGlobal(currentFunction);
+    emitLabel(currentFunction);
     
     // 生成函数序言
-    emitPrologue(instr->funcName);
+    emitPrologue(currentFunction);
 
     if (currentFunctionParams.empty()) {
         // 没有参数，跳过参数处理
@@ -616,7 +617,7 @@ void CodeGenerator::processFunctionBegin(const std::shared_ptr<FunctionBeginInst
     emitComment("函数形参压栈");
     for (size_t i = 0; i < currentFunctionParams.size(); i++) {
         // 创建参数变量
-        std::shared_ptr<Operand> paramVar = std::make_shared<Operand>(OperandType::VARIABLE, currentFunctionParams[i]);
+        Operand paramVar(OperandType::VARIABLE, currentFunctionParams[i]);
         
         // 获取参数变量的栈偏移
         int offset = getOperandOffset(paramVar);
@@ -642,7 +643,7 @@ void CodeGenerator::processFunctionBegin(const std::shared_ptr<FunctionBeginInst
 
 // 处理函数结束指令
 // 生成函数结束标签和后记
-void CodeGenerator::processFunctionEnd(const std::shared_ptr<FunctionEndInstr>& instr) {
+void CodeGenerator::processFunctionEnd(const FunctionEndInstr* instr) {
     // 函数结束标签
     emitLabel(currentFunction + "_epilogue");
     
@@ -654,7 +655,7 @@ void CodeGenerator::processFunctionEnd(const std::shared_ptr<FunctionEndInstr>&
 
     // 清除函数上下文
     currentFunction = "";
-    currentFunctionReturnType = "";
+    currentFunctionReturnsValue = false;
     currentFunctionParams.clear();
     regAlloc.clear();                   // 清除寄存器绑定
     localVars.clear();                  // 清除局部变量偏移
@@ -758,16 +759,16 @@ void CodeGenerator::emitEpilogue(const std::string& funcName) {
     emitInstruction("ret");
 }
 
-void CodeGenerator::loadOperand(const std::shared_ptr<Operand>& op, const std::string& reg) {
-    switch (op->type) {
+void CodeGenerator::loadOperand(const Operand& op, const std::string& reg) {
+    switch (op.type) {
         case OperandType::CONSTANT:
-            emitInstruction("li " + reg + ", " + std::to_string(op->value));
+            emitInstruction("li " + reg + ", " + std::to_string(op.value));
             break;
             
         case OperandType::VARIABLE:
         case OperandType::TEMP:
             {
-                auto it = regAlloc.find(op->name);
+                auto it = regAlloc.find(op.id);
                 if (it != regAlloc.end() && isValidRegister(it->second)) {
                     emitInstruction("addi " + reg + ", " + it->second + ", 0");
                 } else {
@@ -796,9 +797,9 @@ void CodeGenerator::loadOperand(const std::shared_ptr<Operand>& op, const std::s
     }
 }
 
-void CodeGenerator::storeRegister(const std::string& reg, const std::shared_ptr<Operand>& op) {
-    if (op->type == OperandType::VARIABLE || op->type == OperandType::TEMP) {
-        auto it = regAlloc.find(op->name);
+void CodeGenerator::storeRegister(const std::string& reg, const Operand& op) {
+    if (op.type == OperandType::VARIABLE || op.type == OperandType::TEMP) {
+        auto it = regAlloc.find(op.id);
         if (it != regAlloc.end() && isValidRegister(it->second)) {
             if (reg != it->second) {
                 emitInstruction("addi " + it->second + ", " + reg + ", 0");
@@ -823,30 +824,30 @@ void CodeGenerator::storeRegister(const std::string& reg, const std::shared_ptr<
 
 // 获取操作数的栈偏移
 // 如果操作数尚未分配栈空间，则分配新的栈空间
-int CodeGenerator::getOperandOffset(const std::shared_ptr<Operand>& op) {
-    // 添加空指针检查
-    if (!op) {
+int CodeGenerator::getOperandOffset(const Operand& op) {
+    // 添加空操作数检查
+    if (op.isNone()) {
         std::cerr << "错误: 空操作数" << std::endl;
         return 0;
     }
 
-    if (op->type != OperandType::VARIABLE && op->type != OperandType::TEMP) {
+    if (op.type != OperandType::VARIABLE && op.type != OperandType::TEMP) {
         std::cerr << "错误: 只有变量和临时变量有栈偏移" << std::endl;
         return 0;
     }
     
-    auto it = localVars.find(op->name);
+    auto it = localVars.find(op.id);
     if (it != localVars.end()) {
         return it->second;
     }
     
     // 检查是否是函数参数
     for (size_t i = 0; i < currentFunctionParams.size(); i++) {
-        if (currentFunctionParams[i] == op->name) {
+        if (currentFunctionParams[i] == op.id) {
             // 参数偏移量 = 寄存器保存区大小 + 参数索引 * 4
             int offset = currentStackOffset;
             currentStackOffset -= 4;
-            localVars[op->name] = offset;
+            localVars[op.id] = offset;
             return offset;
         }
     }
@@ -855,7 +856,7 @@ int CodeGenerator::getOperandOffset(const std::shared_ptr<Operand>& op) {
     //int offset = -getCalleeSavedRegsSize() - getLocalVarsSize() - 4;
     int offset = currentStackOffset;
     currentStackOffset -= 4;
-    localVars[op->name] = offset;
+    localVars[op.id] = offset;
     incrementLocalVarsSize(4);  // 更新局部变量区大小
     
     return offset;
@@ -1058,7 +1059,7 @@ int CodeGenerator::countUsedCalleeSavedRegs() {
     };
 
     for (const auto& instr : instructions) {
-        std::string s = instr->toString();
+        std::string s = instr->toString(names);
         for (const auto& reg : calleeSavedRegs) {
             if (s.find(reg) != std::string::npos) {
                 count++;
@@ -1098,7 +1099,7 @@ int CodeGenerator::countUsedCallerSavedRegs() {
     };
 
     for (const auto& instr : instructions) {
-        std::string s = instr->toString();
+        std::string s = instr->toString(names);
         for (const auto& reg : callerSavedRegs) {
             if (s.find(reg) != std::string::npos) {
                 count++;
@@ -1178,11 +1179,11 @@ void CodeGenerator::optimizeStackLayout() {
     emitComment("栈布局优化开始");
     
     // 分析变量的生命周期
-    std::map<std::string, std::pair<int, int>> varLifetimes;
+    std::map<OperandId, std::pair<int, int>> varLifetimes;
     analyzeVariableLifetimes(varLifetimes);
     
     // 按照生命周期结束时间排序变量
-    std::vector<std::pair<std::string, std::pair<int, int>>> sortedVars(
+    std::vector<std::pair<OperandId, std::pair<int, int>>> sortedVars(
         varLifetimes.begin(), varLifetimes.end());
     std::sort(sortedVars.begin(), sortedVars.end(), 
         [](const auto& a, const auto& b) {
@@ -1190,7 +1191,7 @@ void CodeGenerator::optimizeStackLayout() {
         });
     
     // 使用贪心算法重新分配栈空间
-    std::map<std::string, int> newOffsets;
+    std::map<OperandId, int> newOffsets;
     std::vector<std::pair<int, int>> allocatedRegions; // 已分配的栈区域 <offset, end_time>
     
     for (const auto& [var, lifetime] : sortedVars) {
@@ -1226,29 +1227,25 @@ void CodeGenerator::optimizeStackLayout() {
 
 //遍历指令序列，记录临时变量的生命周期和冲突关系
 int CodeGenerator::analyzeTempVars() {
-    std::set<std::string> activeTemps;  // 当前活跃的临时变量
+    std::set<OperandId> activeTemps;  // 当前活跃的临时变量
     int maxTempSize = 0;
     
     for (const auto& instr : instructions) {
-        // 步骤1: 分析指令的def/use（定义和使用）
-        auto defRegs = instr -> getDefRegisters();  // 指令定义的寄存器
-        auto useRegs = instr -> getUseRegisters(); // 指令使用的寄存器
-        
-        // 步骤2: 释放已失效的临时变量
-        for (const auto& reg : defRegs) {
-            if (isTempReg(reg)) {
-                activeTemps.erase(reg);  // 定义新值时旧值失效
+        // 步骤1: 释放已失效的临时变量（指令定义的寄存器）
+        if (const Operand* def = defOperand(instr)) {
+            if (isTempReg(def->id)) {
+                activeTemps.erase(def->id);  // 定义新值时旧值失效
             }
         }
         
-        // 步骤3: 记录需要栈存储的临时变量
-        for (const auto& reg : useRegs) {
-            if (isTempReg(reg) && !isRegisterAllocated(reg)) {
-                activeTemps.insert(reg);  // 需要栈存储的临时变量
+        // 步骤2: 记录需要栈存储的临时变量（指令使用的寄存器）
+        forEachUseOperand(instr, [&](const Operand& use) {
+            if (isTempReg(use.id) && !isRegisterAllocated(use.id)) {
+                activeTemps.insert(use.id);  // 需要栈存储的临时变量
             }
-        }
+        });
         
-        // 步骤4: 更新峰值空间需求
+        // 步骤3: 更新峰值空间需求
         maxTempSize = std::max(maxTempSize, (int)activeTemps.size() * 4);
     }
     
@@ -1256,14 +1253,14 @@ int CodeGenerator::analyzeTempVars() {
 }
 
 // 分析变量的生命周期
-void CodeGenerator::analyzeVariableLifetimes(std::map<std::string, std::pair<int, int>>& varLifetimes) {
+void CodeGenerator::analyzeVariableLifetimes(std::map<OperandId, std::pair<int, int>>& varLifetimes) {
     // 遍历所有指令，收集变量的定义和使用位置
     for (int i = 0; i < instructions.size(); i++) {
         auto instr = instructions[i];
         
         // 获取指令定义的变量
-        auto defined = IRAnalyzer::getDefinedVariables(instr);
-        for (const auto& var : defined) {
+        if (const Operand* def = defOperand(instr)) {
+            OperandId var = def->id;
             if (varLifetimes.find(var) == varLifetimes.end()) {
                 varLifetimes[var] = {i, i};
             } else {
@@ -1273,28 +1270,28 @@ void CodeGenerator::analyzeVariableLifetimes(std::map<std::string, std::pair<int
         }
         
         // 获取指令使用的变量
-        auto used = IRAnalyzer::getUsedVariables(instr);
-        for (const auto& var : used) {
+        forEachUseOperand(instr, [&](const Operand& use) {
+            OperandId var = use.id;
             if (varLifetimes.find(var) == varLifetimes.end()) {
                 varLifetimes[var] = {i, i};
             }
             // 更新使用位置（取最大值）
             varLifetimes[var].second = std::max(varLifetimes[var].second, i);
-        }
+        });
     }
 }
 
 // 构建变量冲突图
-std::map<std::string, std::set<std::string>> CodeGenerator::buildInterferenceGraph() {
-    std::map<std::string, std::set<std::string>> interferenceGraph;
+std::map<OperandId, std::set<OperandId>> CodeGenerator::buildInterferenceGraph() {
+    std::map<OperandId, std::set<OperandId>> interferenceGraph;
     
     // 分析变量的生命周期
-    std::map<std::string, std::pair<int, int>> varLifetimes;
+    std::map<OperandId, std::pair<int, int>> varLifetimes;
     analyzeVariableLifetimes(varLifetimes);
     
     // 初始化图
     for (const auto& [var, _] : varLifetimes) {
-        interferenceGraph[var] = std::set<std::string>();
+        interferenceGraph[var] = std::set<OperandId>();
     }
     
     // 构建冲突图：如果两个变量的生命周期重叠，则它们之间有冲突
@@ -1464,25 +1461,23 @@ void CodeGenerator::peepholeOptimize(std::vector<std::string>& instructions) {
 
 
 // 简单寄存器分配器实现
-std::map<std::string, std::string> NaiveRegisterAllocator::allocate(
-    const std::vector<std::shared_ptr<IRInstr>>& instructions,
+std::map<OperandId, std::string> NaiveRegisterAllocator::allocate(
+    const std::vector<IRInstr*>& instructions,
     const std::vector<Register>& availableRegs) {
-    std::map<std::string, std::string> allocation;
+    std::map<OperandId, std::string> allocation;
     
     // 收集所有变量
-    std::set<std::string> variables;
+    std::set<OperandId> variables;
     for (const auto& instr : instructions) {
         // 获取指令定义的变量
-        auto defined = IRAnalyzer::getDefinedVariables(instr);
-        for (const auto& var : defined) {
-            variables.insert(var);
+        if (const Operand* def = defOperand(instr)) {
+            variables.insert(def->id);
         }
         
         // 获取指令使用的变量
-        auto used = IRAnalyzer::getUsedVariables(instr);
-        for (const auto& var : used) {
-            variables.insert(var);
-        }
+        forEachUseOperand(instr, [&](const Operand& use) {
+            variables.insert(use.id);
+        });
     }
     
     // 筛选可分配的寄存器
@@ -1520,11 +1515,11 @@ std::map<std::string, std::string> NaiveRegisterAllocator::allocate(
 }
 
 // 线性扫描寄存器分配器实现
-std::map<std::string, std::string> LinearScanRegisterAllocator::allocate(
-    const std::vector<std::shared_ptr<IRInstr>>& instructions,
+std::map<OperandId, std::string> LinearScanRegisterAllocator::allocate(
+    const std::vector<IRInstr*>& instructions,
     const std::vector<Register>& availableRegs) {
     
-    std::map<std::string, std::string> allocation;
+    std::map<OperandId, std::string> allocation;
     
     // 计算变量的生命周期
     std::vector<LiveInterval> intervals = computeLiveIntervals(instructions);
@@ -1543,12 +1538,12 @@ std::map<std::string, std::string> LinearScanRegisterAllocator::allocate(
     }
     
     // 当前活跃的区间及其分配的寄存器
-    std::map<std::string, std::pair<LiveInterval, std::string>> active;
+    std::map<OperandId, std::pair<LiveInterval, std::string>> active;
     
     // 线性扫描算法
     for (const auto& interval : intervals) {
         // 过期活跃区间
-        std::vector<std::string> expired;
+        std::vector<OperandId> expired;
         for (auto& [var, pair] : active) {
             if (pair.first.end < interval.start) {
                 freeRegs.push_back(pair.second); // 释放寄存器
@@ -1564,7 +1559,7 @@ std::map<std::string, std::string> LinearScanRegisterAllocator::allocate(
         // 如果没有可用寄存器，需要溢出
         if (freeRegs.empty()) {
             // 找到最晚结束的活跃区间
-            std::string victimVar;
+            OperandId victimVar = kNoOperand;
             int latestEnd = -1;
             
             for (const auto& [var, pair] : active) {
@@ -1575,7 +1570,7 @@ std::map<std::string, std::string> LinearScanRegisterAllocator::allocate(
             }
             
             // 如果当前区间比受害者结束更早，则溢出受害者
-            if (latestEnd > interval.end && !victimVar.empty()) {
+            if (latestEnd > interval.end && victimVar != kNoOperand) {
                 allocation[interval.var] = active[victimVar].second;
                 freeRegs.push_back(active[victimVar].second);
                 active.erase(victimVar);
@@ -1599,17 +1594,17 @@ std::map<std::string, std::string> LinearScanRegisterAllocator::allocate(
 
 // 计算变量的生命周期区间
 std::vector<LinearScanRegisterAllocator::LiveInterval> LinearScanRegisterAllocator::computeLiveIntervals(
-    const std::vector<std::shared_ptr<IRInstr>>& instructions) {
+    const std::vector<IRInstr*>& instructions) {
     
-    std::map<std::string, LiveInterval> intervalMap;
+    std::map<OperandId, LiveInterval> intervalMap;
     
     // 扫描所有指令，计算变量的定义和使用位置
     for (int i = 0; i < instructions.size(); i++) {
         auto instr = instructions[i];
         
         // 获取指令定义的变量
-        auto defined = IRAnalyzer::getDefinedVariables(instr);
-        for (const auto& var : defined) {
+        if (const Operand* def = defOperand(instr)) {
+            OperandId var = def->id;
             // 如果变量尚未有区间，创建一个新区间
             if (intervalMap.find(var) == intervalMap.end()) {
                 intervalMap[var] = {var, i, i};
@@ -1621,15 +1616,15 @@ std::vector<LinearScanRegisterAllocator::LiveInterval> LinearScanRegisterAllocat
         }
         
         // 获取指令使用的变量
-        auto used = IRAnalyzer::getUsedVariables(instr);
-        for (const auto& var : used) {
+        forEachUseOperand(instr, [&](const Operand& use) {
+            OperandId var = use.id;
             // 如果变量尚未有区间，创建一个新区间
             if (intervalMap.find(var) == intervalMap.end()) {
                 intervalMap[var] = {var, i, i};
             }
             // 更新结束位置（取最大值）
             intervalMap[var].end = std::max(intervalMap[var].end, i);
-        }
+        });
     }
     
     // 转换为向量形式
@@ -1642,11 +1637,11 @@ std::vector<LinearScanRegisterAllocator::LiveInterval> LinearScanRegisterAllocat
 }
 
 // 图着色寄存器分配器实现
-std::map<std::string, std::string> GraphColoringRegisterAllocator::allocate(
-    const std::vector<std::shared_ptr<IRInstr>>& instructions,
+std::map<OperandId, std::string> GraphColoringRegisterAllocator::allocate(
+    const std::vector<IRInstr*>& instructions,
     const std::vector<Register>& availableRegs) {
     
-    std::map<std::string, std::string> allocation;
+    std::map<OperandId, std::string> allocation;
     
     // 构建冲突图
     auto interferenceGraph = buildInterferenceGraph(instructions);
@@ -1666,21 +1661,21 @@ std::map<std::string, std::string> GraphColoringRegisterAllocator::allocate(
 }
 
 // 构建变量冲突图
-std::map<std::string, std::set<std::string>> GraphColoringRegisterAllocator::buildInterferenceGraph(
-    const std::vector<std::shared_ptr<IRInstr>>& instructions) {
+std::map<OperandId, std::set<OperandId>> GraphColoringRegisterAllocator::buildInterferenceGraph(
+    const std::vector<IRInstr*>& instructions) {
     
-    std::map<std::string, std::set<std::string>> graph;
+    std::map<OperandId, std::set<OperandId>> graph;
     
     // 分析变量的生命周期
-    std::map<std::string, std::pair<int, int>> varLifetimes;
+    std::map<OperandId, std::pair<int, int>> varLifetimes;
     
     // 收集所有变量及其生命周期
     for (int i = 0; i < instructions.size(); i++) {
         auto instr = instructions[i];
         
         // 获取指令定义的变量
-        auto defined = IRAnalyzer::getDefinedVariables(instr);
-        for (const auto& var : defined) {
+        if (const Operand* def = defOperand(instr)) {
+            OperandId var = def->id;
             if (varLifetimes.find(var) == varLifetimes.end()) {
                 varLifetimes[var] = {i, i};
             } else {
@@ -1690,19 +1685,19 @@ std::map<std::string, std::set<std::string>> GraphColoringRegisterAllocator::bui
         }
         
         // 获取指令使用的变量
-        auto used = IRAnalyzer::getUsedVariables(instr);
-        for (const auto& var : used) {
+        forEachUseOperand(instr, [&](const Operand& use) {
+            OperandId var = use.id;
             if (varLifetimes.find(var) == varLifetimes.end()) {
                 varLifetimes[var] = {i, i};
             }
             // 更新使用位置（取最大值）
             varLifetimes[var].second = std::max(varLifetimes[var].second, i);
-        }
+        });
     }
     
     // 初始化图
     for (const auto& [var, _] : varLifetimes) {
-        graph[var] = std::set<std::string>();
+        graph[var] = std::set<OperandId>();
     }
     
     // 构建冲突图：如果两个变量的生命周期重叠，则它们之间有冲突
@@ -1727,10 +1722,10 @@ std::map<std::string, std::set<std::string>> GraphColoringRegisterAllocator::bui
 }
 
 // 简化冲突图
-std::vector<std::string> GraphColoringRegisterAllocator::simplify(
-    std::map<std::string, std::set<std::string>>& graph) {
+std::vector<OperandId> GraphColoringRegisterAllocator::simplify(
+    std::map<OperandId, std::set<OperandId>>& graph) {
     
-    std::vector<std::string> simplifiedOrder;
+    std::vector<OperandId> simplifiedOrder;
     
     // 创建图的副本，因为我们会修改它
     auto workGraph = graph;
@@ -1738,7 +1733,7 @@ std::vector<std::string> GraphColoringRegisterAllocator::simplify(
     // 当图不为空时，继续简化
     while (!workGraph.empty()) {
         // 查找度数小于可用寄存器数量的节点
-        std::string nodeToRemove;
+        OperandId nodeToRemove = kNoOperand;
         int minDegree = std::numeric_limits<int>::max();
         
         for (const auto& [node, neighbors] : workGraph) {
@@ -1750,7 +1745,7 @@ std::vector<std::string> GraphColoringRegisterAllocator::simplify(
         
         // 如果找不到合适的节点，我们需要选择一个"溢出"节点
         // 这里简单地选择度数最大的节点作为溢出候选
-        if (nodeToRemove.empty()) {
+        if (nodeToRemove == kNoOperand) {
             int maxDegree = -1;
             for (const auto& [node, neighbors] : workGraph) {
                 if (neighbors.size() > maxDegree) {
@@ -1776,12 +1771,12 @@ std::vector<std::string> GraphColoringRegisterAllocator::simplify(
 }
 
 // 图着色算法 - 为变量分配寄存器
-std::map<std::string, std::string> GraphColoringRegisterAllocator::color(
-    const std::vector<std::string>& simplifiedOrder,
-    const std::map<std::string, std::set<std::string>>& originalGraph,
+std::map<OperandId, std::string> GraphColoringRegisterAllocator::color(
+    const std::vector<OperandId>& simplifiedOrder,
+    const std::map<OperandId, std::set<OperandId>>& originalGraph,
     const std::vector<Register>& availableRegs) {
     
-    std::map<std::string, std::string> allocation;
+    std::map<OperandId, std::string> allocation;
     
     // 筛选可分配的寄存器
     std::vector<std::string> regNames;
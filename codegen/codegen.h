@@ -47,9 +47,9 @@ struct Register {
 class CodeGenerator {
 private:
     std::ostream& output;                      // 输出文件流
-    std::map<std::string, int> localVars;      // 局部变量到栈偏移的映射
-    std::map<std::string, std::string> regAlloc; // 变量到寄存器的分配映射
-    std::set<std::string> activeVars;          // 当前活跃的变量集合
+    std::map<OperandId, int> localVars;        // 局部变量到栈偏移的映射
+    std::map<OperandId, std::string> regAlloc; // 变量到寄存器的分配映射
+    std::set<OperandId> activeVars;            // 当前活跃的变量集合
     int labelCount = 0;                        // 标签计数器
     int frameSize = 0;                         // 当前函数帧大小
     int localVarsSize = 0;                     // 局部变量占用空间
@@ -67,14 +67,17 @@ private:
     bool isInLoop = false;                     // 是否在循环内
     std::vector<std::string> breakLabels;      // break语句跳转目标标签栈
     std::vector<std::string> continueLabels;   // continue语句跳转目标标签栈
-    std::vector<std::string> currentFunctionParams; // 当前函数的参数名列表
-    std::string currentFunctionReturnType;     // 当前函数的返回类型
+    std::vector<OperandId> currentFunctionParams; // 当前函数的参数编号列表
+    bool currentFunctionReturnsValue = false;  // 当前函数是否有返回值
 
     // 参数处理
-    std::vector<std::shared_ptr<Operand>> paramQueue; // 函数调用参数队列
+    std::vector<Operand> paramQueue;           // 函数调用参数队列
 
     // IR指令列表
-    const std::vector<std::shared_ptr<IRInstr>>& instructions;
+    const std::vector<IRInstr*>& instructions;
+
+    // IR操作数名字表（输出标签和注释时把编号还原为名字）
+    const IRNames& names;
     
     // 配置选项
     CodeGenConfig config;
@@ -98,9 +101,11 @@ public:
     // 参数:
     //   outputFile - 输出汇编文件路径
     //   instructions - IR指令序列
+    //   names - IR操作数名字表
     //   config - 代码生成配置
     CodeGenerator(std::ostream& outputStream,  
-                 const std::vector<std::shared_ptr<IRInstr>>& instructions,
+                 const std::vector<IRInstr*>& instructions,
+                 const IRNames& names,
                  const CodeGenConfig& config = CodeGenConfig());
     ~CodeGenerator();
     
@@ -112,7 +117,7 @@ public:
     // 参数:
     //   instr - IR指令
     //   stream - 输出流
-    void processInstructionToStream(const std::shared_ptr<IRInstr>& instr, std::ostream& stream);
+    void processInstructionToStream(const IRInstr* instr, std::ostream& stream);
 
     // 添加窥孔优化规则
     // 参数:
@@ -133,26 +138,26 @@ private:
     void emitSection(const std::string& section);    // 输出段声明
     
     // 处理IR指令
-    void processInstruction(const std::shared_ptr<IRInstr>& instr);
+    void processInstruction(const IRInstr* instr);
     
     // 处理各种IR指令类型
     // 处理各种IR指令类型
-    void processBinaryOp(const std::shared_ptr<BinaryOpInstr>& instr);    // 处理二元操作
-    void processUnaryOp(const std::shared_ptr<UnaryOpInstr>& instr);      // 处理一元操作
-    void processAssign(const std::shared_ptr<AssignInstr>& instr);        // 处理赋值
-    void processGoto(const std::shared_ptr<GotoInstr>& instr);            // 处理无条件跳转
-    void processIfGoto(const std::shared_ptr<IfGotoInstr>& instr);        // 处理条件跳转
-    void processParam(const std::shared_ptr<ParamInstr>& instr);          // 处理参数
-    void processCall(const std::shared_ptr<CallInstr>& instr);            // 处理函数调用
-    void processReturn(const std::shared_ptr<ReturnInstr>& instr);        // 处理返回
-    void processLabel(const std::shared_ptr<LabelInstr>& instr);          // 处理标签
-    void processFunctionBegin(const std::shared_ptr<FunctionBeginInstr>& instr); // 处理函数开始
-    void processFunctionEnd(const std::shared_ptr<FunctionEndInstr>& instr);     // 处理函数结束
+    void processBinaryOp(const BinaryOpInstr* instr);    // 处理二元操作
+    void processUnaryOp(const UnaryOpInstr* instr);      // 处理一元操作
+    void processAssign(const AssignInstr* instr);        // 处理赋值
+    void processGoto(const GotoInstr* instr);            // 处理无条件跳转
+    void processIfGoto(const IfGotoInstr* instr);        // 处理条件跳转
+    void processParam(const ParamInstr* instr);          // 处理参数
+    void processCall(const CallInstr* instr);            // 处理函数调用
+    void processReturn(const ReturnInstr* instr);        // 处理返回
+    void processLabel(const LabelInstr* instr);          // 处理标签
+    void processFunctionBegin(const FunctionBeginInstr* instr); // 处理函数开始
+    void processFunctionEnd(const FunctionEndInstr* instr);     // 处理函数结束
     
     // 操作数和寄存器处理
-    void loadOperand(const std::shared_ptr<Operand>& op, const std::string& reg); // 加载操作数到寄存器
-    void storeRegister(const std::string& reg, const std::shared_ptr<Operand>& op); // 存储寄存器值到操作数
-    int getOperandOffset(const std::shared_ptr<Operand>& op);  // 获取操作数在栈中的偏移
+    void loadOperand(const Operand& op, const std::string& reg);   // 加载操作数到寄存器
+    void storeRegister(const std::string& reg, const Operand& op); // 存储寄存器值到操作数
+    int getOperandOffset(const Operand& op);  // 获取操作数在栈中的偏移
     std::string allocTempReg();                                // 分配临时寄存器
     void freeTempReg(const std::string& reg);                  // 释放临时寄存器
     
@@ -204,22 +209,22 @@ private:
     
     // 分析方法
     // 分析变量生命周期，结果存储在varLifetimes中
-    void analyzeVariableLifetimes(std::map<std::string, std::pair<int, int>>& varLifetimes);
+    void analyzeVariableLifetimes(std::map<OperandId, std::pair<int, int>>& varLifetimes);
 
     int analyzeTempVars();      //遍历指令序列，记录临时变量的生命周期和冲突关系
 
     // 判断是否为临时寄存器（如虚拟寄存器或物理临时寄存器t0-t6）
-    bool isTempReg(const std::string& reg) {
-        return reg[0] == 't';
+    bool isTempReg(OperandId reg) {
+        return names.vregName(reg)[0] == 't';
         //return reg[0] == 't' || isVirtualReg(reg);  // 当前代码未使用虚拟寄存器
     }
     // 检查寄存器是否已分配到物理寄存器（无需栈空间）
-    bool isRegisterAllocated(const std::string& reg) {
+    bool isRegisterAllocated(OperandId reg) {
         return regAlloc.find(reg) != regAlloc.end();
     }
 
     // 构建变量冲突图
-    std::map<std::string, std::set<std::string>> buildInterferenceGraph();
+    std::map<OperandId, std::set<OperandId>> buildInterferenceGraph();
 };
 
 // 寄存器分配器基类
@@ -233,8 +238,8 @@ public:
     //   availableRegs - 可用寄存器列表
     // 返回:
     //   变量到寄存器的映射
-    virtual std::map<std::string, std::string> allocate(
-        const std::vector<std::shared_ptr<IRInstr>>& instructions,
+    virtual std::map<OperandId, std::string> allocate(
+        const std::vector<IRInstr*>& instructions,
         const std::vector<Register>& availableRegs) = 0;
 };
 
@@ -242,8 +247,8 @@ public:
 // 实现最基本的寄存器分配策略
 class NaiveRegisterAllocator : public RegisterAllocator {
 public:
-    std::map<std::string, std::string> allocate(
-        const std::vector<std::shared_ptr<IRInstr>>& instructions,
+    std::map<OperandId, std::string> allocate(
+        const std::vector<IRInstr*>& instructions,
         const std::vector<Register>& availableRegs) override;
 };
 
@@ -251,13 +256,13 @@ public:
 // 基于变量生命周期的线性扫描算法
 class LinearScanRegisterAllocator : public RegisterAllocator {
 public:
-    std::map<std::string, std::string> allocate(
-        const std::vector<std::shared_ptr<IRInstr>>& instructions,
+    std::map<OperandId, std::string> allocate(
+        const std::vector<IRInstr*>& instructions,
         const std::vector<Register>& availableRegs) override;
     
 private:
     struct LiveInterval {
-        std::string var;
+        OperandId var;
         int start;
         int end;
         
@@ -267,26 +272,26 @@ private:
     };
     
     std::vector<LiveInterval> computeLiveIntervals(
-        const std::vector<std::shared_ptr<IRInstr>>& instructions);
+        const std::vector<IRInstr*>& instructions);
 };
 
 // 图着色寄存器分配器
 // 基于变量冲突图的图着色算法
 class GraphColoringRegisterAllocator : public RegisterAllocator {
 public:
-    std::map<std::string, std::string> allocate(
-        const std::vector<std::shared_ptr<IRInstr>>& instructions,
+    std::map<OperandId, std::string> allocate(
+        const std::vector<IRInstr*>& instructions,
         const std::vector<Register>& availableRegs) override;
     
 private:
-    std::map<std::string, std::set<std::string>> buildInterferenceGraph(
-        const std::vector<std::shared_ptr<IRInstr>>& instructions);
+    std::map<OperandId, std::set<OperandId>> buildInterferenceGraph(
+        const std::vector<IRInstr*>& instructions);
     
-    std::vector<std::string> simplify(
-        std::map<std::string, std::set<std::string>>& graph);
+    std::vector<OperandId> simplify(
+        std::map<OperandId, std::set<OperandId>>& graph);
     
-    std::map<std::string, std::string> color(
-        const std::vector<std::string>& simplifiedOrder,
-        const std::map<std::string, std::set<std::string>>& originalGraph,
+    std::map<OperandId, std::string> color(
+        const std::vector<OperandId>& simplifiedOrder,
+        const std::map<OperandId, std::set<OperandId>>& originalGraph,
         const std::vector<Register>& availableRegs);
 };
@@ -0,0 +1,35 @@
+// common/arena.cpp - 块式内存池的块管理
+#include "common/arena.h"
+
+/*
+ * 当前块空间不足时申请新块
+ * 超过普通块大小的请求单独分配一块，避免浪费当前块剩余空间
+ * @param size 请求的字节数
+ * @param alignment 对齐要求
+ * @return 分配到的内存
+*/
+void* Arena::allocateSlow(size_t size, size_t alignment) {
+    size_t chunkSize = size + alignment > kChunkSize ? size + alignment : kChunkSize;
+    chunks.push_back(std::unique_ptr<char[]>(new char[chunkSize]));
+    char* chunk = chunks.back().get();
+
+    uintptr_t aligned = (reinterpret_cast<uintptr_t>(chunk) + alignment - 1) & ~(uintptr_t(alignment) - 1);
+    char* result = reinterpret_cast<char*>(aligned);
+
+    // 单独分配的大块不作为当前块，后续小对象继续使用原来的块
+    if (chunkSize == kChunkSize || cursor == nullptr) {
+        cursor = result + size;
+        limit = chunk + chunkSize;
+    }
+    return result;
+}
+
+// 接管另一个内存池的内存块，两个内存池中的对象此后由本内存池统一释放
+void Arena::adopt(Arena&& other) {
+    for (auto& chunk : other.chunks) {
+        chunks.push_back(std::move(chunk));
+    }
+    other.chunks.clear();
+    other.cursor = nullptr;
+    other.limit = nullptr;
+}
@@ -0,0 +1,102 @@
+// common/arena.h - 块式内存池：按块顺序分配，所有对象一次性释放（语法树和IR函数使用）
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// NodeList - 指向内存池中一段连续元素的轻量列表（子节点列表、参数列表等）
+template <typename T>
+class NodeList {
+private:
+    T* items = nullptr;
+    uint32_t count = 0;
+
+public:
+    NodeList() = default;
+    NodeList(T* items, uint32_t count) : items(items), count(count) {}
+
+    T* begin() const { return items; }
+    T* end() const { return items + count; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    T& operator[](size_t index) const { return items[index]; }
+};
+
+// Arena - 块式内存池
+// 对象从当前块中顺序切分，释放时只归还内存块，不逐个析构对象。
+// 因此放入内存池的类型必须可平凡析构（不持有 std::string、std::vector 等需要析构的成员）。
+class Arena {
+private:
+    static constexpr size_t kChunkSize = 64 * 1024; // 普通内存块大小
+
+    std::vector<std::unique_ptr<char[]>> chunks;    // 已分配的内存块
+    char* cursor = nullptr;                         // 当前块中下一个可用位置
+    char* limit = nullptr;                          // 当前块的末尾
+
+public:
+    Arena() = default;
+    Arena(Arena&& other) noexcept
+        : chunks(std::move(other.chunks)), cursor(other.cursor), limit(other.limit) {
+        other.chunks.clear();
+        other.cursor = nullptr;
+        other.limit = nullptr;
+    }
+    Arena& operator=(Arena&& other) noexcept {
+        if (this != &other) {
+            chunks = std::move(other.chunks);
+            cursor = other.cursor;
+            limit = other.limit;
+            other.chunks.clear();
+            other.cursor = nullptr;
+            other.limit = nullptr;
+        }
+        return *this;
+    }
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    // 在内存池中构造一个对象
+    template <typename T, typename... Args>
+    T* make(Args&&... args) {
+        static_assert(std::is_trivially_destructible<T>::value,
+                      "arena-allocated types must be trivially destructible");
+        void* memory = allocate(sizeof(T), alignof(T));
+        return new (memory) T(std::forward<Args>(args)...);
+    }
+
+    // 将临时收集的元素复制到内存池中，返回对应的列表
+    template <typename T>
+    NodeList<T> copyList(const std::vector<T>& values) {
+        static_assert(std::is_trivially_destructible<T>::value,
+                      "arena-allocated lists must hold trivially destructible elements");
+        if (values.empty()) {
+            return NodeList<T>();
+        }
+        T* items = static_cast<T*>(allocate(sizeof(T) * values.size(), alignof(T)));
+        for (size_t i = 0; i < values.size(); i++) {
+            new (items + i) T(values[i]);
+        }
+        return NodeList<T>(items, static_cast<uint32_t>(values.size()));
+    }
+
+    // 接管另一个内存池的全部内存块（合并分别构建的语法子树时使用）
+    void adopt(Arena&& other);
+
+private:
+    // 按对齐要求切分 size 字节，当前块不足时申请新块
+    void* allocate(size_t size, size_t alignment) {
+        uintptr_t current = reinterpret_cast<uintptr_t>(cursor);
+        uintptr_t aligned = (current + alignment - 1) & ~(uintptr_t(alignment) - 1);
+        if (cursor == nullptr || aligned + size > reinterpret_cast<uintptr_t>(limit)) {
+            return allocateSlow(size, alignment);
+        }
+        cursor = reinterpret_cast<char*>(aligned + size);
+        return reinterpret_cast<void*>(aligned);
+    }
+
+    void* allocateSlow(size_t size, size_t alignment);
+};
@@ -0,0 +1,93 @@
+// common/bitVector.h - 按机器字并行运算的定长位集合
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// BitVector - 数据流分析用的稠密集合，元素是 [0, size) 中的编号
+// 位按 64 位字存放，并、交、差和比较都逐字进行，不逐位循环。
+// 参与运算的两个集合大小必须相同；最后一个字中超出 size 的位始终为 0
+class BitVector {
+private:
+    static constexpr size_t kWordBits = 64;
+
+    std::vector<uint64_t> words;
+    size_t bitCount = 0;
+
+    static size_t wordCount(size_t bits) { return (bits + kWordBits - 1) / kWordBits; }
+
+    // 清掉最后一个字中超出 size 的位
+    void clearPadding() {
+        size_t tail = bitCount % kWordBits;
+        if (tail != 0) words.back() &= (uint64_t(1) << tail) - 1;
+    }
+
+public:
+    BitVector() = default;
+    explicit BitVector(size_t size, bool value = false)
+        : words(wordCount(size), value ? ~uint64_t(0) : 0), bitCount(size) {
+        clearPadding();
+    }
+
+    size_t size() const { return bitCount; }
+
+    bool test(size_t i) const { return (words[i / kWordBits] >> (i % kWordBits)) & 1; }
+    void set(size_t i) { words[i / kWordBits] |= uint64_t(1) << (i % kWordBits); }
+    void reset(size_t i) { words[i / kWordBits] &= ~(uint64_t(1) << (i % kWordBits)); }
+
+    // 全部置 1 / 置 0
+    void setAll() {
+        for (auto& w : words) w = ~uint64_t(0);
+        clearPadding();
+    }
+    void clear() {
+        for (auto& w : words) w = 0;
+    }
+
+    // *this |= other，返回集合是否变化
+    bool unionWith(const BitVector& other) {
+        uint64_t changed = 0;
+        for (size_t i = 0; i < words.size(); ++i) {
+            uint64_t merged = words[i] | other.words[i];
+            changed |= merged ^ words[i];
+            words[i] = merged;
+        }
+        return changed != 0;
+    }
+
+    // *this &= other，返回集合是否变化
+    bool intersectWith(const BitVector& other) {
+        uint64_t changed = 0;
+        for (size_t i = 0; i < words.size(); ++i) {
+            uint64_t merged = words[i] & other.words[i];
+            changed |= merged ^ words[i];
+            words[i] = merged;
+        }
+        return changed != 0;
+    }
+
+    // *this -= other
+    void subtract(const BitVector& other) {
+        for (size_t i = 0; i < words.size(); ++i) words[i] &= ~other.words[i];
+    }
+
+    bool any() const {
+        for (auto w : words) {
+            if (w) return true;
+        }
+        return false;
+    }
+
+    // 按编号从小到大对每个元素调用 f(size_t)
+    template <typename F>
+    void forEach(F&& f) const {
+        for (size_t i = 0; i < words.size(); ++i) {
+            for (uint64_t w = words[i]; w != 0; w &= w - 1) {
+                f(i * kWordBits + static_cast<size_t>(__builtin_ctzll(w)));
+            }
+        }
+    }
+
+    bool operator==(const BitVector& other) const { return words == other.words; }
+    bool operator!=(const BitVector& other) const { return words != other.words; }
+};
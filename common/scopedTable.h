@@ -0,0 +1,103 @@
+// common/scopedTable.h - 以标识符编号为键的扁平作用域符号表
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "common/stringInterner.h"
+
+// ScopedTable - 所有作用域共用一张表，按标识符编号直接索引到最内层的绑定
+// 每次声明在绑定序列末尾追加一项，并记下被它遮蔽的外层绑定；
+// 退出作用域时按序列倒序撤销本作用域的绑定、恢复被遮蔽的绑定。
+// 查找与作用域嵌套深度无关，进出作用域也不会创建或销毁哈希表
+template <typename Value>
+class ScopedTable {
+public:
+    // 一个绑定：标识符及其对应的值
+    struct Binding {
+        SymbolId name;
+        Value value;
+        uint32_t shadowed;  // 被遮蔽的外层绑定下标，没有时为 kNone
+    };
+
+    // 绑定序列中的一段，支持范围 for 遍历
+    struct Range {
+        const Binding* first;
+        const Binding* last;
+        const Binding* begin() const { return first; }
+        const Binding* end() const { return last; }
+    };
+
+private:
+    static constexpr uint32_t kNone = UINT32_MAX;
+
+    std::vector<Binding> bindings;      // 按声明顺序排列的绑定，兼作撤销日志
+    std::vector<uint32_t> innermost;    // 标识符编号 -> 最内层绑定的下标
+    std::vector<uint32_t> scopeStarts;  // 每个作用域第一个绑定的下标
+
+    uint32_t innermostIndex(SymbolId name) const {
+        return name < innermost.size() ? innermost[name] : kNone;
+    }
+
+public:
+    // 当前作用域嵌套层数，0 表示还没有进入任何作用域
+    size_t depth() const { return scopeStarts.size(); }
+
+    // 进入新作用域
+    void enterScope() { scopeStarts.push_back(static_cast<uint32_t>(bindings.size())); }
+
+    // 退出当前作用域，撤销其中的所有绑定
+    void exitScope() {
+        uint32_t start = scopeStarts.back();
+        scopeStarts.pop_back();
+        while (bindings.size() > start) {
+            const Binding& binding = bindings.back();
+            innermost[binding.name] = binding.shadowed;
+            bindings.pop_back();
+        }
+    }
+
+    /*
+     * 在当前作用域声明标识符
+     * @param name 标识符编号
+     * @param value 绑定的值
+     * @return 当前作用域中已有同名绑定时返回 false，原绑定保持不变
+    */
+    bool declare(SymbolId name, Value value) {
+        if (findInCurrentScope(name)) {
+            return false;
+        }
+        if (name >= innermost.size()) {
+            innermost.resize(name + 1, kNone);
+        }
+        bindings.push_back({name, std::move(value), innermost[name]});
+        innermost[name] = static_cast<uint32_t>(bindings.size() - 1);
+        return true;
+    }
+
+    // 查找最内层的可见绑定，不存在时返回空指针
+    // 返回的指针在下一次 declare 之前有效
+    Value* find(SymbolId name) {
+        uint32_t index = innermostIndex(name);
+        return index == kNone ? nullptr : &bindings[index].value;
+    }
+
+    // 只在当前作用域中查找
+    Value* findInCurrentScope(SymbolId name) {
+        uint32_t index = innermostIndex(name);
+        if (index == kNone || scopeStarts.empty() || index < scopeStarts.back()) {
+            return nullptr;
+        }
+        return &bindings[index].value;
+    }
+
+    // 当前作用域中的绑定（按声明顺序）
+    Range currentScope() const {
+        const Binding* data = bindings.data();
+        uint32_t start = scopeStarts.empty() ? 0 : scopeStarts.back();
+        return {data + start, data + bindings.size()};
+    }
+
+    // 所有尚未退出的作用域中的绑定，包括被遮蔽的（由外到内，按声明顺序）
+    Range all() const {
+        return {bindings.data(), bindings.data() + bindings.size()};
+    }
+};
@@ -0,0 +1,31 @@
+// stringInterner.cpp - 标识符驻留表的实现
+#include "common/stringInterner.h"
+
+/*
+ * 驻留一个标识符
+ * 首次出现时复制一份文本并分配新编号，之后同样的文本直接返回该编号
+ * @param text 标识符文本
+ * @return 标识符编号
+*/
+SymbolId StringInterner::intern(std::string_view text) {
+    auto it = ids.find(text);
+    if (it != ids.end()) {
+        return it->second;
+    }
+
+    SymbolId id = static_cast<SymbolId>(spellings.size());
+    std::string_view stored = storage.emplace_back(text);
+    spellings.push_back(stored);
+    ids.emplace(stored, id);
+    return id;
+}
+
+/*
+ * 查找标识符编号，不会插入新标识符
+ * @param text 标识符文本
+ * @return 标识符编号，不存在时返回 kNoSymbol
+*/
+SymbolId StringInterner::lookup(std::string_view text) const {
+    auto it = ids.find(text);
+    return it != ids.end() ? it->second : kNoSymbol;
+}
@@ -0,0 +1,35 @@
+// common/stringInterner.h - 全局标识符驻留表：同名标识符在整个编译过程中共享同一个整数编号
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+using SymbolId = uint32_t;                           // 标识符编号，按首次出现的顺序从 0 开始分配
+constexpr SymbolId kNoSymbol = UINT32_MAX;           // 表示"没有标识符"
+
+// StringInterner - 由词法分析器填充，后续各阶段只比较编号，需要文本时再查表
+class StringInterner {
+private:
+    std::deque<std::string> storage;                        // 标识符文本（deque 追加时不移动已有元素）
+    std::unordered_map<std::string_view, SymbolId> ids;     // 文本到编号的映射，键指向 storage 中的文本
+    std::deque<std::string_view> spellings;                 // 编号到文本的映射
+
+public:
+    StringInterner() = default;
+    StringInterner(const StringInterner&) = delete;
+    StringInterner& operator=(const StringInterner&) = delete;
+
+    // 驻留一个标识符，返回其编号（已存在时返回原编号）
+    SymbolId intern(std::string_view text);
+
+    // 查找标识符的编号，不存在时返回 kNoSymbol
+    SymbolId lookup(std::string_view text) const;
+
+    // 取编号对应的文本
+    std::string_view spelling(SymbolId id) const { return spellings[id]; }
+
+    // 已驻留的标识符个数
+    size_t size() const { return spellings.size(); }
+};
@@ -0,0 +1,94 @@
+// threadPool.cpp - 线程池的实现
+#include "common/threadPool.h"
+
+/*
+ * 创建线程池
+ * @param threadCount 参与计算的线程总数（含调用线程），0 表示使用硬件并发数
+*/
+ThreadPool::ThreadPool(unsigned threadCount) {
+    if (threadCount == 0) {
+        threadCount = std::thread::hardware_concurrency();
+    }
+    for (unsigned i = 1; i < threadCount; i++) {
+        workers.emplace_back([this] { workerLoop(); });
+    }
+}
+
+// 通知所有工作线程退出并等待其结束
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeup.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+/*
+ * 并行执行一批任务
+ * 调用线程也领取任务，任务数很少或没有工作线程时相当于顺序执行
+ * @param count 任务个数
+ * @param run 任务函数，参数为任务下标
+*/
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t)>& run) {
+    if (count == 0) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        task = &run;
+        taskCount = count;
+        nextIndex.store(0);
+        busyWorkers = workers.size();
+        firstError = nullptr;
+        generation++;
+    }
+    wakeup.notify_all();
+
+    runTasks();
+
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [this] { return busyWorkers == 0; });
+    task = nullptr;
+    if (firstError) {
+        std::rethrow_exception(firstError);
+    }
+}
+
+// 工作线程主循环：等待新批次，领取任务直到本批任务分完
+void ThreadPool::workerLoop() {
+    uint64_t seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wakeup.wait(lock, [this, seen] { return stopping || generation != seen; });
+            if (stopping) {
+                return;
+            }
+            seen = generation;
+        }
+
+        runTasks();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--busyWorkers == 0) {
+            finished.notify_one();
+        }
+    }
+}
+
+// 按下标领取并执行任务，记录第一个异常
+void ThreadPool::runTasks() {
+    for (size_t index = nextIndex.fetch_add(1); index < taskCount; index = nextIndex.fetch_add(1)) {
+        try {
+            (*task)(index);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!firstError) {
+                firstError = std::current_exception();
+            }
+        }
+    }
+}
@@ -0,0 +1,46 @@
+// common/threadPool.h - 固定大小的线程池，用于按函数并行处理的编译阶段
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// ThreadPool - 工作线程在构造时创建，析构时回收
+// 每次 parallelFor 把一批相互独立的任务分给所有线程（包括调用线程）执行，全部完成后才返回
+class ThreadPool {
+private:
+    std::vector<std::thread> workers;            // 工作线程（不含调用线程）
+    std::mutex mutex;
+    std::condition_variable wakeup;              // 通知工作线程有新一批任务
+    std::condition_variable finished;            // 通知调用线程本批任务已全部完成
+
+    const std::function<void(size_t)>* task = nullptr;  // 当前这批任务
+    size_t taskCount = 0;                        // 当前这批任务的个数
+    std::atomic<size_t> nextIndex{0};            // 下一个待领取的任务下标
+    size_t busyWorkers = 0;                      // 仍在处理本批任务的工作线程数
+    uint64_t generation = 0;                     // 批次编号，用于唤醒工作线程
+    bool stopping = false;                       // 析构时置位
+    std::exception_ptr firstError;               // 任务抛出的第一个异常
+
+public:
+    // threadCount 为参与计算的线程总数（含调用线程），0 表示使用硬件并发数
+    explicit ThreadPool(unsigned threadCount = 0);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // 参与计算的线程总数
+    unsigned size() const { return static_cast<unsigned>(workers.size()) + 1; }
+
+    // 并行执行 run(0) ... run(count - 1)，任务之间不能有依赖；任务抛出的异常在此重新抛出
+    void parallelFor(size_t count, const std::function<void(size_t)>& run);
+
+private:
+    void workerLoop();
+    void runTasks();
+};
@@ -0,0 +1,9 @@
+// common/wrapArith.h - 按 32 位补码回绕的整数运算
+#pragma once
+#include <cstdint>
+
+// 按 32 位补码回绕计算 +、-、*，与目标机器一致（避免有符号溢出的未定义行为）。
+// AST 上的常量折叠和 IR 上的常量求值都使用这里的定义，两者的结果始终相同
+inline int wrapAdd(int a, int b) { return static_cast<int>(static_cast<uint32_t>(a) + static_cast<uint32_t>(b)); }
+inline int wrapSub(int a, int b) { return static_cast<int>(static_cast<uint32_t>(a) - static_cast<uint32_t>(b)); }
+inline int wrapMul(int a, int b) { return static_cast<int>(static_cast<uint32_t>(a) * static_cast<uint32_t>(b)); }
@@ -0,0 +1,49 @@
+// dataflow.cpp - 基于通用求解器的常用数据流分析
+#include "dataflow.h"
+
+// 活跃变量分析的数据流问题：后向，变量集合为按变量编号索引的位向量
+struct LivenessProblem {
+    using Value = BitVector;
+    static constexpr DataflowDirection direction = DataflowDirection::Backward;
+
+    size_t varCount;
+    const std::vector<BitVector>& use;  // 块内先使用后定义的变量，按块 id 索引
+    const std::vector<BitVector>& def;  // 块内定义的变量，按块 id 索引
+
+    // 函数出口之后没有活跃变量
+    Value boundary() const { return BitVector(varCount); }
+
+    // live_out = 后继的 live_in 并集
+    void meet(Value& into, const Value& other) const { into.unionWith(other); }
+
+    // live_in = use ∪ (live_out - def)
+    void transfer(const BasicBlock& block, const Value& out, Value& in) const {
+        in = out;
+        in.subtract(def[block.id]);
+        in.unionWith(use[block.id]);
+    }
+};
+
+// 活跃变量分析
+DataflowResult<BitVector> computeLiveness(const IRFunction& func, size_t varCount) {
+    // 收集每个块的 use/def 集合
+    std::vector<BitVector> use(func.blocks.size(), BitVector(varCount));
+    std::vector<BitVector> def(func.blocks.size(), BitVector(varCount));
+    for (auto& block : func.blocks) {
+        for (auto& instr : block->instructions) {
+            // use：变量在被定义前被使用
+            forEachUseOperand(instr, [&](const Operand& u) {
+                if (!def[block->id].test(u.id)) {
+                    use[block->id].set(u.id);
+                }
+            });
+
+            // def：当前指令定义的变量
+            if (const Operand* d = defOperand(instr)) {
+                def[block->id].set(d->id);
+            }
+        }
+    }
+
+    return solveDataflow(func, LivenessProblem{varCount, use, def});
+}
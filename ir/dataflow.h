@@ -0,0 +1,116 @@
+// dataflow.h - 基本块粒度的通用数据流求解器
+#pragma once
+#include "ir/ir.h"
+#include "common/bitVector.h"
+#include <algorithm>
+#include <vector>
+
+// 数据流方向
+enum class DataflowDirection {
+    Forward,    // 沿控制流：块入口的值由前驱的出口值合并得到
+    Backward    // 逆控制流：块出口的值由后继的入口值合并得到
+};
+
+// 求解结果：按块 id 索引，in 为块入口处的值，out 为块出口处的值（与方向无关）
+template <typename Value>
+struct DataflowResult {
+    std::vector<Value> in;
+    std::vector<Value> out;
+};
+
+/*
+ * 用工作表迭代求数据流方程的不动点
+ * 前向问题按逆后序、后向问题按后序访问块，每一轮只重新计算输入可能变化的块，
+ * 无环的部分一轮即可收敛，有环时再多几轮。
+ * 尚未计算过的相邻块不参与合并，相当于取格的顶元（乐观初值），问题本身无需表示顶元；
+ * 没有已计算的相邻块的块（入口、出口、不可达块）以 boundary() 作为输入
+ *
+ * Problem 需要提供：
+ *   using Value;                                        格值，须支持 == 比较
+ *   static constexpr DataflowDirection direction;
+ *   Value boundary() const;                             入口块的入口值（前向）或出口块的出口值（后向）
+ *   void meet(Value& into, const Value& other) const;   into = into ∧ other
+ *   void transfer(const BasicBlock& block, const Value& input, Value& output) const;
+ *                                                       由块的输入端值计算另一端的值
+ * @param func 要分析的函数
+ * @param problem 数据流问题
+ * @return 每个块入口和出口处的值
+*/
+template <typename Problem>
+DataflowResult<typename Problem::Value> solveDataflow(const IRFunction& func, const Problem& problem) {
+    using Value = typename Problem::Value;
+    constexpr bool forward = Problem::direction == DataflowDirection::Forward;
+
+    const size_t n = func.blocks.size();
+    DataflowResult<Value> result;
+    result.in.assign(n, problem.boundary());
+    result.out.assign(n, problem.boundary());
+    if (n == 0) return result;
+
+    // 访问顺序：可达块按逆后序（后向问题倒过来即后序），不可达块按输出顺序排在最后
+    std::vector<BasicBlock*> order = func.reversePostOrder();
+    std::vector<char> reachable(n, 0);
+    for (auto* block : order) reachable[block->id] = 1;
+    for (auto& block : func.blocks) {
+        if (!reachable[block->id]) order.push_back(block.get());
+    }
+    if (!forward) std::reverse(order.begin(), order.end());
+
+    // 前向问题的输入端是 in、输出端是 out，后向问题相反
+    std::vector<Value>& inputs = forward ? result.in : result.out;
+    std::vector<Value>& outputs = forward ? result.out : result.in;
+
+    std::vector<char> pending(n, 1);    // 输入可能已变化、需要重新计算的块
+    size_t pendingCount = n;
+    std::vector<char> computed(n, 0);   // 输出端已经算过的块
+    Value next = problem.boundary();    // 复用的临时值，减少分配
+
+    while (pendingCount > 0) {
+        for (BasicBlock* block : order) {
+            const BlockID id = block->id;
+            if (!pending[id]) continue;
+            pending[id] = 0;
+            --pendingCount;
+
+            // 合并已计算的相邻块输出端的值；前向问题的入口块还要并入边界值
+            Value& input = inputs[id];
+            bool first = true;
+            if (forward && block == func.entry()) {
+                input = problem.boundary();
+                first = false;
+            }
+            for (BasicBlock* neighbor : forward ? block->predecessors : block->successors) {
+                if (!computed[neighbor->id]) continue;
+                if (first) {
+                    input = outputs[neighbor->id];
+                    first = false;
+                } else {
+                    problem.meet(input, outputs[neighbor->id]);
+                }
+            }
+            if (first) input = problem.boundary();
+
+            problem.transfer(*block, input, next);
+            if (computed[id] && next == outputs[id]) continue;
+
+            std::swap(outputs[id], next);
+            computed[id] = 1;
+            for (BasicBlock* neighbor : forward ? block->successors : block->predecessors) {
+                if (!pending[neighbor->id]) {
+                    pending[neighbor->id] = 1;
+                    ++pendingCount;
+                }
+            }
+        }
+    }
+    return result;
+}
+
+/*
+ * 活跃变量分析（后向，集合为按变量编号索引的位向量）
+ * 只用于不含 φ 指令的函数：φ 的入口值在前驱块末尾使用，不能按块内的普通使用处理
+ * @param func 要分析的函数
+ * @param varCount 虚拟寄存器编号的数量（IRNames::vregCount）
+ * @return 每个块入口（live_in）和出口（live_out）处活跃的变量
+*/
+DataflowResult<BitVector> computeLiveness(const IRFunction& func, size_t varCount);
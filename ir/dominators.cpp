@@ -0,0 +1,91 @@
+// dominators.cpp - 实现支配树的构建和支配边界的计算
+#include "dominators.h"
+
+// 在逆后序上迭代求直接支配者，再建立支配树
+DominatorTree::DominatorTree(const IRFunction& func)
+    : idoms(func.blocks.size(), nullptr), kids(func.blocks.size()),
+      enter(func.blocks.size(), -1), leave(func.blocks.size(), -1) {
+    std::vector<BasicBlock*> rpo = func.reversePostOrder();
+    if (rpo.empty()) return;
+
+    // 块在逆后序中的位置；不可达块为 -1
+    std::vector<int> rpoIndex(func.blocks.size(), -1);
+    for (size_t i = 0; i < rpo.size(); ++i) rpoIndex[rpo[i]->id] = static_cast<int>(i);
+
+    // 沿已知的直接支配者向上走，求两个块在支配树中的最近公共祖先
+    auto intersect = [&](BasicBlock* a, BasicBlock* b) {
+        while (a != b) {
+            while (rpoIndex[a->id] > rpoIndex[b->id]) a = idoms[a->id];
+            while (rpoIndex[b->id] > rpoIndex[a->id]) b = idoms[b->id];
+        }
+        return a;
+    };
+
+    BasicBlock* entry = rpo.front();
+    idoms[entry->id] = entry;   // 迭代期间入口指向自己，作为向上走的终点
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (size_t i = 1; i < rpo.size(); ++i) {
+            BasicBlock* block = rpo[i];
+            BasicBlock* newIdom = nullptr;
+            for (BasicBlock* pred : block->predecessors) {
+                if (!idoms[pred->id]) continue;     // 还没处理到的前驱或不可达前驱
+                newIdom = newIdom ? intersect(pred, newIdom) : pred;
+            }
+            if (newIdom != idoms[block->id]) {
+                idoms[block->id] = newIdom;
+                changed = true;
+            }
+        }
+    }
+    idoms[entry->id] = nullptr;
+
+    // 按逆后序挂子结点，使子结点的顺序稳定
+    for (size_t i = 1; i < rpo.size(); ++i) {
+        kids[idoms[rpo[i]->id]->id].push_back(rpo[i]);
+    }
+
+    // 用显式栈做前序遍历，记录进入/离开时间戳
+    int clock = 0;
+    std::vector<std::pair<BasicBlock*, size_t>> stack;
+    stack.emplace_back(entry, 0);
+    enter[entry->id] = clock++;
+    order.push_back(entry);
+    while (!stack.empty()) {
+        auto& [block, next] = stack.back();
+        if (next < kids[block->id].size()) {
+            BasicBlock* child = kids[block->id][next++];
+            enter[child->id] = clock++;
+            order.push_back(child);
+            stack.emplace_back(child, 0);
+        } else {
+            leave[block->id] = clock++;
+            stack.pop_back();
+        }
+    }
+}
+
+// a 支配 b 当且仅当 b 在支配树中 a 的子树内
+bool DominatorTree::dominates(const BasicBlock* a, const BasicBlock* b) const {
+    if (!isReachable(a) || !isReachable(b)) return false;
+    return enter[a->id] <= enter[b->id] && leave[b->id] <= leave[a->id];
+}
+
+// 支配边界：对每个汇合点，从各个前驱沿支配树向上走到它的直接支配者为止，
+// 途经的块的支配边界都包含该汇合点
+std::vector<std::vector<BasicBlock*>> DominatorTree::frontiers() const {
+    std::vector<std::vector<BasicBlock*>> result(idoms.size());
+    for (BasicBlock* block : order) {
+        if (block->predecessors.size() < 2) continue;
+        for (BasicBlock* pred : block->predecessors) {
+            if (!isReachable(pred)) continue;
+            for (BasicBlock* runner = pred; runner != idoms[block->id]; runner = idoms[runner->id]) {
+                auto& frontier = result[runner->id];
+                if (!frontier.empty() && frontier.back() == block) break;   // 这条路径已经登记过
+                frontier.push_back(block);
+            }
+        }
+    }
+    return result;
+}
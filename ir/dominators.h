@@ -0,0 +1,35 @@
+// dominators.h - 基本块的支配树与支配边界
+#pragma once
+#include "ir/ir.h"
+#include <vector>
+
+// DominatorTree - 函数中从入口可达部分的支配树
+// 按 Cooper-Harvey-Kennedy 的迭代算法在逆后序上求直接支配者。
+// 结果按块 id 索引，块被插入、删除或重新编号之后需要重新构建；不可达块不在树中
+class DominatorTree {
+private:
+    std::vector<BasicBlock*> idoms;                 // 直接支配者，入口块和不可达块为空指针
+    std::vector<std::vector<BasicBlock*>> kids;     // 支配树中的子结点
+    std::vector<BasicBlock*> order;                 // 支配树的前序
+    std::vector<int> enter, leave;                  // 前序遍历中进入/离开结点的时间戳，用于 O(1) 支配查询
+
+public:
+    explicit DominatorTree(const IRFunction& func);
+
+    // 直接支配者，入口块和不可达块返回空指针
+    BasicBlock* idom(const BasicBlock* block) const { return idoms[block->id]; }
+
+    // 支配树中直接被 block 支配的块
+    const std::vector<BasicBlock*>& children(const BasicBlock* block) const { return kids[block->id]; }
+
+    // 支配树的前序：每个块排在它支配的所有块之前，只包含可达块
+    const std::vector<BasicBlock*>& preorder() const { return order; }
+
+    bool isReachable(const BasicBlock* block) const { return enter[block->id] >= 0; }
+
+    // a 是否支配 b（块支配自身）；任一块不可达时为假
+    bool dominates(const BasicBlock* a, const BasicBlock* b) const;
+
+    // 每个可达块的支配边界，按块 id 索引
+    std::vector<std::vector<BasicBlock*>> frontiers() const;
+};
@@ -0,0 +1,239 @@
+// gvn.cpp - SSA 形式上基于支配树的全局值编号
+#include "irgen.h"
+#include "dominators.h"
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+
+/**
+ * 全局值编号（Global Value Numbering，沿支配树进行）
+ *
+ * 每个值有一个整数编号：每个常量、每个形参和未赋值就读取的变量、每个不能化简的计算各得到一个编号。
+ * 计算按（操作码，操作数的编号）查表，交换律运算的操作数按编号排序，a > b 与 b < a、a >= b 与 b <= a 共用一个键；
+ * 表按支配树分作用域，只有支配当前块的块中的计算可见，找到的等价计算总是先执行、结果总是可用。
+ * 操作数都是常量的计算直接折叠，复制的结果与源同一编号。
+ * 每个编号的代表是最先得到它的变量或常量，冗余的定义被删除，它的使用改为代表。
+ * 每条指令只查一次散列表，整个函数的代价接近线性。
+ */
+
+using ValueId = uint32_t;
+static constexpr ValueId kNoValue = UINT32_MAX;
+
+// 两个操作数是否表示同一个值（同一变量或相等的常量）
+static bool sameOperand(const Operand& a, const Operand& b) {
+    if (a.type == OperandType::CONSTANT || b.type == OperandType::CONSTANT) {
+        return a.type == b.type && a.value == b.value;
+    }
+    return a.id == b.id;
+}
+
+/**
+ * 在 SSA 形式的函数上做全局值编号，删除冗余的计算、复制和 φ
+ * 算法步骤：
+ * 1. 沿支配树前序访问块，离开结点时撤销它加入表中的计算
+ * 2. φ：除自身外的入口值都相同时等于该值；与块中之前的 φ 的入口值逐一相同时等于那个 φ
+ * 3. 其余指令先把使用改为编号的代表，再求结果的编号：复制取源的编号，常量运算折叠，
+ *    其余计算查表；编号的代表不是结果本身时删除这条指令
+ * 4. 块访问完后把后继中 φ 来自该块的入口值改为代表
+ */
+void IRGenerator::globalValueNumbering(IRFunction& func) {
+    if (func.blocks.empty()) return;
+    const size_t varCount = names.vregCount();
+
+    // 没有定义的变量（形参、未赋值就读取的变量）在第一次读到时以自身为代表
+    std::vector<char> defined(varCount, 0);
+    for (auto& block : func.blocks) {
+        for (auto instr : block->instructions) {
+            if (const Operand* def = defOperand(instr)) defined[def->id] = 1;
+        }
+    }
+
+    std::vector<Operand> leaders;                           // 值编号 -> 代表
+    std::vector<ValueId> varValue(varCount, kNoValue);      // 变量 -> 值编号
+    std::unordered_map<int, ValueId> constValue;            // 常量 -> 值编号
+    std::unordered_map<Expression, ValueId, ExpressionHash> table;
+    std::vector<Expression> scopeLog;                       // 按加入顺序记录表中的键，离开支配树结点时据此撤销
+
+    auto newValue = [&](const Operand& leader) {
+        leaders.push_back(leader);
+        return static_cast<ValueId>(leaders.size() - 1);
+    };
+    auto valueOf = [&](const Operand& op) {
+        if (op.type == OperandType::CONSTANT) {
+            auto [it, inserted] = constValue.emplace(op.value, static_cast<ValueId>(leaders.size()));
+            if (inserted) leaders.push_back(op);
+            return it->second;
+        }
+        if (varValue[op.id] == kNoValue) varValue[op.id] = newValue(op);
+        return varValue[op.id];
+    };
+    // 计算的键：交换律运算的操作数按编号排序，> 和 >= 交换操作数后改写为 < 和 <=
+    auto valueKey = [](OpCode op, ValueId lhs, ValueId rhs) {
+        switch (op) {
+            case OpCode::ADD:
+            case OpCode::MUL:
+            case OpCode::EQ:
+            case OpCode::NE:
+            case OpCode::AND:
+            case OpCode::OR:
+                if (rhs < lhs) std::swap(lhs, rhs);
+                break;
+            case OpCode::GT:
+                op = OpCode::LT;
+                std::swap(lhs, rhs);
+                break;
+            case OpCode::GE:
+                op = OpCode::LE;
+                std::swap(lhs, rhs);
+                break;
+            default:
+                break;
+        }
+        return Expression{op, lhs, rhs};
+    };
+    auto isConstantValue = [&](ValueId v) { return leaders[v].type == OperandType::CONSTANT; };
+    // φ 的入口值可能来自尚未访问的前驱：已编号时取代表，否则保持原样
+    auto peek = [&](const Operand& op) {
+        if (op.isReg() && varValue[op.id] == kNoValue && defined[op.id]) return op;
+        return leaders[valueOf(op)];
+    };
+    auto lookup = [&](const Expression& key, const Operand& result) {
+        auto [it, inserted] = table.emplace(key, kNoValue);
+        if (inserted) {
+            it->second = newValue(result);
+            scopeLog.push_back(key);
+        }
+        return it->second;
+    };
+
+    // 给块中每个定义编号，返回是否保留该指令
+    auto numberPhi = [&](PhiInstr* phi, const std::vector<PhiInstr*>& earlier) {
+        const Operand& result = phi->result;
+        Operand same;
+        bool allSame = true;
+        for (auto& in : phi->incoming) {
+            Operand value = peek(in.value);
+            if (value.isReg() && value.id == result.id) continue;
+            if (same.isNone()) {
+                same = value;
+            } else if (!sameOperand(same, value)) {
+                allSame = false;
+                break;
+            }
+        }
+        if (allSame && !same.isNone() && !(same.isReg() && varValue[same.id] == kNoValue && defined[same.id])) {
+            varValue[result.id] = valueOf(same);
+            return false;
+        }
+
+        for (PhiInstr* other : earlier) {
+            bool equal = other->incoming.size() == phi->incoming.size();
+            for (auto& in : phi->incoming) {
+                if (!equal) break;
+                equal = false;
+                for (auto& otherIn : other->incoming) {
+                    if (otherIn.block == in.block) {
+                        equal = sameOperand(peek(otherIn.value), peek(in.value));
+                        break;
+                    }
+                }
+            }
+            if (equal) {
+                varValue[result.id] = varValue[other->result.id];
+                return false;
+            }
+        }
+        varValue[result.id] = newValue(result);
+        return true;
+    };
+
+    auto numberInstr = [&](IRInstr* instr) {
+        forEachUseOperand(instr, [&](Operand& use) { use = leaders[valueOf(use)]; });
+        Operand* def = defOperand(instr);
+        if (!def) return true;
+
+        ValueId value = kNoValue;
+        if (auto assign = instrCast<AssignInstr>(instr)) {
+            value = valueOf(assign->source);
+        } else if (auto unaryOp = instrCast<UnaryOpInstr>(instr)) {
+            ValueId operand = valueOf(unaryOp->operand);
+            if (isConstantValue(operand)) {
+                value = valueOf(makeConstantOperand(evaluateUnaryOp(unaryOp->opcode, leaders[operand].value)));
+            } else {
+                value = lookup(valueKey(unaryOp->opcode, operand, kNoValue), *def);
+            }
+        } else if (auto binOp = instrCast<BinaryOpInstr>(instr)) {
+            ValueId lhs = valueOf(binOp->left), rhs = valueOf(binOp->right);
+            int folded = 0;
+            if (isConstantValue(lhs) && isConstantValue(rhs) &&
+                evaluateBinaryOp(binOp->opcode, leaders[lhs].value, leaders[rhs].value, folded)) {
+                value = valueOf(makeConstantOperand(folded));
+            } else {
+                value = lookup(valueKey(binOp->opcode, lhs, rhs), *def);
+            }
+        } else {
+            // 函数调用的结果每次都不同
+            value = newValue(*def);
+        }
+        varValue[def->id] = value;
+        return sameOperand(leaders[value], *def);
+    };
+
+    auto numberBlock = [&](BasicBlock* block) {
+        auto& instrs = block->instructions;
+        std::vector<PhiInstr*> phis;
+        size_t out = 0;
+        for (auto instr : instrs) {
+            bool keep = true;
+            if (auto phi = instrCast<PhiInstr>(instr)) {
+                keep = numberPhi(phi, phis);
+                if (keep) phis.push_back(phi);
+            } else {
+                keep = numberInstr(instr);
+            }
+            if (keep) instrs[out++] = instr;
+        }
+        instrs.resize(out);
+
+        for (BasicBlock* succ : block->successors) {
+            for (auto instr : succ->instructions) {
+                auto phi = instrCast<PhiInstr>(instr);
+                if (!phi) {
+                    if (instr->opcode == OpCode::LABEL) continue;
+                    break;
+                }
+                for (auto& in : phi->incoming) {
+                    if (in.block == block && in.value.isReg()) in.value = leaders[valueOf(in.value)];
+                }
+            }
+        }
+    };
+
+    // 沿支配树做深度优先遍历；栈中每项为（块，下一个要访问的子结点下标，进入时 scopeLog 的长度）
+    DominatorTree domTree(func);
+    struct Frame {
+        BasicBlock* block;
+        size_t nextChild;
+        size_t logMark;
+    };
+    std::vector<Frame> stack;
+    auto enter = [&](BasicBlock* block) {
+        stack.push_back(Frame{block, 0, scopeLog.size()});
+        numberBlock(block);
+    };
+
+    enter(func.entry());
+    while (!stack.empty()) {
+        Frame& frame = stack.back();
+        const auto& children = domTree.children(frame.block);
+        if (frame.nextChild < children.size()) {
+            enter(children[frame.nextChild++]);
+        } else {
+            while (scopeLog.size() > frame.logMark) {
+                table.erase(scopeLog.back());
+                scopeLog.pop_back();
+            }
+            stack.pop_back();
+        }
+    }
+}
@@ -2,357 +2,461 @@
 #pragma once
 #include "parser/ast.h"
 #include "parser/astVisitor.h"
+#include "common/arena.h"
+#include <cstdint>
 #include <vector>
 #include <string>
 #include <memory>
 #include <map>
+#include <unordered_map>
 
 // OperandType - 操作数类型枚举
-enum class OperandType {
+enum class OperandType : uint8_t {
     VARIABLE,    // 变量操作数（命名变量）
     TEMP,        // 临时变量操作数（编译器生成的临时变量）
     CONSTANT,    // 常量操作数（字面值）
-    LABEL        // 标签操作数（用于控制流）
+    LABEL,       // 标签操作数（用于控制流）
+    NONE         // 空操作数（无返回值的调用和返回）
 };
 
-// 操作数
-class Operand {
+// 操作数编号
+// 命名变量和临时变量共用一个从 0 开始的稠密编号空间（虚拟寄存器），标签另有一个。
+// 优化遍以编号为下标使用数组和位集合，名字只在打印和代码生成时通过 IRNames 查询
+using OperandId = uint32_t;
+constexpr OperandId kNoOperand = UINT32_MAX;
+
+// IRNames - 操作数编号与可打印名字的对照表
+// 同名的变量得到同一个编号：不同作用域中的同名声明在生成时已带上作用域后缀，
+// 后缀相同的声明本来就共用一块存储。函数名也登记在这里，指令中只保存编号
+class IRNames {
+private:
+    std::vector<std::string> vregNames;                     // 虚拟寄存器编号 -> 名字
+    std::unordered_map<std::string, OperandId> vregIds;     // 名字 -> 虚拟寄存器编号
+    std::vector<std::string> labelNames;                    // 标签编号 -> 名字
+    std::unordered_map<std::string, OperandId> labelIds;    // 名字 -> 标签编号
+    std::vector<std::string> functionNames;                 // 函数编号 -> 名字
+    std::unordered_map<std::string, OperandId> functionIds; // 名字 -> 函数编号
+
 public:
-    OperandType type;
-    std::string name;  // 变量名或标签名
-    int value;         // 常量值
+    // 取得名字对应的虚拟寄存器编号，第一次出现时分配新编号
+    OperandId vregId(const std::string& name);
+    // 取得名字对应的标签编号，第一次出现时分配新编号
+    OperandId labelId(const std::string& name);
+    // 查找已有的标签编号，不存在时返回 kNoOperand
+    OperandId findLabel(const std::string& name) const;
+    // 取得名字对应的函数编号，第一次出现时分配新编号
+    OperandId functionId(const std::string& name);
+
+    const std::string& vregName(OperandId id) const { return vregNames[id]; }
+    const std::string& labelName(OperandId id) const { return labelNames[id]; }
+    const std::string& functionName(OperandId id) const { return functionNames[id]; }
+
+    // 已分配的编号数量，即以编号为下标的数组所需的大小
+    size_t vregCount() const { return vregNames.size(); }
+    size_t labelCount() const { return labelNames.size(); }
+};
+
+// 操作数：按值嵌在指令中，常量值直接内联，不单独分配
+struct Operand {
+    OperandType type = OperandType::NONE;
+    OperandId id = kNoOperand;  // 变量和临时变量为虚拟寄存器编号，标签为标签编号，常量不使用
+    int value = 0;              // 常量值
 
-    // 构造函数
-    Operand(OperandType type, const std::string& name) : type(type), name(name), value(0) {}
-    Operand(int value) : type(OperandType::CONSTANT), value(value) {}
+    // 构造函数（默认构造得到空操作数）
+    Operand() = default;
+    Operand(OperandType type, OperandId id) : type(type), id(id) {}
+    explicit Operand(int value) : type(OperandType::CONSTANT), value(value) {}
 
-    std::string toString() const;// 将操作数转换为字符串表示
+    std::string toString(const IRNames& names) const;// 将操作数转换为字符串表示
+    bool isNone() const { return type == OperandType::NONE; }   // 检查是否为空操作数
     bool isTemp() const { return type == OperandType::TEMP; } // 检查操作数是否为临时变量
+    bool isConstant() const { return type == OperandType::CONSTANT; }
+    // 检查操作数是否为虚拟寄存器（命名变量或临时变量）
+    bool isReg() const { return type == OperandType::VARIABLE || type == OperandType::TEMP; }
 };
 
-/*
-    临时变量的三个分析方法
-*/
-bool isProcessableReg(const Operand& op); // 判断操作数是否需要作为寄存器处理（临时变量或命名变量）
-std::vector<std::string> extractReg(const std::shared_ptr<Operand>& op);// 从单个操作数提取寄存器名（若非寄存器类型返回空）
-std::vector<std::string> collectRegs(const std::initializer_list<std::shared_ptr<Operand>>& ops);//多操作数合并
-
 
 // 指令操作码
-enum class OpCode {
+enum class OpCode : uint8_t {
     ADD, SUB, MUL, DIV, MOD,   // 算术运算
     NEG, NOT,                  // 一元运算
     LT, GT, LE, GE, EQ, NE,    // 比较运算
     AND, OR,                   // 逻辑运算
     ASSIGN,                    // 赋值
+    PHI,                       // SSA 形式中汇合点的 φ 函数
     GOTO, IF_GOTO,             // 控制流
     PARAM, CALL, RETURN,       // 函数调用
     LABEL,                     // 标签定义
     FUNCTION_BEGIN, FUNCTION_END // 函数开始和结束
 };
 
-// IR指令基类
+// IR指令基类：只保存操作码
+// 指令分配在所属函数的内存池中（见 IRFunction::arena），因此所有指令类型都必须可平凡析构，
+// 没有虚函数。具体类型由操作码决定，用 instrCast 转换（替代 dynamic_pointer_cast），
+// toString 等按操作码分派到具体类型
 class IRInstr {
 public:
-    OpCode opcode;
-    
-    IRInstr(OpCode opcode) : opcode(opcode) {}
-    virtual ~IRInstr();
-    // 将指令转换为字符串表示（纯虚函数，由子类实现）
-    virtual std::string toString() const = 0;
+    const OpCode opcode;
 
-    //临时变量分析相关函数
-    virtual std::vector<std::string> getDefRegisters();
-    virtual std::vector<std::string> getUseRegisters();
+    // 将指令转换为字符串表示
+    std::string toString(const IRNames& names) const;
 
+protected:
+    explicit IRInstr(OpCode opcode) : opcode(opcode) {}
 };
 
+// 操作码属于 T 时把指令转换为 T*，否则返回空指针
+template <typename T>
+T* instrCast(IRInstr* instr) {
+    return instr && T::classOf(instr->opcode) ? static_cast<T*>(instr) : nullptr;
+}
+
+template <typename T>
+const T* instrCast(const IRInstr* instr) {
+    return instr && T::classOf(instr->opcode) ? static_cast<const T*>(instr) : nullptr;
+}
+
 // 二元运算指令
 class BinaryOpInstr : public IRInstr {
 public:
-    std::shared_ptr<Operand> result;
-    std::shared_ptr<Operand> left;
-    std::shared_ptr<Operand> right;
+    Operand result;
+    Operand left;
+    Operand right;
     
-    BinaryOpInstr(OpCode opcode, 
-                 std::shared_ptr<Operand> result,
-                 std::shared_ptr<Operand> left,
-                 std::shared_ptr<Operand> right)
+    BinaryOpInstr(OpCode opcode, Operand result, Operand left, Operand right)
         : IRInstr(opcode), result(result), left(left), right(right) {}
-    
-    std::string toString() const override;
 
-    // 临时变量分析相关函数
-    std::vector<std::string> getDefRegisters() override{
-        return extractReg(result);  // 目标操作数（如 t0）
+    static bool classOf(OpCode op) {
+        return (op >= OpCode::ADD && op <= OpCode::MOD) || (op >= OpCode::LT && op <= OpCode::OR);
     }
     
-    std::vector<std::string> getUseRegisters() override{
-        return collectRegs({left, right});  // 两个源操作数
-    }
+    std::string toString(const IRNames& names) const;
 };
 
 // 一元运算指令
 class UnaryOpInstr : public IRInstr {
 public:
-    std::shared_ptr<Operand> result;
-    std::shared_ptr<Operand> operand;
+    Operand result;
+    Operand operand;
     
-    UnaryOpInstr(OpCode opcode,
-                std::shared_ptr<Operand> result,
-                std::shared_ptr<Operand> operand)
+    UnaryOpInstr(OpCode opcode, Operand result, Operand operand)
         : IRInstr(opcode), result(result), operand(operand) {}
-    
-    std::string toString() const override;
 
-    // 临时变量分析相关函数
-    std::vector<std::string> getDefRegisters() override{
-        return extractReg(result);
-    }
-
-    std::vector<std::string> getUseRegisters()override{
-        return extractReg(operand);
-    }
+    static bool classOf(OpCode op) { return op == OpCode::NEG || op == OpCode::NOT; }
+    
+    std::string toString(const IRNames& names) const;
 };
 
 // 赋值指令
 class AssignInstr : public IRInstr {
 public:
-    std::shared_ptr<Operand> target;
-    std::shared_ptr<Operand> source;
+    Operand target;
+    Operand source;
     
-    AssignInstr(std::shared_ptr<Operand> target,
-               std::shared_ptr<Operand> source)
+    AssignInstr(Operand target, Operand source)
         : IRInstr(OpCode::ASSIGN), target(target), source(source) {}
+
+    static bool classOf(OpCode op) { return op == OpCode::ASSIGN; }
     
-    std::string toString() const override;
+    std::string toString(const IRNames& names) const;
 
     // 判断一条赋值指令是否是简单复制
     bool isSimpleCopy() const {
         // 右操作数必须是变量类型（不是常量，也不是表达式）
-        return (source->type == OperandType::VARIABLE || source->type == OperandType::TEMP);
+        return source.isReg();
     }    
+};
 
-    // 临时变量分析相关函数
-    std::vector<std::string> getDefRegisters() override{
-        return extractReg(target);  // 目标变量
-    }
-    
-    std::vector<std::string> getUseRegisters() override {
-        return extractReg(source);  // 源变量
-    }
+struct BasicBlock;
+
+// φ 函数的一个入口：控制从前驱块 block 到达时取 value
+struct PhiIncoming {
+    BasicBlock* block;
+    Operand value;
+};
+
+// φ 指令：只出现在 SSA 形式中，位于块首（标签之后），每个前驱恰有一个入口。
+// 同一块中的 φ 在块入口处同时求值；入口值的使用点视为对应前驱块的末尾
+class PhiInstr : public IRInstr {
+public:
+    Operand result;
+    NodeList<PhiIncoming> incoming;     // 位于函数的内存池中
+
+    explicit PhiInstr(Operand result)
+        : IRInstr(OpCode::PHI), result(result) {}
+
+    static bool classOf(OpCode op) { return op == OpCode::PHI; }
+
+    std::string toString(const IRNames& names) const;
 };
 
 // 跳转指令
 class GotoInstr : public IRInstr {
 public:
-    std::shared_ptr<Operand> target; // 标签
+    Operand target; // 标签
     
-    GotoInstr(std::shared_ptr<Operand> target)
+    explicit GotoInstr(Operand target)
         : IRInstr(OpCode::GOTO), target(target) {}
-    
-    std::string toString() const override;
 
-    // 临时变量分析相关函数
-    std::vector<std::string> getDefRegisters() override {
-        return {};  
-    }
-        
-    std::vector<std::string> getUseRegisters() override {
-        return {};  
-    }
+    static bool classOf(OpCode op) { return op == OpCode::GOTO; }
+    
+    std::string toString(const IRNames& names) const;
 };
 
 // 条件跳转指令
 class IfGotoInstr : public IRInstr {
 public:
-    std::shared_ptr<Operand> condition;
-    std::shared_ptr<Operand> target; // 标签
+    Operand condition;
+    Operand target; // 标签
     
-    IfGotoInstr(std::shared_ptr<Operand> condition,
-               std::shared_ptr<Operand> target)
+    IfGotoInstr(Operand condition, Operand target)
         : IRInstr(OpCode::IF_GOTO), condition(condition), target(target) {}
-    
-    std::string toString() const override;
 
-    // 临时变量分析相关函数
-    std::vector<std::string> getDefRegisters() override {
-        return {};  
-    }
-            
-    std::vector<std::string> getUseRegisters() override {
-        return extractReg(condition);  
-    }
+    static bool classOf(OpCode op) { return op == OpCode::IF_GOTO; }
+    
+    std::string toString(const IRNames& names) const;
 };
 
 // 函数参数指令
 class ParamInstr : public IRInstr {
 public:
-    std::shared_ptr<Operand> param;
+    Operand param;
     
-    ParamInstr(std::shared_ptr<Operand> param)
+    explicit ParamInstr(Operand param)
         : IRInstr(OpCode::PARAM), param(param) {}
-    
-    std::string toString() const override;
 
-    // 临时变量分析相关函数
-    std::vector<std::string> getDefRegisters() override {
-        return {};  
-    }
-            
-    std::vector<std::string> getUseRegisters() override {
-        return extractReg(param);  
-    }
+    static bool classOf(OpCode op) { return op == OpCode::PARAM; }
+    
+    std::string toString(const IRNames& names) const;
 };
 
 // 函数调用指令
 class CallInstr : public IRInstr {
 public:
-    std::shared_ptr<Operand> result; // 可能为nullptr表示无返回值
-    std::string funcName;
+    Operand result;                 // 空操作数表示无返回值
+    OperandId callee;               // 被调函数的编号（名字见 IRNames::functionName）
     int paramCount;
     
-    std::vector<std::shared_ptr<Operand>> params; // 新增：存储参数列表，便于代码生成
-
-    CallInstr(std::shared_ptr<Operand> result,
-             const std::string& funcName,
-             int paramCount)
-        : IRInstr(OpCode::CALL), result(result), funcName(funcName), paramCount(paramCount) {}
-    
-    std::string toString() const override;
+    NodeList<Operand> params;       // 参数列表（位于函数的内存池中），便于代码生成
 
-    //临时变量分析相关函数
-    std::vector<std::string> getDefRegisters() override {
-        auto defs = extractReg(result);
-        return defs;
-    }
+    CallInstr(Operand result, OperandId callee, int paramCount)
+        : IRInstr(OpCode::CALL), result(result), callee(callee), paramCount(paramCount) {}
 
-    std::vector<std::string> getUseRegisters() override {
-        std::vector<std::string> regs;
-        for (const auto& param : params) {
-            auto r = extractReg(param);
-            regs.insert(regs.end(), r.begin(), r.end());
-        }
-        return regs;
-    }
+    static bool classOf(OpCode op) { return op == OpCode::CALL; }
+    
+    std::string toString(const IRNames& names) const;
 };
 
 // 返回指令
 class ReturnInstr : public IRInstr {
 public:
-    std::shared_ptr<Operand> value; // 可能为nullptr表示无返回值
+    Operand value; // 空操作数表示无返回值
     
-    ReturnInstr(std::shared_ptr<Operand> value = nullptr)
+    explicit ReturnInstr(Operand value = Operand())
         : IRInstr(OpCode::RETURN), value(value) {}
-    
-    std::string toString() const override;
 
-    // 临时变量分析相关函数
-    std::vector<std::string> getDefRegisters() override {
-        return {};  
-    }
-                
-    std::vector<std::string> getUseRegisters() override {
-        return extractReg(value);  
-    }
+    static bool classOf(OpCode op) { return op == OpCode::RETURN; }
+    
+    std::string toString(const IRNames& names) const;
 };
 
 // 标签指令
 class LabelInstr : public IRInstr {
 public:
-    std::string label;
+    OperandId label;  // 标签编号
     
-    LabelInstr(const std::string& label)
+    explicit LabelInstr(OperandId label)
         : IRInstr(OpCode::LABEL), label(label) {}
-    
-    std::string toString() const override;
 
-    // 临时变量分析相关函数
-    std::vector<std::string> getDefRegisters() override {
-        return {};  
-    }
-                
-    std::vector<std::string> getUseRegisters() override {
-        return {};  
-    }
+    static bool classOf(OpCode op) { return op == OpCode::LABEL; }
+    
+    std::string toString(const IRNames& names) const;
 };
 
 // 函数开始指令
 class FunctionBeginInstr : public IRInstr {
 public:
-    std::string funcName;
-    std::vector<std::string> paramNames; //参数名列表
-    std::string returnType;  // 新增：函数返回类型
-    
-    FunctionBeginInstr(const std::string& funcName, const std::string& returnType = "int")
-        : IRInstr(OpCode::FUNCTION_BEGIN), funcName(funcName), returnType(returnType) {}
+    OperandId func;                 // 函数编号（名字见 IRNames::functionName）
+    bool returnsValue;              // 返回类型是否为 int（否则为 void）
+    NodeList<OperandId> params;     // 参数变量的编号列表（位于函数的内存池中）
     
-    std::string toString() const override;
+    FunctionBeginInstr(OperandId func, bool returnsValue)
+        : IRInstr(OpCode::FUNCTION_BEGIN), func(func), returnsValue(returnsValue) {}
 
-    // 临时变量分析相关函数
-    std::vector<std::string> getDefRegisters() override {
-        return {};  
-    }
-                
-    std::vector<std::string> getUseRegisters() override {
-        return {};  
-    }
+    static bool classOf(OpCode op) { return op == OpCode::FUNCTION_BEGIN; }
+    
+    std::string toString(const IRNames& names) const;
 };
 
 // 函数结束指令
 class FunctionEndInstr : public IRInstr {
 public:
-    std::string funcName;
+    OperandId func;                 // 函数编号
     
-    FunctionEndInstr(const std::string& funcName)
-        : IRInstr(OpCode::FUNCTION_END), funcName(funcName) {}
+    explicit FunctionEndInstr(OperandId func)
+        : IRInstr(OpCode::FUNCTION_END), func(func) {}
+
+    static bool classOf(OpCode op) { return op == OpCode::FUNCTION_END; }
     
-    std::string toString() const override;
+    std::string toString(const IRNames& names) const;
+};
 
-    // 临时变量分析相关函数
-    std::vector<std::string> getDefRegisters() override {
-        return {};  
+//------------------------------------------------------------------------------
+// 操作数槽访问
+//------------------------------------------------------------------------------
+// 按操作码直接访问指令中定义和使用虚拟寄存器的操作数槽，常量、标签和空操作数不算在内。
+// 不构造临时容器；拿到的是指令中的操作数本身，可以就地改写
+
+// 指令定义的虚拟寄存器（每条指令至多一个），没有时返回空指针
+Operand* defOperand(IRInstr* instr);
+const Operand* defOperand(const IRInstr* instr);
+
+// 对指令使用的每个虚拟寄存器操作数调用 f(Operand&)
+template <typename F>
+void forEachUseOperand(IRInstr* instr, F&& f) {
+    auto visit = [&](Operand& op) {
+        if (op.isReg()) f(op);
+    };
+    switch (instr->opcode) {
+        case OpCode::NEG:
+        case OpCode::NOT:
+            visit(static_cast<UnaryOpInstr*>(instr)->operand);
+            break;
+        case OpCode::ASSIGN:
+            visit(static_cast<AssignInstr*>(instr)->source);
+            break;
+        case OpCode::IF_GOTO:
+            visit(static_cast<IfGotoInstr*>(instr)->condition);
+            break;
+        case OpCode::PARAM:
+            visit(static_cast<ParamInstr*>(instr)->param);
+            break;
+        case OpCode::RETURN:
+            visit(static_cast<ReturnInstr*>(instr)->value);
+            break;
+        case OpCode::CALL:
+            // 实参同时出现在前面的 PARAM 指令和调用指令自身，代码生成读取的是后者
+            for (auto& param : static_cast<CallInstr*>(instr)->params) visit(param);
+            break;
+        case OpCode::PHI:
+            for (auto& in : static_cast<PhiInstr*>(instr)->incoming) visit(in.value);
+            break;
+        default:
+            if (auto binOp = instrCast<BinaryOpInstr>(instr)) {
+                visit(binOp->left);
+                visit(binOp->right);
+            }
+            break;
     }
-                
-    std::vector<std::string> getUseRegisters() override {
-        return {};  
+}
+
+// 只读版本：f 接收 const Operand&
+template <typename F>
+void forEachUseOperand(const IRInstr* instr, F&& f) {
+    forEachUseOperand(const_cast<IRInstr*>(instr), [&](const Operand& op) { f(op); });
+}
+
+// 基本块编号：块在所属函数中的下标
+using BlockID = int;
+
+// BasicBlock - 只能从头部进入、从尾部离开的一段指令
+// 块首的标签指令（如果有）和块尾的跳转/返回指令都保存在 instructions 中
+struct BasicBlock {
+    BlockID id = 0;                             // 等于块在 IRFunction::blocks 中的下标
+    OperandId label = kNoOperand;               // 块首标签的编号，没有标签时为 kNoOperand
+    std::vector<IRInstr*> instructions;
+    std::vector<BasicBlock*> successors;        // 后继块（不重复）
+    std::vector<BasicBlock*> predecessors;      // 前驱块（不重复）
+};
+
+// IRFunction - 一个函数的基本块，按输出顺序排列
+// 块之间的边在构建时计算一次，之后由修改控制流的优化遍自行维护
+class IRFunction {
+public:
+    std::string name;                                   // 函数名
+    std::vector<OperandId> params;                      // 形参的变量编号
+    std::vector<std::unique_ptr<BasicBlock>> blocks;    // 第一个块是入口，以 FunctionBeginInstr 开头
+    Arena arena;                                        // 本函数的指令及其中的列表所在的内存池
+
+    explicit IRFunction(std::string name) : name(std::move(name)) {}
+
+    // 在本函数的内存池中创建一条指令
+    template <typename T, typename... Args>
+    T* makeInstr(Args&&... args) {
+        return arena.make<T>(std::forward<Args>(args)...);
     }
+
+    /*
+     * 把函数的指令划分为基本块并连接控制流边（blocks 必须为空）
+     * @param instrs 从函数开始指令到函数结束指令的全部指令，分配在本函数的内存池中
+    */
+    void buildBlocks(const std::vector<IRInstr*>& instrs);
+
+    BasicBlock* entry() const { return blocks.empty() ? nullptr : blocks.front().get(); }
+
+    // 按输出顺序排在 block 之后的块，没有时返回空指针
+    BasicBlock* nextBlock(const BasicBlock* block) const;
+
+    // 查找以指定标签开头的块，没有时返回空指针
+    BasicBlock* findBlock(OperandId label) const;
+
+    // 添加/删除一条边
+    static void addEdge(BasicBlock* from, BasicBlock* to);
+    static void removeEdge(BasicBlock* from, BasicBlock* to);
+
+    // 删除 dead[id] 为真的块，连同它们的所有边，并重新编号剩余的块
+    void removeBlocks(const std::vector<bool>& dead);
+
+    // 在输出顺序的 position 处插入一个没有指令和边的新块，并重新编号其后的块
+    BasicBlock* insertBlock(BlockID position);
+
+    // 从入口可达的块的逆后序（每个块排在它在深度优先树中的所有后代之前）
+    std::vector<BasicBlock*> reversePostOrder() const;
+
+    // 按块的顺序把指令追加到 out
+    void appendInstructions(std::vector<IRInstr*>& out) const;
+};
+
+// IRModule - 编译单元的IR：函数列表（每个函数由IR生成器在生成时建好基本块）
+class IRModule {
+public:
+    std::vector<std::unique_ptr<IRFunction>> functions;
+
+    // 按函数和块的顺序输出扁平的指令序列（供打印和代码生成使用）
+    std::vector<IRInstr*> linearize() const;
 };
 
 // IRPrinter - IR输出器，用于将IR指令序列输出为文本
 class IRPrinter {
 public:
     // 将IR指令序列输出到指定流
-    static void print(const std::vector<std::shared_ptr<IRInstr>>& instructions, std::ostream& out);
+    static void print(const std::vector<IRInstr*>& instructions, const IRNames& names, std::ostream& out);
 };
 
 // IRAnalyzer - IR分析器，提供IR指令分析工具
 class IRAnalyzer {
 public:
     // 查找定义特定操作数的指令
-    static int findDefinition(const std::vector<std::shared_ptr<IRInstr>>& instructions, 
-                             const std::string& operandName);
+    static int findDefinition(const std::vector<IRInstr*>& instructions, 
+                             OperandId operand);
                              
     // 查找使用特定操作数的指令
-    static std::vector<int> findUses(const std::vector<std::shared_ptr<IRInstr>>& instructions, 
-                                   const std::string& operandName);
+    static std::vector<int> findUses(const std::vector<IRInstr*>& instructions, 
+                                   OperandId operand);
                                    
     // 检查变量是否活跃
-    static bool isVariableLive(const std::vector<std::shared_ptr<IRInstr>>& instructions,
-                              const std::string& varName,
+    static bool isVariableLive(const std::vector<IRInstr*>& instructions,
+                              OperandId var,
                               int position);
                               
-    // 获取指令定义的变量
-    static std::vector<std::string> getDefinedVariables(const std::shared_ptr<IRInstr>& instr);
-    
-    // 获取指令使用的变量
-    static std::vector<std::string> getUsedVariables(const std::shared_ptr<IRInstr>& instr);
+    // 指令是否定义了变量 var
+    static bool definesVariable(const IRInstr* instr, OperandId var);
+
+    // 指令是否使用了变量 var
+    static bool usesVariable(const IRInstr* instr, OperandId var);
 
     //用于检查函数是否被使用
-    static bool isFunctionUsed(const std::vector<std::shared_ptr<IRInstr>>& instructions,
+    static bool isFunctionUsed(const std::vector<IRInstr*>& instructions,
+                          const IRNames& names,
                           const std::string& funcName);
-
-    // 在给定指令 instr 中，将所有使用的变量名 useVar 替换为新的变量名 cur
-    static void replaceUsedVariable(std::shared_ptr<IRInstr>& instr, 
-                            const std::string& oldVar, const std::string& newVar); 
 };
@@ -1,7 +1,12 @@
 // irgen.cpp - 实现IR生成器和优化器
 #include "irgen.h"
 #include "ir.h"
+#include "dataflow.h"
+#include "common/bitVector.h"
+#include "common/wrapArith.h"
 #include <set>
+#include <climits>
+#include <cstdint>
 #include <algorithm>
 #include <iostream>
 #include <sstream>
@@ -25,42 +30,74 @@
  */
 
 //------------------------------------------------------------------------------
-// 临时变量分析的方法
+// 操作数槽访问
 //------------------------------------------------------------------------------
-// 判断操作数是否需要作为寄存器处理（临时变量或命名变量）
-bool isProcessableReg(const Operand& op) 
-{
-    return op.type == OperandType::TEMP || op.type == OperandType::VARIABLE;
-}
 
-// 从单个操作数提取寄存器名（若非寄存器类型返回空）
-std::vector<std::string> extractReg(const std::shared_ptr<Operand>& op) 
-{
-    if (op && isProcessableReg(*op)) {
-        return {op->name};  // 返回变量名（无论VARIABLE还是TEMP）
+// 指令定义的虚拟寄存器（结果为空操作数的调用等不算）
+Operand* defOperand(IRInstr* instr) {
+    Operand* def = nullptr;
+    switch (instr->opcode) {
+        case OpCode::NEG:
+        case OpCode::NOT:
+            def = &static_cast<UnaryOpInstr*>(instr)->result;
+            break;
+        case OpCode::ASSIGN:
+            def = &static_cast<AssignInstr*>(instr)->target;
+            break;
+        case OpCode::PHI:
+            def = &static_cast<PhiInstr*>(instr)->result;
+            break;
+        case OpCode::CALL:
+            def = &static_cast<CallInstr*>(instr)->result;
+            break;
+        default:
+            if (auto binOp = instrCast<BinaryOpInstr>(instr)) {
+                def = &binOp->result;
+            }
+            break;
     }
-    return {};  // 忽略常量(CONSTANT)和标签(LABEL)
+    return def && def->isReg() ? def : nullptr;
 }
 
-//多操作数合并
-std::vector<std::string> collectRegs(
-    const std::initializer_list<std::shared_ptr<Operand>>& ops) 
-{
-    std::vector<std::string> regs;
-    for (const auto& op : ops) {
-        auto r = extractReg(op);
-        regs.insert(regs.end(), r.begin(), r.end());
+const Operand* defOperand(const IRInstr* instr) {
+    return defOperand(const_cast<IRInstr*>(instr));
+}
+
+//------------------------------------------------------------------------------
+// 操作数名字表
+//------------------------------------------------------------------------------
+
+// 取得名字对应的虚拟寄存器编号，第一次出现时分配新编号
+OperandId IRNames::vregId(const std::string& name) {
+    auto [it, inserted] = vregIds.emplace(name, static_cast<OperandId>(vregNames.size()));
+    if (inserted) {
+        vregNames.push_back(name);
     }
-    return regs;
+    return it->second;
 }
 
-IRInstr::~IRInstr() = default;
+// 取得名字对应的标签编号，第一次出现时分配新编号
+OperandId IRNames::labelId(const std::string& name) {
+    auto [it, inserted] = labelIds.emplace(name, static_cast<OperandId>(labelNames.size()));
+    if (inserted) {
+        labelNames.push_back(name);
+    }
+    return it->second;
+}
 
-std::vector<std::string> IRInstr::getDefRegisters() {
-    return {};
+// 查找已有的标签编号
+OperandId IRNames::findLabel(const std::string& name) const {
+    auto it = labelIds.find(name);
+    return it == labelIds.end() ? kNoOperand : it->second;
 }
-std::vector<std::string> IRInstr::getUseRegisters() {
-    return {};
+
+// 取得名字对应的函数编号，第一次出现时分配新编号
+OperandId IRNames::functionId(const std::string& name) {
+    auto [it, inserted] = functionIds.emplace(name, static_cast<OperandId>(functionNames.size()));
+    if (inserted) {
+        functionNames.push_back(name);
+    }
+    return it->second;
 }
 
 
@@ -69,23 +106,23 @@ std::vector<std::string> IRInstr::getUseRegisters() {
 //------------------------------------------------------------------------------
 
 // Operand toString方法 - 将操作数转换为字符串表示
-std::string Operand::toString() const {
+std::string Operand::toString(const IRNames& names) const {
     switch (type) {
         case OperandType::VARIABLE:
-            return name;  // 变量名
+            return names.vregName(id);  // 变量名
         case OperandType::TEMP:
-            return name;  // 临时变量名(如t0, t1等)
+            return names.vregName(id);  // 临时变量名(如t0, t1等)
         case OperandType::CONSTANT:
             return std::to_string(value);  // 字面常量值
         case OperandType::LABEL:
-            return name;  // 标签名
+            return names.labelName(id);  // 标签名
         default:
             return "unknown";  // 不应该发生
     }
 }
 
 // BinaryOpInstr toString方法  - 表示二元操作，如a = b + c
-std::string BinaryOpInstr::toString() const {
+std::string BinaryOpInstr::toString(const IRNames& names) const {
     std::string opStr;
     switch (opcode) {
         case OpCode::ADD: opStr = "+"; break;
@@ -104,11 +141,11 @@ std::string BinaryOpInstr::toString() const {
         default: opStr = "unknown"; break;
     }
     // 格式: result = left op right
-    return result->toString() + " = " + left->toString() + " " + opStr + " " + right->toString();
+    return result.toString(names) + " = " + left.toString(names) + " " + opStr + " " + right.toString(names);
 }
 
 // UnaryOpInstr toString方法- 表示一元操作，如a = -b
-std::string UnaryOpInstr::toString() const {
+std::string UnaryOpInstr::toString(const IRNames& names) const {
     std::string opStr;
     // 将操作码枚举转换为字符串表示
     switch (opcode) {
@@ -118,45 +155,59 @@ std::string UnaryOpInstr::toString() const {
     }
     
     // 格式: result = op operand
-    return result->toString() + " = " + opStr + operand->toString();
+    return result.toString(names) + " = " + opStr + operand.toString(names);
 }
 
 // AssignInstr toString方法 - 表示赋值，如a = b
-std::string AssignInstr::toString() const {
-    return target->toString() + " = " + source->toString();
+std::string AssignInstr::toString(const IRNames& names) const {
+    return target.toString(names) + " = " + source.toString(names);
+}
+
+// PhiInstr toString方法 - 表示 φ 函数，如 a.2 = phi(a.1 [L3], a [B0])
+// 入口按前驱块标注，没有标签的块用 B<块号> 表示
+std::string PhiInstr::toString(const IRNames& names) const {
+    std::string text = result.toString(names) + " = phi(";
+    for (size_t i = 0; i < incoming.size(); ++i) {
+        const BasicBlock* block = incoming[i].block;
+        if (i > 0) text += ", ";
+        text += incoming[i].value.toString(names) + " [";
+        text += block->label != kNoOperand ? names.labelName(block->label) : "B" + std::to_string(block->id);
+        text += "]";
+    }
+    return text + ")";
 }
 
 // GotoInstr toString方法 - 表示无条件跳转
-std::string GotoInstr::toString() const {
-    return "goto " + target->toString();
+std::string GotoInstr::toString(const IRNames& names) const {
+    return "goto " + target.toString(names);
 }
 
 // IfGotoInstr toString方法 - 表示条件跳转
-std::string IfGotoInstr::toString() const {
-    return "if " + condition->toString() + " goto " + target->toString();
+std::string IfGotoInstr::toString(const IRNames& names) const {
+    return "if " + condition.toString(names) + " goto " + target.toString(names);
 }
 
 // ParamInstr toString方法 - 表示函数参数
-std::string ParamInstr::toString() const {
-    return "param " + param->toString();
+std::string ParamInstr::toString(const IRNames& names) const {
+    return "param " + param.toString(names);
 }
 
 // CallInstr toString方法 - 表示函数调用
-std::string CallInstr::toString() const {
-    if (result) {
+std::string CallInstr::toString(const IRNames& names) const {
+    if (!result.isNone()) {
         // 有返回值的函数调用: result = call func, paramCount
-        return result->toString() + " = call " + funcName + ", " + std::to_string(paramCount);
+        return result.toString(names) + " = call " + names.functionName(callee) + ", " + std::to_string(paramCount);
     } else {
         // 无返回值的函数调用: call func, paramCount
-        return "call " + funcName + ", " + std::to_string(paramCount);
+        return "call " + names.functionName(callee) + ", " + std::to_string(paramCount);
     }
 }
 
 // ReturnInstr toString方法 - 表示返回语句
-std::string ReturnInstr::toString() const {
-    if (value) {
+std::string ReturnInstr::toString(const IRNames& names) const {
+    if (!value.isNone()) {
         // 有返回值: return value
-        return "return " + value->toString();
+        return "return " + value.toString(names);
     } else {
          // 无返回值: return
         return "return";
@@ -164,18 +215,37 @@ std::string ReturnInstr::toString() const {
 }
 
 // LabelInstr toString方法 - 表示标签
-std::string LabelInstr::toString() const {
-    return label + ":";
+std::string LabelInstr::toString(const IRNames& names) const {
+    return names.labelName(label) + ":";
 }
 
 // FunctionBeginInstr toString方法 - 表示函数定义开始
-std::string FunctionBeginInstr::toString() const {
-    return "function " + funcName + " begin";
+std::string FunctionBeginInstr::toString(const IRNames& names) const {
+    return "function " + names.functionName(func) + " begin";
 }
 
 // FunctionEndInstr toString方法 - 表示函数定义结束
-std::string FunctionEndInstr::toString() const {
-    return "function " + funcName + " end";
+std::string FunctionEndInstr::toString(const IRNames& names) const {
+    return "function " + names.functionName(func) + " end";
+}
+
+// IRInstr toString方法 - 按操作码分派到具体指令类型
+std::string IRInstr::toString(const IRNames& names) const {
+    switch (opcode) {
+        case OpCode::NEG:
+        case OpCode::NOT:            return static_cast<const UnaryOpInstr*>(this)->toString(names);
+        case OpCode::ASSIGN:         return static_cast<const AssignInstr*>(this)->toString(names);
+        case OpCode::PHI:            return static_cast<const PhiInstr*>(this)->toString(names);
+        case OpCode::GOTO:           return static_cast<const GotoInstr*>(this)->toString(names);
+        case OpCode::IF_GOTO:        return static_cast<const IfGotoInstr*>(this)->toString(names);
+        case OpCode::PARAM:          return static_cast<const ParamInstr*>(this)->toString(names);
+        case OpCode::CALL:           return static_cast<const CallInstr*>(this)->toString(names);
+        case OpCode::RETURN:         return static_cast<const ReturnInstr*>(this)->toString(names);
+        case OpCode::LABEL:          return static_cast<const LabelInstr*>(this)->toString(names);
+        case OpCode::FUNCTION_BEGIN: return static_cast<const FunctionBeginInstr*>(this)->toString(names);
+        case OpCode::FUNCTION_END:   return static_cast<const FunctionEndInstr*>(this)->toString(names);
+        default:                     return static_cast<const BinaryOpInstr*>(this)->toString(names);
+    }
 }
 
 //------------------------------------------------------------------------------
@@ -190,16 +260,17 @@ std::string FunctionEndInstr::toString() const {
  * 
  * @param ast AST的根节点
  */
-void IRGenerator::generate(std::shared_ptr<CompUnit> ast) {
-    if (ast) {
-        // 遍历AST生成IR
-        ast->accept(*this);
-
-        // 如果启用了优化，则优化IR
-        if (config.enableOptimizations) {
-            optimize();
-        }
+void IRGenerator::generate(CompUnit& ast) {
+    // 遍历AST生成IR（每个函数生成完毕时即划分好基本块）
+    dispatch(ast);
+
+    // 如果启用了优化，则优化IR
+    if (config.enableOptimizations) {
+        optimize();
     }
+
+    // 输出扁平的指令序列供打印和代码生成使用
+    instructions = module.linearize();
 }
 
 /**
@@ -207,11 +278,11 @@ void IRGenerator::generate(std::shared_ptr<CompUnit> ast) {
  * 
  * 临时变量用于存储表达式求值过程中的中间结果。
  * 
- * @return 新临时变量操作数的共享指针
+ * @return 新临时变量操作数
  */
-std::shared_ptr<Operand> IRGenerator::createTemp() {
-    std::string name = "t" + std::to_string(tempCount++);
-    return std::make_shared<Operand>(OperandType::TEMP, name);
+Operand IRGenerator::createTemp() {
+    OperandId id = names.vregId("t" + std::to_string(tempCount++));
+    return Operand(OperandType::TEMP, id);
 }
 
 /**
@@ -219,11 +290,11 @@ std::shared_ptr<Operand> IRGenerator::createTemp() {
  * 
  * 标签用作控制流指令中的跳转目标。
  * 
- * @return 新标签操作数的共享指针
+ * @return 新标签操作数
  */
-std::shared_ptr<Operand> IRGenerator::createLabel() {
-    std::string name = "L" + std::to_string(labelCount++);
-    return std::make_shared<Operand>(OperandType::LABEL, name);
+Operand IRGenerator::createLabel() {
+    OperandId id = names.labelId("L" + std::to_string(labelCount++));
+    return Operand(OperandType::LABEL, id);
 }
 
 /**
@@ -231,7 +302,7 @@ std::shared_ptr<Operand> IRGenerator::createLabel() {
  * 
  * @param instr 要添加的指令
  */
-void IRGenerator::addInstruction(std::shared_ptr<IRInstr> instr) {
+void IRGenerator::addInstruction(IRInstr* instr) {
     instructions.push_back(instr);
 }
 
@@ -241,15 +312,15 @@ void IRGenerator::addInstruction(std::shared_ptr<IRInstr> instr) {
  * 这在求值表达式时使用。表达式访问方法将其结果压入操作数栈，
  * 此方法用于获取这些结果。
  * 
- * @return 顶部操作数的共享指针
+ * @return 顶部操作数
  */
-std::shared_ptr<Operand> IRGenerator::getTopOperand() {
+Operand IRGenerator::getTopOperand() {
     if (operandStack.empty()) {
         std::cerr << "Error: Operand stack is empty" << std::endl;
-        return std::make_shared<Operand>(0); // 默认返回常量0
+        return Operand(0); // 默认返回常量0
     }
     
-    std::shared_ptr<Operand> result = operandStack.back();
+    Operand result = operandStack.back();
     operandStack.pop_back();
     return result;
 }
@@ -265,7 +336,7 @@ std::shared_ptr<Operand> IRGenerator::getTopOperand() {
  */
 void IRGenerator::enterScope() {
     scopeDepth++;
-    scopeStack.push_back(std::map<std::string, std::shared_ptr<Operand>>());
+    scopes.enterScope();
 }
 
 
@@ -276,8 +347,8 @@ void IRGenerator::enterScope() {
  */
 void IRGenerator::exitScope() {
     scopeDepth--;
-    if (!scopeStack.empty()) {
-        scopeStack.pop_back();
+    if (scopes.depth() > 0) {
+        scopes.exitScope();
     }
 }
 
@@ -287,20 +358,11 @@ void IRGenerator::exitScope() {
  * 这只在最内层作用域中查找，不在外层作用域中查找。
  * 
  * @param name 要查找的变量名
- * @return 变量操作数的共享指针，如果未找到则为nullptr
+ * @return 变量操作数，如果未找到则为空操作数
  */
-std::shared_ptr<Operand> IRGenerator::findVariableInCurrentScope(const std::string& name) {
-    if (scopeStack.empty()) {
-        return nullptr;
-    }
-    
-    auto& currentScope = scopeStack.back();
-    auto it = currentScope.find(name);
-    if (it != currentScope.end()) {
-        return it->second;
-    }
-    
-    return nullptr;
+Operand IRGenerator::findVariableInCurrentScope(SymbolId name) {
+    Operand* var = scopes.findInCurrentScope(name);
+    return var ? *var : Operand();
 }
 
 /**
@@ -309,32 +371,31 @@ std::shared_ptr<Operand> IRGenerator::findVariableInCurrentScope(const std::stri
  * 按照词法作用域规则，从最内层到最外层作用域搜索。
  * 
  * @param name 要查找的变量名
- * @return 变量操作数的共享指针，如果未找到则为nullptr
+ * @return 变量操作数，如果未找到则为空操作数
  */
-std::shared_ptr<Operand> IRGenerator::findVariable(const std::string& name) {
-    // 从内层作用域向外层作用域查找
-    for (auto it = scopeStack.rbegin(); it != scopeStack.rend(); ++it) {
-        auto varIt = it->find(name);
-        if (varIt != it->end()) {
-            return varIt->second;
-        }
-    }
-    
-    return nullptr;
+Operand IRGenerator::findVariable(SymbolId name) {
+    // 符号表直接给出最内层的绑定
+    Operand* var = scopes.find(name);
+    return var ? *var : Operand();
 }
 
 /**
  * 在当前作用域中定义变量。
  * 
  * @param name 要定义的变量名
- * @param var 变量操作数的共享指针
+ * @param var 变量操作数
  */
-void IRGenerator::defineVariable(const std::string& name, std::shared_ptr<Operand> var) {
-    if (scopeStack.empty()) {
+void IRGenerator::defineVariable(SymbolId name, Operand var) {
+    if (scopes.depth() == 0) {
         enterScope();
     }
     
-    scopeStack.back()[name] = var;
+    // 当前作用域中已有同名变量时覆盖原绑定
+    if (Operand* existing = scopes.findInCurrentScope(name)) {
+        *existing = var;
+    } else {
+        scopes.declare(name, var);
+    }
 }
 
 /**
@@ -344,38 +405,39 @@ void IRGenerator::defineVariable(const std::string& name, std::shared_ptr<Operan
  * 否则，创建一个新变量并添加到当前作用域。
  * 
  * @param name 要获取或创建的变量名
- * @return 变量操作数的共享指针
+ * @return 变量操作数
  */
-/*std::shared_ptr<Operand> IRGenerator::getVariable(const std::string& name) {
+/*Operand IRGenerator::getVariable(const std::string& name) {
     // 首先在现有作用域中查找变量
-    std::shared_ptr<Operand> var = findVariable(name);
+    Operand var = findVariable(name);
     if (var) {
         return var;
     }
     
     // 如果变量不存在，创建一个新的并添加到当前作用域
-    var = std::make_shared<Operand>(OperandType::VARIABLE, name);
+    var = Operand(OperandType::VARIABLE, name);
     defineVariable(name, var);
     return var;
 }*/
-std::shared_ptr<Operand> IRGenerator::getVariable(const std::string& name, bool createInCurrentScope) {
+Operand IRGenerator::getVariable(SymbolId name, bool createInCurrentScope) {
     if (createInCurrentScope) {
         // 为变量声明：使用带作用域信息的唯一名称创建新变量
-        std::string scopedName = getScopedVariableName(name);
-        std::shared_ptr<Operand> var = std::make_shared<Operand>(OperandType::VARIABLE, scopedName);
+        OperandId id = names.vregId(getScopedVariableName(name));
+        Operand var = Operand(OperandType::VARIABLE, id);
         defineVariable(name, var);  // 在符号表中仍使用原始名称作为键
         return var;
     }
     
     // 为变量使用：在所有作用域中查找
-    std::shared_ptr<Operand> var = findVariable(name);
-    if (var) {
+    Operand var = findVariable(name);
+    if (!var.isNone()) {
         return var;
     }
     
     // 变量不存在，创建新的（通常发生在函数参数）
     // 对于函数参数，使用原始名称，不生成唯一标识符
-    var = std::make_shared<Operand>(OperandType::VARIABLE, name);  // 使用原始名称
+    OperandId id = names.vregId(std::string(identifiers.spelling(name)));  // 使用原始名称
+    var = Operand(OperandType::VARIABLE, id);
     defineVariable(name, var);
     return var;
 }
@@ -393,7 +455,7 @@ void IRGenerator::dumpIR(const std::string& filename) const {
         return;
     }
     
-    IRPrinter::print(instructions, outFile);
+    IRPrinter::print(instructions, names, outFile);
     outFile.close();
 }
 
@@ -407,15 +469,22 @@ void IRGenerator::dumpIR(const std::string& filename) const {
  * 对IR指令应用各种优化技术。
  */
 void IRGenerator::optimize() {
-    // 按顺序应用每种优化技术
-    constantFolding();        // 在编译时评估常量表达式
-    constantPropagationCFG();    // 在代码中传播常量值
-    copyPropagationCFG();       // 复制传播优化
-    commonSubexpressionElimination();   // 公共子表达式消除
-    deadCodeElimination();    // 删除无效果的代码
+    // 各优化遍都是函数内的，逐个函数按顺序应用
+    for (auto& func : module.functions) {
+        constantFolding(*func);        // 在编译时评估常量表达式
 
-    
-    //controlFlowOptimization(); // 优化控制流（跳转、分支等）
+        constructSSA(*func);           // 转换为 SSA 形式（同时删除不可达块）
+        sparseConditionalConstantPropagation(*func);    // 传播常量值，删除不会执行的分支
+        globalValueNumbering(*func);   // 删除支配路径上的冗余计算
+        loopInvariantCodeMotion(*func);    // 把循环不变的运算移到循环之前
+        destructSSA(*func);            // 转换回普通三地址码
+
+        copyPropagationCFG(*func);       // 复制传播优化
+        commonSubexpressionElimination(*func);   // 公共子表达式消除
+        deadCodeElimination(*func);    // 删除无效果的代码
+
+        //controlFlowOptimization(*func); // 优化控制流（跳转、分支等）
+    }
 }
 
 /**
@@ -424,1166 +493,116 @@ void IRGenerator::optimize() {
  * 在编译时评估常量表达式，用结果替换它们。
  * 例如，2 + 3 变成 5。
  */
-void IRGenerator::constantFolding() {
+void IRGenerator::constantFolding(IRFunction& func) {
     // 常量折叠实现
-    // 遍历所有指令，识别可以在编译时计算的常量表达式
-    for (size_t i = 0; i < instructions.size(); ++i) {
-        auto instr = instructions[i];
+    // 遍历所有指令，识别可以在编译时计算的常量表达式；运算规则与 SCCP、GVN 共用 evaluateBinaryOp / evaluateUnaryOp
+    for (auto& block : func.blocks) {
+        auto& instructions = block->instructions;
+        for (size_t i = 0; i < instructions.size(); ++i) {
+            auto instr = instructions[i];
         
-        // 检查是否是二元操作，且两个操作数都是常量
-        if (auto binOp = std::dynamic_pointer_cast<BinaryOpInstr>(instr)) {
-            if (binOp->left->type == OperandType::CONSTANT && 
-                binOp->right->type == OperandType::CONSTANT) {
-                
+            // 检查是否是二元操作，且两个操作数都是常量
+            if (auto binOp = instrCast<BinaryOpInstr>(instr)) {
                 int result = 0;
-                bool canFold = true;
-                
-                // 根据操作类型计算结果
-                switch (binOp->opcode) {
-                    case OpCode::ADD: result = binOp->left->value + binOp->right->value; break;
-                    case OpCode::SUB: result = binOp->left->value - binOp->right->value; break;
-                    case OpCode::MUL: result = binOp->left->value * binOp->right->value; break;
-                    case OpCode::DIV: 
-                        if (binOp->right->value == 0) {
-                            canFold = false; // 避免除以零
-                        } else {
-                            result = binOp->left->value / binOp->right->value;
-                        }
-                        break;
-                    case OpCode::MOD: 
-                        if (binOp->right->value == 0) {
-                            canFold = false; // 避免除以零
-                        } else {
-                            result = binOp->left->value % binOp->right->value;
-                        }
-                        break;
-                    case OpCode::LT: result = binOp->left->value < binOp->right->value ? 1 : 0; break;
-                    case OpCode::GT: result = binOp->left->value > binOp->right->value ? 1 : 0; break;
-                    case OpCode::LE: result = binOp->left->value <= binOp->right->value ? 1 : 0; break;
-                    case OpCode::GE: result = binOp->left->value >= binOp->right->value ? 1 : 0; break;
-                    case OpCode::EQ: result = binOp->left->value == binOp->right->value ? 1 : 0; break;
-                    case OpCode::NE: result = binOp->left->value != binOp->right->value ? 1 : 0; break;
-                    case OpCode::AND: result = (binOp->left->value && binOp->right->value) ? 1 : 0; break;
-                    case OpCode::OR: result = (binOp->left->value || binOp->right->value) ? 1 : 0; break;
-                    default: canFold = false; break;
-                }
-                
-                if (canFold) {
-                    // 用赋值指令替换原二元操作指令
-                    auto constResult = std::make_shared<Operand>(result);
-                    auto assignInstr = std::make_shared<AssignInstr>(binOp->result, constResult);
-                    instructions[i] = assignInstr;
-                }
-            }
-        }
-        // 检查是否是一元操作，且操作数是常量
-        else if (auto unaryOp = std::dynamic_pointer_cast<UnaryOpInstr>(instr)) {
-            if (unaryOp->operand->type == OperandType::CONSTANT) {
-                int result = 0;
-                bool canFold = true;
-                
-                // 根据操作类型计算结果
-                switch (unaryOp->opcode) {
-                    case OpCode::NEG: result = -unaryOp->operand->value; break;
-                    case OpCode::NOT: result = !unaryOp->operand->value; break;
-                    default: canFold = false; break;
-                }
-                
-                if (canFold) {
-                    // 用赋值指令替换原一元操作指令
-                    auto constResult = std::make_shared<Operand>(result);
-                    auto assignInstr = std::make_shared<AssignInstr>(unaryOp->result, constResult);
-                    instructions[i] = assignInstr;
-                }
-            }
-        }
-    }
-}
-
-/**
- * 常量传播优化。
- * 
- * 跟踪被赋予常量值的变量，并用常量替换这些变量的使用。
- * 这使得进一步的优化机会，如常量折叠成为可能。
- */
-/*
-*   常量传播优化
-*
-*   基于基本块 + 控制流图（CFG）+ 数据流分析 的实现
-*/
-
-// --- Lattice / ConstMap ---
-enum class LatticeKind { Unknown, Constant, Top };  // 三态：未知 / 常量 / 冲突
-
-struct LatticeValue {
-    LatticeKind kind = LatticeKind::Unknown;
-    int constantValue = 0;                                  // 仅当 kind == LatticeKind::Constant时有效，表示该值的​​具体常量数值​​。
-    bool operator==(const LatticeValue& o) const {                          // ==运算符重载
-        if (kind != o.kind) return false;
-        if (kind == LatticeKind::Constant) return constantValue == o.constantValue;
-        return true;
-    }
-    bool operator!=(const LatticeValue& o) const { return !(*this == o); }  // != 运算符重载
-};
-
-using ConstMap = std::unordered_map<std::string, LatticeValue>;
-
-// ---------- 帮助函数（用于比较两个constMap是否语义等价） ----------
-static bool constMapsEqual(const ConstMap& a, const ConstMap& b) {
-
-    // 将缺失的键视为Unknown状态
-    if (a.size() == b.size()) {
-        for (auto& [k, v] : a) {
-            auto it = b.find(k);
-            if (it == b.end()) return false;        // 键不一致直接返回false
-            if (v != it->second) return false;      // 值不一致直接返回false
-        }
-        return true;    // 所有键值对完全匹配
-    }
-
-    // 大小不同时：仍需检查键的并集
-    std::unordered_set<std::string> keys;   // 存储所有键的集合
-    for (auto& [k,_] : a) keys.insert(k);   // 收集a的键
-    for (auto& [k,_] : b) keys.insert(k);   // 收集b的键
-    for (auto& k : keys) {
-        auto ita = a.find(k);
-        auto itb = b.find(k);
-        // 若键不存在则使用默认LatticeValue(即Unknown)
-        LatticeValue va = (ita == a.end() ? LatticeValue{} : ita->second);
-        LatticeValue vb = (itb == b.end() ? LatticeValue{} : itb->second);
-        if (va != vb) return false;     // 存在不匹配的值
-    }
-    return true;    // 所有键的对应值语义等价
-}
-
-// 在循环中对于回边的特殊处理
-using BlockID = int;
-std::vector<std::pair<BlockID, BlockID>> findBackEdges(
-    const std::unordered_map<BlockID, std::vector<BlockID>>& cfg) 
-{
-    std::vector<std::pair<BlockID, BlockID>> backEdges;     // 存储回边结果
-    std::unordered_set<BlockID> visited;                    // 记录已访问的块
-    std::vector<BlockID> stack;                             // DFS递归栈，用于检测回边
-
-    // DFS遍历函数（Lambda表达式）
-    std::function<void(BlockID)> dfs = [&](BlockID b) {
-        visited.insert(b);      // 标记当前块为已访问
-        stack.push_back(b);     // 将当前块压入DFS栈
-
-        // 遍历当前块的所有后继
-        for (auto succ : cfg.at(b)) {
-            // 情况1：后继块在DFS栈中 -> 发现回边
-            if (std::find(stack.begin(), stack.end(), succ) != stack.end()) {
-                backEdges.emplace_back(b, succ);
-            } 
-            // 情况2：后继块未访问 -> 递归处理
-            else if (!visited.count(succ)) {
-                dfs(succ);
-            }
-        }
-
-        stack.pop_back();   // 回溯：当前块处理完毕，弹出栈
-    };
-
-    // 对所有未访问的块启动DFS
-    for (auto& kv : cfg) {
-        if (!visited.count(kv.first)) {
-            dfs(kv.first);
-        }
-    }
-    return backEdges;
-}
-
-/**
- * 获取循环体内定义的所有变量集合（循环定义变量分析）。
- * 通过遍历从循环入口到回边的所有基本块，收集其中被赋值的变量名。
- * 
- * @param cfg 控制流图（BlockID -> 后继块列表）
- * @param fromBlk 回边的起始块（循环体出口）
- * @param toBlk 回边的目标块（循环体入口）
- * @param blocks 基本块集合（BlockID -> Block结构体）
- * @return 包含循环体内所有被赋值变量名的集合
- */
-std::unordered_set<std::string> IRGenerator::getLoopDefs(
-    const std::unordered_set<BlockID>& loopBlocks,
-    const std::unordered_map<BlockID, IRGenerator::BasicBlock>& blocks)
-{
-    std::unordered_set<std::string> defs;   // 存储结果：循环内所有被赋值的变量名
-
-    // 遍历循环体内的每一个基本块
-    for (auto blkId : loopBlocks) {
-        // 查找当前块ID对应的基本块对象
-        auto it = blocks.find(blkId);
-        if (it == blocks.end()) continue; // 没找到块，跳过
-
-        // 遍历当前块的所有指令
-        for (auto& inst : it->second.instructions) {
-            // 检查是否为赋值指令
-            if (auto assignInstr = std::dynamic_pointer_cast<AssignInstr>(inst)) {
-                // 记录被赋值的变量名
-                defs.insert(assignInstr->target->name);
-            }
-        }
-    }
-    return defs;
-}
-
-/**
- * 获取由回边(fromBlk→toBlk)定义的循环体内的所有基本块ID集合
- * 
- * @param cfg 控制流图（BlockID -> 后继列表）
- * @param fromBlk 回边的起始块ID（循环体出口）
- * @param toBlk 回边的目标块ID（循环体入口）
- * @return 包含循环体内所有块ID的无序集合
- */
-std::unordered_set<int> IRGenerator::getLoopBlocks(
-    const std::unordered_map<int, std::vector<int>>& cfg,
-    int fromBlk, int toBlk)
-{
-    // 构建反向CFG
-    std::unordered_map<int, std::vector<int>> predMap;
-    for (auto& kv : cfg) {
-        int u = kv.first;
-        for (int v : kv.second) {
-            predMap[v].push_back(u);
-        }
-    }
-
-    // 反向遍历识别循环体
-    // 从 fromBlk 出发沿反向边走
-    std::unordered_set<int> loopBlocks;
-    std::stack<int> st;
-
-    // 初始化：回边两端一定在循环体内
-    st.push(fromBlk);
-    loopBlocks.insert(toBlk); // 循环入口一定在循环内
-    loopBlocks.insert(fromBlk);
-
-    while (!st.empty()) {
-        int cur = st.top();
-        st.pop();
-
-        // 遍历当前块的所有前驱
-        for (int pred : predMap[cur]) {
-            if (loopBlocks.count(pred)) continue;   // 已处理则跳过
-            loopBlocks.insert(pred);
-            // 关键限制：不越过循环入口（避免包含外部块）
-            if (pred != toBlk) {
-                st.push(pred);
-            }
-        }
-    }
-
-    return loopBlocks;
-}
-
-
-/**
- * 清除指定基本块在循环中定义的变量的常量状态，将其标记为未知（Unknown）。
- * 用于处理循环体中对变量的重新定义，确保数据流分析的保守性。
- * 
- * @param inMap 当前块的输入常量映射表（将被修改）
- * @param loopDefs 预计算的各循环块中定义的变量集合（BlockID -> 变量名集合）
- * @param block 当前处理的基本块ID
- */
-void clearLoopDefs(ConstMap& inMap, 
-    const std::unordered_map<BlockID, std::unordered_set<std::string>>& loopDefs,
-    BlockID block) 
-{
-    // 查找当前块是否属于某个循环定义域
-    auto it = loopDefs.find(block);
-    if (it != loopDefs.end()) {
-        // 遍历该循环块中所有被定义的变量
-        for (auto& var : it->second) {
-            // 强制将变量状态设为未知（覆盖可能的常量传播结果）
-            inMap[var] = {LatticeKind::Unknown, 0}; 
-        }
-    }
-}
-
-
-// meet (合并) 两个 ConstMap：对每个变量，如果两个都是同一常量，则保留，否则 Unknown/Top 规则
-static ConstMap meetMaps(const ConstMap& A, const ConstMap& B) {
-    ConstMap R;     // 结果映射表
-
-    // 1. 收集所有键的并集
-    std::unordered_set<std::string> keys;
-    for (auto& p : A) keys.insert(p.first);
-    for (auto& p : B) keys.insert(p.first);
-
-    // 2. 对每个键进行合并操作
-    for (auto& k : keys) {
-        // 获取两个映射表中该键的值（不存在则视为Unknown）
-        auto ita = A.find(k);
-        auto itb = B.find(k);
-        LatticeValue va = (ita == A.end() ? LatticeValue{} : ita->second);
-        LatticeValue vb = (itb == B.end() ? LatticeValue{} : itb->second);
-
-        // 根据值的类型进行合并  
-        // 情况1：两者都是常量值     
-        if (va.kind == LatticeKind::Constant && vb.kind == LatticeKind::Constant) { 
-            if (va.constantValue == vb.constantValue) {
-                R[k] = va;
-            } else {
-                R[k] = LatticeValue{LatticeKind::Top, 0};
-            }
-        } 
-        // 情况2：一方是Unknown，直接取另一方的值（Unknown不影响结果）
-        else if (va.kind == LatticeKind::Unknown) {
-            R[k] = vb;
-        } 
-        else if (vb.kind == LatticeKind::Unknown) {
-            R[k] = va;
-        } 
-        // 情况3：其他情况（至少一方是Top，或类型组合不明确）
-        else {
-            if (va.kind == LatticeKind::Top || vb.kind == LatticeKind::Top) {
-                R[k] = LatticeValue{LatticeKind::Top, 0};
-            } else {
-                R[k] = LatticeValue{LatticeKind::Top, 0};
-            }
-        }
-    }
-    return R;
-}
-
-// 将 Operand 转换为 LatticeValue（使用当前 env）
-static LatticeValue valueOfOperand(const std::shared_ptr<Operand>& op, const ConstMap& env) {
-
-    // 1. 处理空指针情况：返回Unknown表示无效操作数
-    if (!op) return LatticeValue{LatticeKind::Unknown, 0};
-
-    // 2. 处理常量类型操作数
-    if (op->type == OperandType::CONSTANT) {
-        return LatticeValue{LatticeKind::Constant, op->value};
-    } 
-    // 3. 处理变量或临时变量
-    else if (op->type == OperandType::VARIABLE || op->type == OperandType::TEMP) {
-        auto it = env.find(op->name);
-        if (it == env.end()) return LatticeValue{LatticeKind::Unknown, 0};
-        return it->second;
-    } 
-    // 4. 处理其他类型操作数(如函数调用、指针等)
-    else {
-        // 返回Top表示"可能任何值"(最不精确状态)
-        return LatticeValue{LatticeKind::Top, 0};
-    }
-}
-
-// 尝试计算二元运算的常量（如果两边常量且 op 可计算）
-static bool tryEvalBinaryOp(const std::shared_ptr<BinaryOpInstr>& binOp, int lval, int rval, int& out) {
-    
-    // 匹配对应的二元操作
-    switch (binOp->opcode) {
-        case OpCode::ADD: out = lval + rval; return true;
-        case OpCode::SUB: out = lval - rval; return true;
-        case OpCode::MUL: out = lval * rval; return true;
-        case OpCode::DIV:
-            if (rval == 0) return false;
-            out = lval / rval; return true;
-        case OpCode::AND: out = lval & rval; return true;
-        case OpCode::OR:  out = lval | rval; return true;
-        case OpCode::LT:  out = (lval < rval) ? 1 : 0; return true;
-        case OpCode::GT:  out = (lval > rval) ? 1 : 0; return true;
-        case OpCode::LE:  out = (lval <= rval) ? 1 : 0; return true;
-        case OpCode::GE:  out = (lval >= rval) ? 1 : 0; return true;
-        case OpCode::EQ:  out = (lval == rval) ? 1 : 0; return true;
-        case OpCode::NE:  out = (lval != rval) ? 1 : 0; return true;
-        default: return false;
-    }
-}
-
-// 生成常量操作数
-std::shared_ptr<Operand> IRGenerator::makeConstantOperand(int v, std::string name) {
-    auto op = std::make_shared<Operand>(OperandType::CONSTANT, name);    
-    op->value = v;
-    return op;
-}
-
-// ---------- 构建基本块 ----------
-std::vector<std::shared_ptr<IRGenerator::BasicBlock>> IRGenerator::buildBasicBlocks() {
-    std::vector<std::shared_ptr<BasicBlock>> blocks;    // 存储生成的基本块
-    const auto& instrs = this->instructions; 
-
-    // === 修改点1：构建前去重已有标签 ===
-    std::unordered_set<std::string> seenLabels;
-    std::unordered_map<std::string, std::string> oldToNew; // 记录标签改名映射
-    for (auto &instr : this->instructions) {
-        if (auto lbl = std::dynamic_pointer_cast<LabelInstr>(instr)) {
-            if (seenLabels.count(lbl->label)) {
-                std::string newName = lbl->label + "_dup" + std::to_string(seenLabels.size());
-                oldToNew[lbl->label] = newName;
-                lbl->label = newName;
-            }
-            seenLabels.insert(lbl->label);
-        }
-    }
-    
-    // === 修改点4：同步更新跳转指令的目标标签 ===
-    for (auto &instr : this->instructions) {
-        if (auto ifg = std::dynamic_pointer_cast<IfGotoInstr>(instr)) {
-            if (oldToNew.count(ifg->target->name)) {
-                ifg->target->name = oldToNew[ifg->target->name];
-            }
-        } else if (auto g = std::dynamic_pointer_cast<GotoInstr>(instr)) {
-            if (oldToNew.count(g->target->name)) {
-                g->target->name = oldToNew[g->target->name];
-            }
-        }
-    }
-
-    // === 修改点2：提供生成唯一标签的工具函数 ===
-    auto makeUniqueLabel = [&](const std::string &base) {
-        std::string candidate = base;
-        int counter = 0;
-        while (seenLabels.count(candidate)) {
-            candidate = base + "_" + std::to_string(counter++);
-        }
-        seenLabels.insert(candidate);
-        return candidate;
-    };
-
-    // 首先扫描得到 label -> index 映射
-    std::unordered_map<std::string, int> labelToIndex;
-    for (int i = 0; i < (int)instrs.size(); ++i) {
-        // 如果是标签指令，记录其位置
-        if (auto lbl = std::dynamic_pointer_cast<LabelInstr>(instrs[i])) {
-            labelToIndex[lbl->label] = i;
-        }
-    }
-
-    // 标记 leader（基本块起点）
-    std::vector<char> isLeader(instrs.size(), 0);
-
-    // 规则1：第一条指令默认是Leader
-    if (!instrs.empty()) isLeader[0] = 1;
-
-    for (int i = 0; i < (int)instrs.size(); ++i) {
-        auto ins = instrs[i];
-
-        // 规则2：跳转指令的目标指令是Leader
-        if (auto ifg = std::dynamic_pointer_cast<IfGotoInstr>(ins)) {
-
-            // 查找跳转目标标签对应的指令位置
-            auto it = labelToIndex.find(ifg->target->name);
-            if (it != labelToIndex.end()) isLeader[it->second] = 1;
-
-            // 规则3：跳转指令的下一条指令是Leader（fall-through情况）
-            if (i + 1 < (int)instrs.size()) isLeader[i + 1] = 1;
-        } 
-        // 规则4：无条件跳转指令处理
-        else if (auto g = std::dynamic_pointer_cast<GotoInstr>(ins)) {
-            auto it = labelToIndex.find(g->target->name);
-            if (it != labelToIndex.end()) isLeader[it->second] = 1;
-            if (i + 1 < (int)instrs.size()) isLeader[i + 1] = 1; // safe：即使不可达也当 leader
-        } 
-        // 规则5：返回指令的下一条是Leader
-        else if (auto ret = std::dynamic_pointer_cast<ReturnInstr>(ins)) {
-            if (i + 1 < (int)instrs.size()) isLeader[i + 1] = 1;
-        } 
-        // 规则6：标签指令自身是Leader（处理标签在代码中间的情况）
-        else if (std::dynamic_pointer_cast<LabelInstr>(ins)) {
-            isLeader[i] = 1; // label 自身是 leader（如果 label 在中间）
-        }
-        // 规则7：函数调用的下一条指令是Leader（保守策略）
-        else if (std::dynamic_pointer_cast<CallInstr>(ins)) {
-            if (i + 1 < (int)instrs.size()) isLeader[i + 1] = 1;
-        }
-        // 规则8：函数开始指令是Leader
-        else if (std::dynamic_pointer_cast<FunctionBeginInstr>(ins)) {
-            isLeader[i] = 1;
-        }
-    }
-
-    // 收集所有Leader的索引
-    std::vector<int> leadersIdx;
-    for (int i = 0; i < (int)isLeader.size(); ++i) if (isLeader[i]) leadersIdx.push_back(i);
-    
-    // 特殊情况处理：如果没有Leader但指令不为空，默认第一条为Leader
-    if (leadersIdx.empty() && !instrs.empty()) leadersIdx.push_back(0);
-
-    // 根据Leader划分基本块
-    for (int bi = 0; bi < (int)leadersIdx.size(); ++bi) {
-        int start = leadersIdx[bi];     // 当前基本块起始指令索引
-        // 计算结束指令索引：下一个Leader前一条，或者指令列表末尾
-        int end = (bi + 1 < (int)leadersIdx.size()) ? (leadersIdx[bi + 1] - 1) : ((int)instrs.size() - 1);
-
-        // 创建新基本块
-        auto block = std::make_shared<BasicBlock>();
-        block->id = (int)blocks.size();
-
-        // 将[start..end]范围内的指令加入基本块
-        for (int k = start; k <= end; ++k) block->instructions.push_back(instrs[k]);
-
-        // 如果基本块的第一条指令是标签，记录标签名
-        /*if (!block->instructions.empty()) {
-            if (auto lbl = std::dynamic_pointer_cast<LabelInstr>(block->instructions.front())) {
-                block->label = lbl->label;
-            }
-        }*/
-
-        // 每一个基本块都有各自唯一的标签
-        // 如果第一条指令不是标签，生成一个新标签指令
-        /*if (block->instructions.empty() || 
-            !std::dynamic_pointer_cast<LabelInstr>(block->instructions.front())) {
-            std::string newLabel = "__block" + std::to_string(block->id); // 唯一标签名
-            auto lblInstr = std::make_shared<LabelInstr>(newLabel);
-            block->instructions.insert(block->instructions.begin(), lblInstr); // 插到最前面
-            block->label = newLabel; // 更新块标签
-        } else {
-            // 第一条是标签
-            auto lbl = std::dynamic_pointer_cast<LabelInstr>(block->instructions.front());
-            block->label = lbl->label;
-        }*/
-
-        // === 修改点3：新标签使用 makeUniqueLabel 确保全局唯一 ===
-        if (block->instructions.empty() || 
-            !std::dynamic_pointer_cast<LabelInstr>(block->instructions.front())) {
-            std::string newLabel = makeUniqueLabel("__block" + std::to_string(block->id));
-            auto lblInstr = std::make_shared<LabelInstr>(newLabel);
-            block->instructions.insert(block->instructions.begin(), lblInstr);
-            block->label = newLabel;
-        } else {
-            auto lbl = std::dynamic_pointer_cast<LabelInstr>(block->instructions.front());
-            block->label = lbl->label;
-        }
-
-        blocks.push_back(block);    // 将基本块加入结果列表
-    }
-
-    return blocks;
-}
-
-// ---------- 构建 CFG（连接基本块） ----------
-void IRGenerator::buildCFG(std::vector<std::shared_ptr<BasicBlock>>& blocks) {
-    if (blocks.empty()) return;
-
-    // 建立 label -> block 映射（块以 label 开头）
-    std::unordered_map<std::string, std::shared_ptr<BasicBlock>> labelToBlock;
-    for (auto& b : blocks) {
-        if (!b->label.empty()) labelToBlock[b->label] = b;
-    }
-
-    // 建立 funcName -> block 映射
-    std::unordered_map<std::string, std::shared_ptr<BasicBlock>> functionLabelToBlock;
-    for (auto& block : blocks) {
-        if (!block->instructions.empty()) {
-            for(auto ins:block->instructions)
-            {
-                if(auto fbl = std::dynamic_pointer_cast<FunctionBeginInstr>(ins))
-                {
-                    // 如果是函数入口标签，就加入映射
-                    functionLabelToBlock[fbl->funcName] = block;
-                    break;
+                if (binOp->left.type == OperandType::CONSTANT &&
+                    binOp->right.type == OperandType::CONSTANT &&
+                    evaluateBinaryOp(binOp->opcode, binOp->left.value, binOp->right.value, result)) {
+                    // 用赋值指令替换原二元操作指令（除以零等不能计算的情况留给运行时）
+                    instructions[i] = func.makeInstr<AssignInstr>(binOp->result, Operand(result));
                 }
             }
-            /*if (auto fbl = std::dynamic_pointer_cast<FunctionBeginInstr>(block->instructions.front())) {
-                // 如果是函数入口标签，就加入映射
-                functionLabelToBlock[fbl->funcName] = block;
-            }*/
-        }
-    }
-
-    // 被调函数名 -> 该函数所有调用点的返回位置块
-    std::unordered_map<std::string,std::vector<std::shared_ptr<BasicBlock>>> callReturnSites;
-
-    // 先把函数入口块的 functionName 设置好
-    for (auto& kv : functionLabelToBlock) {
-        const std::string& funcName = kv.first;
-        auto& entryBlock = kv.second;
-        entryBlock->functionName = funcName;
-    }
-
-    // 按照顺序遍历 blocks，给块分配 functionName
-    std::string currentFuncName;
-    for (auto& b : blocks) {
-        if (!b->instructions.empty()) {
-            /*if (auto fbegin = std::dynamic_pointer_cast<FunctionBeginInstr>(b->instructions.front())) {
-                currentFuncName = fbegin->funcName;
-            }*/
-           if(b->functionName != "") currentFuncName = b->functionName;
-        }
-        b->functionName = currentFuncName;
-    }
-
-    // 用来存储每个函数名对应的所有包含 ReturnInstr 的基本块集合，方便后面把这些函数的 return 块连接回调用点的返回块
-    std::unordered_map<std::string, std::vector<std::shared_ptr<BasicBlock>>> functionReturnBlocks;
-    for (auto& b : blocks) {
-        if (!b->instructions.empty()) {
-            auto last = b->instructions.back();
-            if (std::dynamic_pointer_cast<ReturnInstr>(last)) {
-                functionReturnBlocks[b->functionName].push_back(b);
-            }
-        }
-    }
-
-    // 先清空 predecessors / successors（避免旧数据干扰）
-    for (auto& b : blocks) {
-        b->successors.clear();
-        b->predecessors.clear();
-    }
-
-    // 对每个 block，根据尾指令确定 successors（去重）
-    for (int i = 0; i < (int)blocks.size(); ++i) {
-        auto& b = blocks[i];
-        std::unordered_set<std::shared_ptr<BasicBlock>> succSet;
-
-        if (!b->instructions.empty()) {
-            auto last = b->instructions.back();
-
-            if (auto ifg = std::dynamic_pointer_cast<IfGotoInstr>(last)) {
-                auto it = labelToBlock.find(ifg->target->name);
-                if (it != labelToBlock.end()) succSet.insert(it->second);
-                if (i + 1 < (int)blocks.size()) succSet.insert(blocks[i + 1]);
-
-            } else if (auto g = std::dynamic_pointer_cast<GotoInstr>(last)) {
-                auto it = labelToBlock.find(g->target->name);
-                if (it != labelToBlock.end()) succSet.insert(it->second);
-
-            }
-            else if (auto call = std::dynamic_pointer_cast<CallInstr>(last)) {
-                // 1. 连接到被调函数入口（如果解析到）
-                /*auto it = functionLabelToBlock.find(call->funcName);
-                if (it != functionLabelToBlock.end()) succSet.insert(it->second);
-
-                // 2. 如果调用会返回，记录返回点（但是不要在此刻把调用块直接连到返回点）
-                if (i + 1 < blocks.size()) {
-                    // 记录：被调函数名 -> 返回点（调用之后的块）
-                    callReturnSites[call->funcName].push_back(blocks[i + 1]);
-                }
-
-                // 3. 保证顺序连接存在
-                if (i + 1 < blocks.size()) {
-                    succSet.insert(blocks[i + 1]); 
-                    callReturnSites[call->funcName].push_back(blocks[i + 1]);
-                }*/
-
-                // 对于函数内分析，不去连接到被调函数
-                // 只顺序连接到下一个块（如果有）
-                if (i + 1 < (int)blocks.size()) {
-                    succSet.insert(blocks[i + 1]);
-                }
-            } 
-            else if (!std::dynamic_pointer_cast<ReturnInstr>(last)) {
-                if (i + 1 < (int)blocks.size()) succSet.insert(blocks[i + 1]);
-
-            } 
-        }
-
-        b->successors.assign(succSet.begin(), succSet.end());
-    }
-
-    //  在所有函数都处理完后：把被调函数的 return 块统一连回所有调用点的返回点
-    /*for (auto &kv : callReturnSites) {
-        const std::string &callee = kv.first;
-        const auto &returnSites = kv.second; // 所有调用该 callee 的返回点块
-
-        auto it = functionReturnBlocks.find(callee);
-        if (it == functionReturnBlocks.end()) continue; // 没有 return（或未解析），跳过
-
-        const auto &calleeReturnBlocks = it->second;
-        for (auto &retBlk : calleeReturnBlocks) {
-            // 把 retBlk 的后继加入每个 returnSite（去重）
-            std::unordered_set<std::shared_ptr<BasicBlock>> succSet(
-                retBlk->successors.begin(), retBlk->successors.end());
-            for (auto &retSiteBlk : returnSites) {
-                succSet.insert(retSiteBlk);
-            }
-            retBlk->successors.assign(succSet.begin(), succSet.end());
-        }
-    }*/
-
-    // 填充 predecessors
-    for (auto& b : blocks) {
-        for (auto& s : b->successors) {
-            s->predecessors.push_back(b);
-        }
-    }
-}
-
-// ---------- transfer function：基于当前 env 更新 env（顺序应用 block 内指令） ----------
-void applyTransferToEnv(ConstMap& env, const std::shared_ptr<IRInstr>& instr) {
-
-    // AssignInstr
-    if (auto assignInstr = std::dynamic_pointer_cast<AssignInstr>(instr)) {
-        // 如果 source 是常量，直接写常量
-        if (assignInstr->source->type == OperandType::CONSTANT) {
-            env[assignInstr->target->name] = LatticeValue{LatticeKind::Constant, assignInstr->source->value};
-        } else if (assignInstr->source->type == OperandType::VARIABLE || assignInstr->source->type == OperandType::TEMP) {
-            // 如果 source 在 env 中是常量，赋值传播，否则变 Top
-            auto it = env.find(assignInstr->source->name);
-            if (it != env.end() && it->second.kind == LatticeKind::Constant) {
-                env[assignInstr->target->name] = it->second;
-            } else if (it != env.end() && it->second.kind == LatticeKind::Unknown) {
-                env[assignInstr->target->name] = LatticeValue{LatticeKind::Unknown, 0};
-            } else {
-                env[assignInstr->target->name] = LatticeValue{LatticeKind::Top, 0};
-            }
-        } else {
-            // 来源复杂（如 memory），置 Top
-            env[assignInstr->target->name] = LatticeValue{LatticeKind::Top, 0};
-        }
-    } 
-    // BinaryOpInstr
-    else if (auto binOp = std::dynamic_pointer_cast<BinaryOpInstr>(instr)) {
-        // 尝试如果左右都是常量，则计算结果
-        auto L = valueOfOperand(binOp->left, env);
-        auto R = valueOfOperand(binOp->right, env);
-        if (L.kind == LatticeKind::Constant && R.kind == LatticeKind::Constant) {
-            int outv;
-            if (tryEvalBinaryOp(binOp, L.constantValue, R.constantValue, outv)) {
-                env[binOp->result->name] = LatticeValue{LatticeKind::Constant, outv};
-            } else {
-                env[binOp->result->name] = LatticeValue{LatticeKind::Top, 0};
-            }
-        } else if (L.kind == LatticeKind::Unknown || R.kind == LatticeKind::Unknown) {
-            env[binOp->result->name] = LatticeValue{LatticeKind::Unknown, 0};
-        } else {
-            env[binOp->result->name] = LatticeValue{LatticeKind::Top, 0};
-        }
-    } 
-    // UnaryOpInstr
-    else if (auto unaryOp = std::dynamic_pointer_cast<UnaryOpInstr>(instr)) {
-        auto V = valueOfOperand(unaryOp->operand, env);
-        if (V.kind == LatticeKind::Constant) {
-
-            // 按照对应的操作符执行操作
-            int outv = V.constantValue;
-            if(unaryOp->opcode == OpCode::NEG) outv = -outv;
-            else if(unaryOp->opcode == OpCode::NOT) outv = !outv;
-
-            env[unaryOp->result->name] = LatticeValue{LatticeKind::Constant, outv};
-        } else if (V.kind == LatticeKind::Unknown) {
-            env[unaryOp->result->name] = LatticeValue{LatticeKind::Unknown, 0};
-        } else {
-            env[unaryOp->result->name] = LatticeValue{LatticeKind::Top, 0};
-        }
-    } 
-    // CallInstr
-    else if (auto callInstr = std::dynamic_pointer_cast<CallInstr>(instr)) {
-        // 保守处理：函数调用可能有副作用，result 置 Top；如果你能保证调用不影响其他变量，可优化
-        if (callInstr->result) env[callInstr->result->name] = LatticeValue{LatticeKind::Top, 0};
-    } 
-    // 其他指令
-    else {
-        // GotoInstr / IfGotoInstr / ParamInstr / ReturnInstr / LabelInstr / FunctionBeginInstr / FunctionEndInstr
-        // 不会产生新的定义，因此 env 保持不变
-    }
-}
-
-// ---------- 主分析与替换（CFG 版常量传播） ----------
-void IRGenerator::constantPropagationCFG() {
-    // 1. 构建 basic blocks 与 CFG
-    auto blocks = buildBasicBlocks();
-    buildCFG(blocks);
-
-    int n = (int)blocks.size();
-    if (n == 0) return;
-
-    // 生成 CFG 映射：BlockID -> 后继列表
-    std::unordered_map<int, std::vector<int>> cfg;
-    for (auto& b : blocks) {
-        std::vector<int> succIds;
-        for (auto& s : b->successors) {
-            succIds.push_back(s->id);
-        }
-        cfg[b->id] = std::move(succIds);
-    }
-
-    // 2. 找回边
-    auto backEdges = findBackEdges(cfg);
-
-    // 3. 针对回边，找循环体内所有定义变量集合
-    //    这里需要一个 BlockID -> BasicBlock 映射方便访问
-    std::unordered_map<int, IRGenerator::BasicBlock> blocksMap;
-    for (auto& b : blocks) blocksMap[b->id] = *b;
-    
-
-    // 循环入口块ID -> 循环内所有定义变量集合
-    std::unordered_map<int, std::unordered_set<std::string>> loopDefs;
-    for (auto& edge : backEdges) {
-        int fromBlk = edge.first;
-        int toBlk = edge.second;
-
-        //auto defs = getLoopDefs(cfg, fromBlk, toBlk, blocksMap);
-
-        // 用 getLoopBlocks 得到该回边的自然循环块集合
-        auto loopBlocks = getLoopBlocks(cfg, fromBlk, toBlk);
-
-        // 收集该循环体内所有定义变量
-        auto defs = getLoopDefs(loopBlocks, blocksMap);
-
-        // 合并 defs 到 loopDefs，key用循环入口块ID（toBlk）
-        auto& defSet = loopDefs[toBlk];
-        defSet.insert(defs.begin(), defs.end());
-
-    }
-
-    // 4. 初始化 in/out map
-    std::vector<ConstMap> inMap(n), outMap(n);
-
-    // 5. worklist（初始把入口块放入）
-    std::queue<int> q;
-    // 假定 blocks[0] 是入口（如果函数有多入口或特殊结构需修改）
-    q.push(0);
-
-    std::unordered_set<int> clearedLoops; // 记录已清理的循环入口块
-    while (!q.empty()) {
-        int bid = q.front(); q.pop();
-        auto blk = blocks[bid];
-
-        // 计算 inMap[bid]
-        // in[bid] = meet(out[pred]) for all predecessors
-        if (blk->predecessors.empty()) {
-            inMap[bid].clear();
-        } else {
-            ConstMap accum;
-            bool first = true;
-            for (auto& p : blk->predecessors) {
-                if (first) {
-                    accum = outMap[p->id];
-                    first = false;
-                } else {
-                    accum = meetMaps(accum, outMap[p->id]);
-                }
-            }
-
-            // 清除循环定义变量的常量状态（只有循环入口块才清除）
-            /*if (loopDefs.count(bid)) {
-                clearLoopDefs(accum, loopDefs, bid);
-            }*/
-
-            // 只对未清理的循环入口块做清理
-            if (loopDefs.count(bid) && clearedLoops.count(bid) == 0) {
-                clearLoopDefs(accum, loopDefs, bid);
-                clearedLoops.insert(bid);
-            }
-
-            inMap[bid] = accum;
-        }
-
-
-        // 计算 outMap[bid]
-        // out = transfer(in, block.instructions)
-        ConstMap outEnv = inMap[bid];
-        for (auto& instr : blk->instructions) {
-            applyTransferToEnv(outEnv, instr);
-        }
-
-        // 如果 out 改变，更新并把所有后继放入队列
-        if (!constMapsEqual(outEnv, outMap[bid])) {
-            outMap[bid] = outEnv;
-            for (auto& succ : blk->successors) q.push(succ->id);
-        }
-    }
-
-    // 6. 用 inMap 替换每个基本块内部可确定为常量的操作数（在替换时顺序应用 transfer）
-    for (int bid = 0; bid < n; ++bid) {
-
-        // 获取当前块的常量环境（inMap）和基本块对象
-        ConstMap env = inMap[bid];
-        auto blk = blocks[bid];
-
-        // 遍历块中的每条指令
-        for (auto& instr : blk->instructions) {
-            // 处理赋值指令
-            if (auto assignInstr = std::dynamic_pointer_cast<AssignInstr>(instr)) {
-                // 检查源操作数是否为变量/临时变量
-                if (assignInstr->source->type == OperandType::VARIABLE || assignInstr->source->type == OperandType::TEMP) {
-                    // 在环境查找变量状态
-                    auto it = env.find(assignInstr->source->name);
-                    // 如果是常量则替换为常量操作数
-                    if (it != env.end() && it->second.kind == LatticeKind::Constant) {
-                        assignInstr->source = makeConstantOperand(it->second.constantValue, assignInstr->source->name);
-                    }
-                }
-            } 
-            // 处理二元运算指令
-            else if (auto binOp = std::dynamic_pointer_cast<BinaryOpInstr>(instr)) {
-                // 检查左操作数
-                if (binOp->left->type == OperandType::VARIABLE || binOp->left->type == OperandType::TEMP) {
-                    auto it = env.find(binOp->left->name);
-                    if (it != env.end() && it->second.kind == LatticeKind::Constant) {
-                        binOp->left = makeConstantOperand(it->second.constantValue, binOp->left->name);
-                    }
-                }
-                // 检查右操作数
-                if (binOp->right->type == OperandType::VARIABLE || binOp->right->type == OperandType::TEMP) {
-                    auto it = env.find(binOp->right->name);
-                    if (it != env.end() && it->second.kind == LatticeKind::Constant) {
-                        binOp->right = makeConstantOperand(it->second.constantValue, binOp->right->name);
-                    }
-                }
-            } 
-            // 处理一元运算指令
-            else if (auto unaryOp = std::dynamic_pointer_cast<UnaryOpInstr>(instr)) {
-                if (unaryOp->operand->type == OperandType::VARIABLE || unaryOp->operand->type == OperandType::TEMP) {
-                    auto it = env.find(unaryOp->operand->name);
-                    if (it != env.end() && it->second.kind == LatticeKind::Constant) {
-                        unaryOp->operand = makeConstantOperand(it->second.constantValue, unaryOp->operand->name);
-                    }
-                }
-            } 
-            // 处理参数传递指令
-            else if (auto paramInstr = std::dynamic_pointer_cast<ParamInstr>(instr)) {
-                if (paramInstr->param->type == OperandType::VARIABLE || paramInstr->param->type == OperandType::TEMP) {
-                    auto it = env.find(paramInstr->param->name);
-                    if (it != env.end() && it->second.kind == LatticeKind::Constant) {
-                        paramInstr->param = makeConstantOperand(it->second.constantValue, paramInstr->param->name);
-                    }
-                }
-            } 
-            // 处理函数调用指令
-            else if (auto callInstr = std::dynamic_pointer_cast<CallInstr>(instr)) {
-                for (auto& arg : callInstr->params) {
-                    if (arg->type == OperandType::VARIABLE || arg->type == OperandType::TEMP) {
-                        auto it = env.find(arg->name);
-                        if (it != env.end() && it->second.kind == LatticeKind::Constant) {
-                            arg = makeConstantOperand(it->second.constantValue, arg->name);
-                        }
-                    }
-                }
-            } 
-            // 处理返回指令
-            else if (auto returnInstr = std::dynamic_pointer_cast<ReturnInstr>(instr)) {
-                if (returnInstr->value && (returnInstr->value->type == OperandType::VARIABLE || returnInstr->value->type == OperandType::TEMP)) {
-                    auto it = env.find(returnInstr->value->name);
-                    if (it != env.end() && it->second.kind == LatticeKind::Constant) {
-                        returnInstr->value = makeConstantOperand(it->second.constantValue, returnInstr->value->name);
-                    }
-                }
-            } 
-            // 处理条件跳转指令
-            else if (auto ifg = std::dynamic_pointer_cast<IfGotoInstr>(instr)) {
-                if (ifg->condition->type == OperandType::VARIABLE || ifg->condition->type == OperandType::TEMP) {
-                    auto it = env.find(ifg->condition->name);
-                    if (it != env.end() && it->second.kind == LatticeKind::Constant) {
-                        ifg->condition = makeConstantOperand(it->second.constantValue, ifg->condition->name);
-                    }
-                }
-            }
-            // 逐条指令应用 transfer，使 env 随 block 内顺序更新（保守，保持一致）
-            applyTransferToEnv(env, instr);
-        }
-    }
-
-    // 7. 再执行常量折叠（已有的函数）
-    constantFolding();
-}
-
-
-/**
- * 执行死代码消除优化（Dead Code Elimination, DCE）
- * 算法步骤：
- * 1. 构建基本块和控制流图（CFG）
- * 2. 计算每个基本块的use和def集合
- * 3. 迭代计算live_in和live_out集合（数据流分析）
- * 4. 反向扫描指令，删除未被使用的定义
- */
-void IRGenerator::deadCodeElimination() {
-    // ========== Step 0: 构建CFG ==========
-    auto basicBlocks = buildBasicBlocks();
-    buildCFG(basicBlocks);
-
-    // ========== Step 1: 收集use/def集合 ==========
-    std::unordered_map<std::shared_ptr<BasicBlock>, std::unordered_set<std::string>> use, def;
-    for (auto& block : basicBlocks) {
-        for (auto& instr : block->instructions) {
-            // 获取当前指令定义和使用的变量
-            auto defs = IRAnalyzer::getDefinedVariables(instr);
-            auto uses = IRAnalyzer::getUsedVariables(instr);
-
-            // 构建use集合：变量在被定义前被使用
-            for (auto& u : uses) {
-                if (def[block].find(u) == def[block].end()) {
-                    use[block].insert(u);
-                }
-            }
-
-            // 构建def集合：当前指令定义的所有变量
-            for (auto& d : defs) {
-                def[block].insert(d);
-            }
-        }
-    }
-
-
-    // ========== MODIFIED: Tarjan算法识别循环(SCC) ==========
-    std::unordered_map<std::shared_ptr<BasicBlock>, int> indexMap;
-    std::unordered_map<std::shared_ptr<BasicBlock>, int> lowlink;
-    std::unordered_set<std::shared_ptr<BasicBlock>> onStack;
-    std::stack<std::shared_ptr<BasicBlock>> tarjanStack;    // 存储所有强连通分量（SCC）
-    int indexCounter = 0;
-    std::vector<std::vector<std::shared_ptr<BasicBlock>>> sccList;
-
-    // Tarjan的DFS实现
-    std::function<void(std::shared_ptr<BasicBlock>)> tarjan = [&](std::shared_ptr<BasicBlock> v) {
-        indexMap[v] = ++indexCounter;
-        lowlink[v] = indexMap[v];
-        tarjanStack.push(v);
-        onStack.insert(v);
-
-        // 遍历后继节点
-        for (auto w : v->successors) {
-            if (!indexMap.count(w)) {   // 未访问过的节点
-                tarjan(w);  
-                lowlink[v] = std::min(lowlink[v], lowlink[w]);
-            } else if (onStack.count(w)) {  // 已在栈中的节点（形成环）
-                lowlink[v] = std::min(lowlink[v], indexMap[w]);
-            }
-        }
-
-        // 发现SCC（lowlink[v] == indexMap[v]表示找到一个强连通分量）
-        if (lowlink[v] == indexMap[v]) {
-            std::vector<std::shared_ptr<BasicBlock>> scc;
-            while (!tarjanStack.empty()) {
-                auto w = tarjanStack.top();
-                tarjanStack.pop();
-                onStack.erase(w);
-                scc.push_back(w);
-                if (w == v) break;  // 弹出直到当前节点
-            }
-            sccList.push_back(std::move(scc));
-        }
-    };
-
-    // 对所有块执行Tarjan算法
-    for (auto& b : basicBlocks) {
-        if (!indexMap.count(b)) tarjan(b);
-    }
-
-    // 建立块到SCC的映射（block -> SCC ID）
-    std::unordered_map<std::shared_ptr<BasicBlock>, int> blockToScc;
-    for (int i = 0; i < (int)sccList.size(); ++i) {
-        for (auto& b : sccList[i]) blockToScc[b] = i;
-    }
-
-    // 预计算每个SCC的出口块（后继不在同一SCC的块）
-    std::unordered_map<int, std::unordered_set<std::shared_ptr<BasicBlock>>> sccExitBlocks;
-    for (int i = 0; i < (int)sccList.size(); ++i) {
-        for (auto& b : sccList[i]) {
-            for (auto& succ : b->successors) {
-                if (blockToScc[succ] != i) {
-                    sccExitBlocks[i].insert(succ);
-                }
-            }
-        }
-    }
-
-    
-
-    // Step 2: 计算活跃变量（live_in和live_out）
-    std::unordered_map<std::shared_ptr<BasicBlock>, std::unordered_set<std::string>> live_in, live_out;
-
-    // 初始化 worklist（逆序放入所有块）
-    std::queue<std::shared_ptr<BasicBlock>> worklist;
-    std::unordered_set<std::shared_ptr<BasicBlock>> inQueue;
-    for (auto it = basicBlocks.rbegin(); it != basicBlocks.rend(); ++it) {
-        worklist.push(*it);
-        inQueue.insert(*it);
-    }
-
-    while (!worklist.empty()) {
-        auto block = worklist.front();
-        worklist.pop();
-        inQueue.erase(block);
-
-        // live_out = 后继的 live_in 并集
-        std::unordered_set<std::string> new_live_out;
-        
-        // MODIFIED: 区分普通边和回边（循环内部边）
-        int thisScc = -1;
-        if (blockToScc.count(block)) thisScc = blockToScc[block];
-
-        for (auto succ : block->successors) {
-            int succScc = -1;
-            if (blockToScc.count(succ)) succScc = blockToScc[succ];
-
-            if (thisScc != -1 && succScc == thisScc) {
-                // 边属于同一 SCC —— 可能是回边或 SCC 内部边
-                // 将该 SCC 的所有出口块的 live_in 注入 new_live_out
-                for (auto exitBlk : sccExitBlocks[thisScc]) {
-                    new_live_out.insert(live_in[exitBlk].begin(), live_in[exitBlk].end());
+            // 检查是否是一元操作，且操作数是常量
+            else if (auto unaryOp = instrCast<UnaryOpInstr>(instr)) {
+                if (unaryOp->operand.type == OperandType::CONSTANT) {
+                    // 用赋值指令替换原一元操作指令
+                    int result = evaluateUnaryOp(unaryOp->opcode, unaryOp->operand.value);
+                    instructions[i] = func.makeInstr<AssignInstr>(unaryOp->result, Operand(result));
                 }
-                // 同时也可以合并 succ 本身的 live_in（保险起见）
-                new_live_out.insert(live_in[succ].begin(), live_in[succ].end());
-            } else {
-                // 普通边（跨 SCC）：直接合并后继的live_in
-                new_live_out.insert(live_in[succ].begin(), live_in[succ].end());
             }
         }
+    }
+}
 
+// 生成常量操作数
+Operand IRGenerator::makeConstantOperand(int v) {
+    return Operand(v);
+}
 
-        // live_in = use ∪ (live_out - def)
-        std::unordered_set<std::string> new_live_in = use[block];
-        for (auto& var : new_live_out) {
-            if (def[block].find(var) == def[block].end()) {
-                new_live_in.insert(var);
-            }
-        }
+// 计算两个常量的二元运算，除数为零或 INT_MIN / -1 不能在编译期计算时返回 false
+bool IRGenerator::evaluateBinaryOp(OpCode opcode, int lval, int rval, int& out) {
+    switch (opcode) {
+        case OpCode::ADD: out = wrapAdd(lval, rval); return true;
+        case OpCode::SUB: out = wrapSub(lval, rval); return true;
+        case OpCode::MUL: out = wrapMul(lval, rval); return true;
+        case OpCode::DIV:
+            if (rval == 0 || (lval == INT_MIN && rval == -1)) return false;
+            out = lval / rval; return true;
+        case OpCode::MOD:
+            if (rval == 0 || (lval == INT_MIN && rval == -1)) return false;
+            out = lval % rval; return true;
+        case OpCode::AND: out = (lval && rval) ? 1 : 0; return true;
+        case OpCode::OR:  out = (lval || rval) ? 1 : 0; return true;
+        case OpCode::LT:  out = (lval < rval) ? 1 : 0; return true;
+        case OpCode::GT:  out = (lval > rval) ? 1 : 0; return true;
+        case OpCode::LE:  out = (lval <= rval) ? 1 : 0; return true;
+        case OpCode::GE:  out = (lval >= rval) ? 1 : 0; return true;
+        case OpCode::EQ:  out = (lval == rval) ? 1 : 0; return true;
+        case OpCode::NE:  out = (lval != rval) ? 1 : 0; return true;
+        default: return false;
+    }
+}
 
-        // 如果有变化，更新并把前驱加入队列
-        if (new_live_in != live_in[block] || new_live_out != live_out[block]) {
-            live_in[block] = std::move(new_live_in);
-            live_out[block] = std::move(new_live_out);
+// 计算常量的一元运算，取负同样按补码回绕（-INT_MIN == INT_MIN）
+int IRGenerator::evaluateUnaryOp(OpCode opcode, int value) {
+    return opcode == OpCode::NEG ? wrapSub(0, value) : !value;
+}
 
-            for (auto pred : block->predecessors) {
-                if (!inQueue.count(pred)) {
-                    worklist.push(pred);
-                    inQueue.insert(pred);
-                }
-            }
-        }
-    }
 
+/**
+ * 执行死代码消除优化（Dead Code Elimination, DCE）
+ * 算法步骤：
+ * 1. 计算每个基本块出口处的活跃变量（computeLiveness）
+ * 2. 反向扫描指令，删除未被使用的定义
+ */
+void IRGenerator::deadCodeElimination(IRFunction& func) {
+    // ========== Step 0: 使用函数的CFG ==========
+    auto& basicBlocks = func.blocks;
 
+    // ========== Step 1: 计算活跃变量（live_out） ==========
+    const size_t varCount = names.vregCount();
+    std::vector<BitVector> live_out = computeLiveness(func, varCount).out;
 
-    // Step 3: 反向删除死代码
+    // ========== Step 2: 反向删除死代码 ==========
     for (auto& block : basicBlocks) {
-        auto live = live_out[block];    // 初始化为基本块出口的活跃变量集合
+        BitVector& live = live_out[block->id];  // 初始化为基本块出口的活跃变量集合
 
         // 反向遍历指令（从后往前）
         for (auto it = block->instructions.rbegin(); it != block->instructions.rend(); ) {
-            auto defs = IRAnalyzer::getDefinedVariables(*it);
-            auto uses = IRAnalyzer::getUsedVariables(*it);
+            const Operand* defined = defOperand(*it);
 
             bool hasSideEffect = isSideEffectInstr(*it);    // 检查是否是副作用指令
 
             // 判断当前指令是否定义了活跃变量
-            bool isLive = false;
-            for (auto& d : defs) {
-                if (live.find(d) != live.end()) {
-                    isLive = true;
-                    break;
-                }
-            }
+            bool isLive = defined && live.test(defined->id);
 
             // 删除条件：1. 未定义活跃变量 2. 无副作用 3. 实际有定义（避免删除空指令）
-            if (!isLive && !hasSideEffect && !defs.empty()) {
+            if (!isLive && !hasSideEffect && defined) {
                 // 删除死代码
                 it = decltype(it){ block->instructions.erase(std::next(it).base()) };
                 continue;
             }
 
             // 更新 live 集合
-            for (auto& d : defs) {
-                live.erase(d);      // 定义的变量不再活跃
-            }
-            for (auto& u : uses) {
-                live.insert(u);     // 使用的变量变为活跃
+            if (defined) {
+                live.reset(defined->id);    // 定义的变量不再活跃
             }
+            forEachUseOperand(*it, [&](const Operand& u) {
+                live.set(u.id);         // 使用的变量变为活跃
+            });
 
             ++it;
         }
     }
-
-    this->instructions.clear();
-    for (auto& block : basicBlocks) {
-        for (auto& instr : block->instructions) {
-            this->instructions.push_back(instr);
-        }
-    }
-
 }
 
 
@@ -1595,553 +614,304 @@ void IRGenerator::deadCodeElimination() {
  * - 标签和函数边界指令
  * - 参数传递指令
  */
-bool IRGenerator::isSideEffectInstr(const std::shared_ptr<IRInstr>& instr) {
-    return
-        std::dynamic_pointer_cast<CallInstr>(instr) != nullptr ||               // 函数调用
-        std::dynamic_pointer_cast<ReturnInstr>(instr) != nullptr ||             // 返回指令
-        std::dynamic_pointer_cast<GotoInstr>(instr) != nullptr ||               // 无条件跳转
-        std::dynamic_pointer_cast<IfGotoInstr>(instr) != nullptr ||             // 条件跳转
-        std::dynamic_pointer_cast<LabelInstr>(instr) != nullptr ||              // 标签
-        std::dynamic_pointer_cast<FunctionBeginInstr>(instr) != nullptr ||      // 函数开始
-        std::dynamic_pointer_cast<FunctionEndInstr>(instr) != nullptr ||        // 函数结束
-        std::dynamic_pointer_cast<ParamInstr>(instr) != nullptr;                // 参数传递
-}
-
-// 复制传播优化实现
-// 复制传播状态类型：变量到变量的映射
-//using CopyMap = std::unordered_map<std::string, std::string>;
-using CopyMap = std::map<std::string, std::string>;
-
-// 稳定比较函数
-bool copyMapEqual(const CopyMap& a, const CopyMap& b) {
-    if (a.size() != b.size()) return false;
-    for (auto itA = a.begin(), itB = b.begin(); itA != a.end(); ++itA, ++itB) {
-        if (itA->first != itB->first || itA->second != itB->second) return false;
-    }
-    return true;
-}
-
-
-// 合并两个 CopyMap：求交集，只有两边相同映射保留
-CopyMap meetCopyMaps(const CopyMap& a, const CopyMap& b) {
-    CopyMap result;
-    for (auto& [var, mappedVar] : a) {
-        auto it = b.find(var);
-        if (it != b.end() && it->second == mappedVar) {
-            result[var] = mappedVar;
-        }
+bool IRGenerator::isSideEffectInstr(const IRInstr* instr) {
+    switch (instr->opcode) {
+        case OpCode::CALL:              // 函数调用
+        case OpCode::RETURN:            // 返回指令
+        case OpCode::GOTO:              // 无条件跳转
+        case OpCode::IF_GOTO:           // 条件跳转
+        case OpCode::LABEL:             // 标签
+        case OpCode::FUNCTION_BEGIN:    // 函数开始
+        case OpCode::FUNCTION_END:      // 函数结束
+        case OpCode::PARAM:             // 参数传递
+            return true;
+        default:
+            return false;
     }
-    return result;
 }
 
-// 迁移函数：根据指令更新 CopyMap
-/*void applyCopyTransfer(CopyMap& env, const std::shared_ptr<IRInstr>& instr) {
-
-    // 简化：只处理简单赋值 instr: x = y
-    if (auto assign = std::dynamic_pointer_cast<AssignInstr>(instr)) {
-        auto defVar = assign->target->name;
-        // 如果赋值是简单复制
-        if (assign->isSimpleCopy()) { // 你需要实现判断是否简单复制的接口，比如源操作数是变量而非常量表达式
-            auto srcVar = assign->source->name;
-            env[defVar] = srcVar;
-        } else {
-            // 非复制赋值，变量重新定义，去除之前映射
-            env.erase(defVar);
-            // 这里简化不处理映射链中其他变量映射到defVar的情况
-        }
-    } else {
-        // 其它指令可能定义变量，需删除对应映射
-        auto defs = IRAnalyzer::getDefinedVariables(instr);
-        for (auto& d : defs) {
-            env.erase(d);
-        }
-    }
-}*/
-void applyCopyTransfer(CopyMap& env, const std::shared_ptr<IRInstr>& instr) {
-    if (auto assign = std::dynamic_pointer_cast<AssignInstr>(instr)) {
-        auto defVar = assign->target->name;
-
-        if (assign->isSimpleCopy()) {
-            auto srcVar = assign->source->name;
-
-            // 1. 删除所有映射中指向 defVar 的条目（防止旧映射失效后残留）
-            for (auto it = env.begin(); it != env.end(); ) {
-                if (it->second == defVar) {
-                    it = env.erase(it);
-                } else {
-                    ++it;
-                }
-            }
-
-            // 2. 检查是否会产生映射环（比如 srcVar 最终映射回 defVar）
-            /*std::string cur = srcVar;
-            while (env.find(cur) != env.end()) {
-                cur = env[cur];
-                if (cur == defVar) {
-                    // 发现环路，不能建立映射，直接清理 defVar
-                    env.erase(defVar);
-                    return;
-                }
-            }*/
-            // === 修改点1：映射环检测改用访问集合防止死循环 ===
-            std::unordered_set<std::string> visited;   // 记录访问过的变量
-            std::string cur = srcVar;
-            while (env.find(cur) != env.end()) {
-                if (visited.count(cur)) {
-                    // 访问过，检测到环，停止查找，防止死循环
-                    break;
-                }
-                visited.insert(cur);
-
-                cur = env[cur];
-                if (cur == defVar) {
-                    // 发现环路，不能建立映射，直接清理 defVar 映射，返回
-                    env.erase(defVar);
-                    return;
-                }
-            }
-
-            // 3. 更新映射
-            env[defVar] = srcVar;
-        } else {
-            // 非简单复制，变量重新定义，删除 defVar 及指向 defVar 的映射
-            env.erase(defVar);
-            for (auto it = env.begin(); it != env.end(); ) {
-                if (it->second == defVar) {
-                    it = env.erase(it);
-                } else {
-                    ++it;
-                }
-            }
-        }
-    } else {
-        // 对于其它指令，删除所有定义变量对应的映射以及指向它们的映射
-        auto defs = IRAnalyzer::getDefinedVariables(instr);
-        for (auto& d : defs) {
-            env.erase(d);
-            for (auto it = env.begin(); it != env.end(); ) {
-                if (it->second == d) {
-                    it = env.erase(it);
-                } else {
-                    ++it;
-                }
+// 复制传播优化实现
+// 复制传播状态类型：变量到变量的映射，按变量编号索引，kNoOperand 表示没有映射。
+// 映射总是直接指向复制链的源头（被指向的变量自身没有映射），所以不会出现链和环
+using CopyMap = std::vector<OperandId>;
+
+// 沿块内指令更新 CopyMap 的迁移函数。
+// 另外把映射按源头串成链表，变量被重新定义时只访问指向它的映射，不扫描整张表；
+// 映射改变后留在旧链表中的结点在访问时跳过，每个结点至多被访问一次
+class CopyTransfer {
+private:
+    static constexpr uint32_t kEnd = UINT32_MAX;
+
+    CopyMap* env = nullptr;
+    std::vector<uint32_t> head;                             // 源头 -> 链表的第一个结点
+    std::vector<std::pair<OperandId, uint32_t>> nodes;      // （映射到该源头的变量，下一个结点）
+
+    void link(OperandId var, OperandId root) {
+        nodes.emplace_back(var, head[root]);
+        head[root] = static_cast<uint32_t>(nodes.size() - 1);
+    }
+
+public:
+    explicit CopyTransfer(size_t varCount) : head(varCount, kEnd) {}
+
+    // 以 map 为块入口的复制关系开始扫描一个块，之后 apply 就地更新 map
+    void start(CopyMap& map) {
+        env = &map;
+        nodes.clear();
+        std::fill(head.begin(), head.end(), kEnd);
+        for (OperandId var = 0; var < map.size(); ++var) {
+            if (map[var] != kNoOperand) link(var, map[var]);
+        }
+    }
+
+    void apply(const IRInstr* instr) {
+        const Operand* def = defOperand(instr);
+        if (!def) return;
+        CopyMap& map = *env;
+        OperandId defVar = def->id;
+
+        // 变量重新定义：删除 defVar 的映射及指向 defVar 的映射
+        map[defVar] = kNoOperand;
+        for (uint32_t node = head[defVar]; node != kEnd; node = nodes[node].second) {
+            OperandId var = nodes[node].first;
+            if (map[var] == defVar) map[var] = kNoOperand;
+        }
+        head[defVar] = kEnd;
+
+        // 简单复制 defVar = srcVar：映射到 srcVar 的源头；源头就是 defVar 自己时（如 x = x）不记录
+        auto assign = instrCast<AssignInstr>(instr);
+        if (assign && assign->isSimpleCopy()) {
+            OperandId srcVar = assign->source.id;
+            OperandId root = map[srcVar] != kNoOperand ? map[srcVar] : srcVar;
+            if (root != defVar) {
+                map[defVar] = root;
+                link(defVar, root);
             }
         }
     }
-}
+};
 
 
 // 替换指令中使用变量，根据 CopyMap 做替换
-void replaceCopyUses(std::shared_ptr<IRInstr>& instr, const CopyMap& env) {
-    // 遍历指令所有使用变量，替换成映射变量（递归替换直到不变）
-    auto uses = IRAnalyzer::getUsedVariables(instr);
-    for (auto& useVar : uses) {
-        std::string cur = useVar;
-        while (env.find(cur) != env.end()) {
-            cur = env.at(cur);
-        }
-        IRAnalyzer::replaceUsedVariable(instr, useVar, cur);
-    }
-}
-
-// 在给定指令 instr 中，将所有使用的变量名 useVar 替换为新的变量名 cur
-void IRAnalyzer::replaceUsedVariable(std::shared_ptr<IRInstr>& instr, 
-    const std::string& oldVar, 
-    const std::string& newVar) 
-{
-
-    // 1. 赋值指令
-    if (auto assign = std::dynamic_pointer_cast<AssignInstr>(instr)) {
-        if (assign->source->type == OperandType::VARIABLE || assign->source->type == OperandType::TEMP) {
-            if (assign->source->name == oldVar) {
-                assign->source->name = newVar;
-            }
-        }
-    }
-    // 2. 二元运算指令
-    else if (auto binOp = std::dynamic_pointer_cast<BinaryOpInstr>(instr)) {
-        if ((binOp->left->type == OperandType::VARIABLE || binOp->left->type == OperandType::TEMP) &&
-        binOp->left->name == oldVar) {
-            binOp->left->name = newVar;
-        }
-        if ((binOp->right->type == OperandType::VARIABLE || binOp->right->type == OperandType::TEMP) &&
-        binOp->right->name == oldVar) {
-            binOp->right->name = newVar;
-        }
-    }
-    // 3. 一元运算指令
-    else if (auto unaryOp = std::dynamic_pointer_cast<UnaryOpInstr>(instr)) {
-        if ((unaryOp->operand->type == OperandType::VARIABLE || unaryOp->operand->type == OperandType::TEMP) &&
-        unaryOp->operand->name == oldVar) {
-            unaryOp->operand->name = newVar;
-        }
-    }
-    // 4. 参数传递指令
-    else if (auto paramInstr = std::dynamic_pointer_cast<ParamInstr>(instr)) {
-        if ((paramInstr->param->type == OperandType::VARIABLE || paramInstr->param->type == OperandType::TEMP) &&
-        paramInstr->param->name == oldVar) {
-            paramInstr->param->name = newVar;
-        }
-    }
-    // 5. 函数调用指令
-    else if (auto callInstr = std::dynamic_pointer_cast<CallInstr>(instr)) {
-        for (auto& arg : callInstr->params) {
-            if ((arg->type == OperandType::VARIABLE || arg->type == OperandType::TEMP) &&
-            arg->name == oldVar) {
-                arg->name = newVar;
-            }
-        }
-    }
-    // 6. 条件跳转指令
-    else if (auto ifg = std::dynamic_pointer_cast<IfGotoInstr>(instr)) {
-        if ((ifg->condition->type == OperandType::VARIABLE || ifg->condition->type == OperandType::TEMP) &&
-        ifg->condition->name == oldVar) {
-            ifg->condition->name = newVar;
-        }
-    }
-    // 7. 返回指令
-    else if (auto retInstr = std::dynamic_pointer_cast<ReturnInstr>(instr)) {
-        if (retInstr->value && (retInstr->value->type == OperandType::VARIABLE || retInstr->value->type == OperandType::TEMP) &&
-        retInstr->value->name == oldVar) {
-            retInstr->value->name = newVar;
+void replaceCopyUses(IRInstr* instr, const CopyMap& env) {
+    // 就地把每个使用的变量替换成它复制自的源头变量
+    forEachUseOperand(instr, [&](Operand& use) {
+        if (env[use.id] != kNoOperand) {
+            use.id = env[use.id];
         }
-    }
+    });
 }
 
-// ---------- 构建基本块（仅用标签划分） ----------
-std::vector<std::shared_ptr<IRGenerator::BasicBlock>> IRGenerator::buildBasicBlocksByLabel() {
-    std::vector<std::shared_ptr<BasicBlock>> blocks;    // 存储生成的基本块
-    const auto& instrs = this->instructions; 
-
-    // 1. 收集所有标签指令的索引
-    std::vector<int> labelIndices;
-    for (int i = 0; i < (int)instrs.size(); ++i) {
-        if (std::dynamic_pointer_cast<LabelInstr>(instrs[i])) {
-            labelIndices.push_back(i);
-        }
-    }
+// 复制传播的数据流问题：前向，只保留所有前驱上都成立的复制关系
+struct CopyPropagationProblem {
+    using Value = CopyMap;
+    static constexpr DataflowDirection direction = DataflowDirection::Forward;
 
-    // 2. 如果没有标签，强制第0条指令作为起点
-    if (labelIndices.empty() && !instrs.empty()) {
-        labelIndices.push_back(0);
-    }
+    size_t varCount;
+    mutable CopyTransfer copies;    // 迁移函数的工作区，各块共用
 
-    // 3. 根据标签划分基本块
-    for (int i = 0; i < (int)labelIndices.size(); ++i) {
-        int start = labelIndices[i];
-        int end = (i + 1 < (int)labelIndices.size()) ? labelIndices[i+1] - 1 : (int)instrs.size() - 1;
+    explicit CopyPropagationProblem(size_t varCount) : varCount(varCount), copies(varCount) {}
 
-        auto block = std::make_shared<BasicBlock>();
-        block->id = (int)blocks.size();
+    // 函数入口没有复制关系
+    Value boundary() const { return CopyMap(varCount, kNoOperand); }
 
-        for (int k = start; k <= end; ++k) {
-            block->instructions.push_back(instrs[k]);
+    // 求交集：只有两边相同的映射保留
+    void meet(Value& into, const Value& other) const {
+        for (size_t var = 0; var < into.size(); ++var) {
+            if (into[var] != other[var]) into[var] = kNoOperand;
         }
+    }
 
-        // 块第一条指令必为标签
-        auto lbl = std::dynamic_pointer_cast<LabelInstr>(block->instructions.front());
-        if (lbl) {
-            block->label = lbl->label;
-        } else {
-            // 如果第一条不是标签，生成新标签并插入
-            std::string newLabel = "__block" + std::to_string(block->id);
-            auto lblInstr = std::make_shared<LabelInstr>(newLabel);
-            block->instructions.insert(block->instructions.begin(), lblInstr);
-            block->label = newLabel;
+    void transfer(const BasicBlock& block, const Value& in, Value& out) const {
+        out = in;
+        copies.start(out);
+        for (auto& instr : block.instructions) {
+            copies.apply(instr);   // 每条指令更新拷贝关系
         }
-
-        blocks.push_back(block);
     }
-
-    return blocks;
-}
-
+};
 
 
 /**
  * 执行基于控制流图(CFG)的复制传播优化(Copy Propagation)
  * 算法步骤：
- * 1. 构建基本块和控制流图(CFG)
- * 2. 使用worklist算法迭代计算每个基本块的in/out拷贝映射
+ * 1. 使用函数的基本块和控制流图(CFG)
+ * 2. 用数据流求解器计算每个基本块入口处的拷贝映射
  * 3. 根据计算结果替换指令中的变量引用
  */
-void IRGenerator::copyPropagationCFG() {
-    // ========== Step 1: 构建CFG ==========
-    //auto blocks = buildBasicBlocksByLabel();
-    auto blocks = buildBasicBlocks();
-    buildCFG(blocks);
+void IRGenerator::copyPropagationCFG(IRFunction& func) {
+    // ========== Step 1: 使用函数的CFG ==========
+    auto& blocks = func.blocks;
 
     int n = (int)blocks.size();
     if (n == 0) return;
 
-    // ========== Step 2: 构建CFG的快速访问结构 ==========
-    std::unordered_map<int, std::vector<int>> cfg;  // blockID -> successorIDs
-    for (auto& b : blocks) {
-        std::vector<int> succIds;
-        for (auto& s : b->successors) {
-            succIds.push_back(s->id);   // 记录后继块ID
-        }
-        cfg[b->id] = std::move(succIds);
-    }
-
-    // ========== Step 3: 数据流分析初始化 =========
-    std::vector<CopyMap> inMap(n), outMap(n);   // 每个块的输入/输出拷贝映射
-    std::queue<int> q;                          // worklist队列
-    std::unordered_set<int> inQueue;            // 记录已在队列中的块
-
-    q.push(0); // 假定0为入口
-    inQueue.insert(0);
-
-    // ========== Step 4: 迭代计算in/out集合 ==========
-    while (!q.empty()) {
-        int bid = q.front();
-        q.pop();
-        inQueue.erase(bid);
-        auto blk = blocks[bid];
-
-        // 计算 inMap[bid] = meet(outMap[pred])
-        if (blk->predecessors.empty()) {
-            inMap[bid].clear();
-        } else {
-            CopyMap accum;
-            bool first = true;
-            for (auto& p : blk->predecessors) {
-                if (first) {
-                    accum = outMap[p->id];  // 第一个前驱
-                    first = false;
-                } else {
-                    // meet操作：保留所有前驱共有的拷贝关系
-                    accum = meetCopyMaps(accum, outMap[p->id]);
-                }
-            }
-            inMap[bid] = accum;
-        }
-
-        // 计算 outMap[bid] = transfer(inMap[bid], instructions)
-        CopyMap outEnv = inMap[bid];    // 从inMap初始化
-        for (auto& instr : blk->instructions) {
-            applyCopyTransfer(outEnv, instr);   // 每条指令更新拷贝关系
-        }
-
-        // 如果状态改变，更新 outMap 并加入后继块
-        if (!copyMapEqual(outEnv, outMap[bid])) {
-            outMap[bid] = std::move(outEnv);
-            // 将后继块加入worklist
-            for (auto& succ : blk->successors) {
-                if (!inQueue.count(succ->id)) {
-                    q.push(succ->id);
-                    inQueue.insert(succ->id);
-                }
-            }
-        }
-    }
+    // ========== Step 2: 求每个块入口处的拷贝映射 ==========
+    const size_t varCount = names.vregCount();
+    std::vector<CopyMap> inMap = solveDataflow(func, CopyPropagationProblem(varCount)).in;
 
-    // ========== Step 5: 应用复制传播 ==========
+    // ========== Step 3: 应用复制传播 ==========
+    CopyTransfer copies(varCount);
     for (int bid = 0; bid < n; ++bid) {
-        CopyMap env = inMap[bid];   // 获取当前块的初始拷贝关系
-        auto blk = blocks[bid];
+        CopyMap& env = inMap[bid];  // 当前块的初始拷贝关系（随块内指令就地更新）
+        BasicBlock* blk = blocks[bid].get();
+        copies.start(env);
         for (auto& instr : blk->instructions) {
             replaceCopyUses(instr, env);    // 替换指令中的可传播变量
-            applyCopyTransfer(env, instr);  // 同步更新环境
+            copies.apply(instr);            // 同步更新环境
         }
     }
+}
 
-    // ========== Step 6: 重建指令序列 ==========
-    this->instructions.clear();
-    for (auto& b : blocks) {
-        for (auto& instr : b->instructions) {
-            this->instructions.push_back(instr);
-        }
+// 可用表达式分析的数据流问题：前向，表达式集合为按表达式编号索引的位向量
+struct AvailableExpressionsProblem {
+    using Value = BitVector;
+    static constexpr DataflowDirection direction = DataflowDirection::Forward;
+
+    size_t exprCount;
+    const std::vector<BitVector>& gen;  // 块内计算且之后未被杀死的表达式，按块 id 索引
+    const std::vector<BitVector>& kill; // 块内有操作数被重新定义的表达式，按块 id 索引
+
+    // 函数入口没有可用表达式
+    Value boundary() const { return BitVector(exprCount); }
+
+    // IN = ∩ OUT[pred]
+    void meet(Value& into, const Value& other) const { into.intersectWith(other); }
+
+    // OUT = GEN ∪ (IN - KILL)
+    void transfer(const BasicBlock& block, const Value& in, Value& out) const {
+        out = in;
+        out.subtract(kill[block.id]);
+        out.unionWith(gen[block.id]);
     }
-}
+};
 
 /**
  * 执行公共子表达式消除优化（Common Subexpression Elimination, CSE）
  * 算法步骤：
- * 1. 构建每个基本块的GEN和KILL集合
- * 2. 数据流分析计算IN和OUT集合
+ * 1. 给所有表达式编号，构建每个基本块的GEN和KILL集合
+ * 2. 数据流分析计算IN集合
  * 3. 替换冗余表达式
  */
 
-void IRGenerator::commonSubexpressionElimination() {
-    using ExprCoreSet = std::unordered_set<Expression, ExpressionHash>; // 无版本的表达式集合（用于数据流）
-    
+void IRGenerator::commonSubexpressionElimination(IRFunction& func) {
     // ====== 【修改1】新增：表达式值的版本化记录（仅用于替换阶段的安全校验）======
     struct ExprValue {
-        std::string var;   // 承载该表达式结果的变量名
+        OperandId var;     // 承载该表达式结果的变量编号
         int version = -1;  // 定义该变量时的版本号
     };
     // 变量 -> 当前版本号；任一“定义”都会使其版本号递增
-    std::unordered_map<std::string, int> varVersion; // 【修改1】
+    const size_t varCount = names.vregCount();
+    std::vector<int> varVersion(varCount, 0); // 【修改1】
 
-    // ====== Step 0: 构建基本块和控制流图 ======
-    auto blocks = buildBasicBlocks();
-    buildCFG(blocks);
+    // ====== Step 0: 使用函数的基本块和控制流图 ======
+    auto& blocks = func.blocks;
 
-    // 全局变量名到 Operand 指针的映射（替换时用，但需要配合版本号校验）
-    std::unordered_map<std::string, std::shared_ptr<Operand>> varToOperand;
+    // 全局变量编号到 Operand 的映射（替换时用，但需要配合版本号校验）
+    std::vector<Operand> varToOperand(varCount);
 
-    // ====== Step 1: 构建所有表达式全集（无版本） ======
-    ExprCoreSet allExprs;
-    auto norm = [](OpCode op, const std::string& a, const std::string& b) {
+    // ====== Step 1: 给所有表达式编号（无版本） ======
+    std::unordered_map<Expression, size_t, ExpressionHash> exprIndex;
+    std::vector<Expression> exprList;                       // 编号 -> 表达式
+    std::vector<std::vector<size_t>> exprsUsing(varCount);  // 变量 -> 以它为操作数的表达式编号
+    // 操作数的键：变量/临时变量取其编号，常量按值编码到高 32 位之上，二者不会冲突
+    auto operandKey = [](const Operand& op) -> uint64_t {
+        if (op.type == OperandType::CONSTANT) {
+            return (uint64_t(1) << 32) | static_cast<uint32_t>(op.value);
+        }
+        return op.id;
+    };
+    auto makeExpr = [&](const BinaryOpInstr* binOp) {
+        uint64_t a = operandKey(binOp->left), b = operandKey(binOp->right);
         // 【修改2】抽取标准化逻辑（交换律）
-        if (op == OpCode::ADD || op == OpCode::MUL) {
-            return (b < a) ? std::pair<std::string, std::string>{b, a} : std::pair<std::string, std::string>{a, b};
+        if ((binOp->opcode == OpCode::ADD || binOp->opcode == OpCode::MUL) && b < a) {
+            std::swap(a, b);
         }
-        return std::pair<std::string, std::string>{a, b};
+        return Expression{binOp->opcode, a, b};
     };
 
     for (auto& blk : blocks) {
         for (auto& instr : blk->instructions) {
-            if (auto binOp = std::dynamic_pointer_cast<BinaryOpInstr>(instr)) {
-                if (!isSideEffectInstr(instr)) {
-                    auto [lhs, rhs] = norm(binOp->opcode, binOp->left->name, binOp->right->name);
-                    allExprs.insert(Expression{binOp->opcode, lhs, rhs, false});
-                }
+            auto binOp = instrCast<BinaryOpInstr>(instr);
+            if (!binOp || isSideEffectInstr(instr)) continue;
+
+            Expression e = makeExpr(binOp);
+            if (exprIndex.emplace(e, exprList.size()).second) {
+                // 常量键永远不会被定义，不需要登记
+                if (e.lhs < varCount) exprsUsing[e.lhs].push_back(exprList.size());
+                if (e.rhs < varCount && e.rhs != e.lhs) exprsUsing[e.rhs].push_back(exprList.size());
+                exprList.push_back(e);
             }
         }
     }
+    const size_t exprCount = exprList.size();
 
     // ====== Step 2: 计算每个块的 GEN/KILL（仍然是无版本的数据流集合） ======
-    std::unordered_map<int, ExprCoreSet> genMap, killMap;
+    std::vector<BitVector> gen(blocks.size(), BitVector(exprCount)), kill(blocks.size(), BitVector(exprCount));
 
     for (auto& blk : blocks) {
-        ExprCoreSet gen;
-        std::unordered_set<std::string> definedVars;
+        BitVector& blockGen = gen[blk->id];
+        BitVector& blockKill = kill[blk->id];
 
         for (auto& instr : blk->instructions) {
-            // 统一获取定义变量
-            auto defVars = IRAnalyzer::getDefinedVariables(instr); // 【沿用你的修改2】
-            for (const auto& var : defVars) {
-                if (!var.empty()) {
-                    definedVars.insert(var);
-
-                    // 同步 varToOperand（仅作指针缓存，替换时还要校验版本）
-                    if (auto binOp = std::dynamic_pointer_cast<BinaryOpInstr>(instr)) {
-                        if (binOp->result && binOp->result->name == var)
-                            varToOperand[var] = binOp->result;
-                    } else if (auto unaryOp = std::dynamic_pointer_cast<UnaryOpInstr>(instr)) {
-                        if (unaryOp->result && unaryOp->result->name == var)
-                            varToOperand[var] = unaryOp->result;
-                    } else if (auto assignInstr = std::dynamic_pointer_cast<AssignInstr>(instr)) {
-                        if (assignInstr->target && assignInstr->target->name == var)
-                            varToOperand[var] = assignInstr->target;
-                    } else if (auto callInstr = std::dynamic_pointer_cast<CallInstr>(instr)) {
-                        if (callInstr->result && callInstr->result->name == var)
-                            varToOperand[var] = callInstr->result;
-                    }
-                }
-            }
-
             // GEN 仅包含 BinaryOpInstr
-            if (auto binOp = std::dynamic_pointer_cast<BinaryOpInstr>(instr)) {
+            if (auto binOp = instrCast<BinaryOpInstr>(instr)) {
                 if (!isSideEffectInstr(instr)) {
-                    auto [lhs, rhs] = norm(binOp->opcode, binOp->left->name, binOp->right->name);
-                    gen.insert(Expression{binOp->opcode, lhs, rhs, false});
+                    blockGen.set(exprIndex[makeExpr(binOp)]);
                 }
             }
-        }
-
-        // KILL：任一操作数被定义则被杀
-        ExprCoreSet kill;
-        for (auto& e : allExprs) {
-            if (definedVars.count(e.lhs) || definedVars.count(e.rhs))
-                kill.insert(e);
-        }
 
-        genMap[blk->id]  = std::move(gen);
-        killMap[blk->id] = std::move(kill);
-    }
-
-    // ====== Step 3: 数据流分析 IN/OUT（可用表达式，仍是无版本） ======
-    std::unordered_map<int, ExprCoreSet> inMap, outMap;
-    for (auto& blk : blocks) {
-        outMap[blk->id] = allExprs;
-        inMap[blk->id] = blk->predecessors.empty() ? ExprCoreSet{} : allExprs;
-    }
-
-    bool changed = true;
-    while (changed) {
-        changed = false;
-        for (auto& blk : blocks) {
-            int bid = blk->id;
-
-            // IN = ∩ OUT[pred]
-            ExprCoreSet inter;
-            if (!blk->predecessors.empty()) {
-                inter = outMap[blk->predecessors[0]->id];
-                for (size_t i = 1; i < blk->predecessors.size(); ++i) {
-                    ExprCoreSet temp;
-                    auto& outPred = outMap[blk->predecessors[i]->id];
-                    for (auto& e : inter)
-                        if (outPred.count(e)) temp.insert(e);
-                    inter = std::move(temp);
+            // 定义生效：任一操作数被定义的表达式被杀（包括本条指令刚算出的 x = x + 1）
+            if (const Operand* def = defOperand(instr)) {
+                for (size_t e : exprsUsing[def->id]) {
+                    blockGen.reset(e);
+                    blockKill.set(e);
                 }
-            }
-            inMap[bid] = std::move(inter);
 
-            // OUT = GEN ∪ (IN - KILL)
-            ExprCoreSet outSet = genMap[bid];
-            for (auto& e : inMap[bid])
-                if (!killMap[bid].count(e))
-                    outSet.insert(e);
-
-            if (outSet != outMap[bid]) {
-                outMap[bid] = std::move(outSet);
-                changed = true;
+                // 同步 varToOperand（仅作缓存，替换时还要校验版本）
+                varToOperand[def->id] = *def;
             }
         }
     }
 
+    // ====== Step 3: 数据流分析 IN（可用表达式，仍是无版本） ======
+    std::vector<BitVector> inMap = solveDataflow(func, AvailableExpressionsProblem{exprCount, gen, kill}).in;
+
     // ====== Step 4: 替换公共子表达式（版本号安全） ======
     for (auto& blk : blocks) {
         // 可用表达式（无版本集合）
-        ExprCoreSet available = inMap[blk->id];
+        BitVector& available = inMap[blk->id];
 
-        // 【修改3】新增：块内“表达式 -> {产出变量, 版本}”映射。
+        // 【修改3】新增：块内“表达式编号 -> {产出变量, 版本}”映射。
         // 注意：我们只信任块内出现过的定义（避免跨块版本不一致）
-        std::unordered_map<Expression, ExprValue, ExpressionHash> exprToVal; // 【修改3】
+        std::unordered_map<size_t, ExprValue> exprToVal; // 【修改3】
 
-        // 【修改4】新增：块内初始化变量版本（扫描块内出现的所有变量，初始为0）
-        // 为简洁起见，如果项目里已有符号表/活跃信息，可替换为真实初值。
-        auto initVar = [&](const std::string& v) {
-            if (!v.empty() && !varVersion.count(v)) varVersion[v] = 0;
-        };
+        // 【修改4】变量版本按编号预先初始化为0，无需逐块扫描
 
-        for (auto& instr : blk->instructions) {
-            // 预初始化出现过的变量名（use/def都初始化）
-            for (auto& u : IRAnalyzer::getUsedVariables(instr)) initVar(u);   // 【修改4】需要你已有 getUsedVariables
-            for (auto& d : IRAnalyzer::getDefinedVariables(instr)) initVar(d);
-        }
+        // 定义生效：先版本+1，再KILL依赖该变量的表达式
+        auto defineVar = [&](const Operand& def) {
+            ++varVersion[def.id]; // 【修改6】任何定义都会产生新版本
+            for (size_t dep : exprsUsing[def.id]) {
+                available.reset(dep);
+                exprToVal.erase(dep);
+            }
+            varToOperand[def.id] = def;
+        };
 
         // 按索引遍历，便于就地替换
         for (size_t i = 0; i < blk->instructions.size(); ++i) {
             auto instr = blk->instructions[i];
 
-            // 【修改5】先处理“多定义”KILL再做插入：保证顺序安全
-            // 但对当前指令，是“准备定义”，尚未生效；真正KILL放在本条指令生效时机（见下方）。
-
             // 仅对 BinaryOp 考虑CSE
-            auto binOp = std::dynamic_pointer_cast<BinaryOpInstr>(instr);
+            auto binOp = instrCast<BinaryOpInstr>(instr);
             if (!binOp || isSideEffectInstr(instr)) {
                 // 对有副作用或非二元运算，若有定义，仍需更新版本和KILL
-                auto defVars = IRAnalyzer::getDefinedVariables(instr);
-                for (const auto& defVar : defVars) {
-                    // 本条指令定义生效：先版本+1，再KILL依赖表达式
-                    ++varVersion[defVar]; // 【修改6】任何定义都会产生新版本
-                    for (auto it = available.begin(); it != available.end();) {
-                        if (it->lhs == defVar || it->rhs == defVar) {
-                            exprToVal.erase(*it);
-                            it = available.erase(it);
-                        } else ++it;
-                    }
-                }
+                if (const Operand* def = defOperand(instr)) defineVar(*def);
                 continue;
             }
 
             // 标准化表达式（无版本）
-            auto [lhs, rhs] = norm(binOp->opcode, binOp->left->name, binOp->right->name);
-            Expression e{binOp->opcode, lhs, rhs, false};
+            const size_t e = exprIndex.at(makeExpr(binOp));
 
             // 【修改7】仅当：
             //  1) e 在 available（数据流可用）
@@ -2150,68 +920,39 @@ void IRGenerator::commonSubexpressionElimination() {
             //  4) 能拿到该变量的 Operand
             // 才进行替换（避免跨块旧值/错误版本）
             bool canReplace = false;
-            std::shared_ptr<Operand> replOperand;
+            Operand replOperand;
 
-            if (available.count(e)) {
+            if (available.test(e)) {
                 auto itVal = exprToVal.find(e);
                 if (itVal != exprToVal.end()) {
                     const ExprValue& ev = itVal->second;
-                    auto itOp = varToOperand.find(ev.var);
-                    if (itOp != varToOperand.end()) {
-                        auto curVerIt = varVersion.find(ev.var);
-                        if (curVerIt != varVersion.end() && curVerIt->second == ev.version) {
-                            canReplace = true;
-                            replOperand = itOp->second;
-                        }
+                    if (!varToOperand[ev.var].isNone() && varVersion[ev.var] == ev.version) {
+                        canReplace = true;
+                        replOperand = varToOperand[ev.var];
                     }
                 }
             }
 
-            // 根据是否可替换，生成最终指令
-            const std::string defVar = binOp->result ? binOp->result->name : std::string{};
-            if (canReplace && replOperand) {
-                blk->instructions[i] = std::make_shared<AssignInstr>(binOp->result, replOperand);
-                // 即使替换也要更新版本和操作数映射
-                if (!defVar.empty()) {
-                    ++varVersion[defVar];
-                    varToOperand[defVar] = binOp->result;
-                }
-                continue;  // 跳过后续的GEN操作（因为替换为赋值不产生新表达式）
-            } else {
-                // 不替换，保留原二元运算
-                // 同时，把 e 记作“块内可复用”的值（但要在定义生效后写入版本）
-            }
+            if (binOp->result.isNone()) continue;
+            const Operand result = binOp->result;
 
-            // ===== 当前指令的“定义”生效：更新版本号 + KILL 依赖表达式 =====
-            if (!defVar.empty()) {
-                ++varVersion[defVar]; // 【修改6】定义生效 -> 版本递增
-                // KILL 所有引用 defVar 的可用表达式
-                for (auto it = available.begin(); it != available.end();) {
-                    if (it->lhs == defVar || it->rhs == defVar) {
-                        exprToVal.erase(*it);
-                        it = available.erase(it);
-                    } else ++it;
-                }
-                // 同步 varToOperand（无论替换与否）
-                //varToOperand[defVar] = (blk->instructions[i]->getResultOperand()); // 【修改8】要求这些IR类有统一接口
-                varToOperand[defVar] = (binOp->result); 
+            if (canReplace && !replOperand.isNone()) {
+                // 替换为赋值，不产生新表达式；定义照常生效
+                blk->instructions[i] = func.makeInstr<AssignInstr>(result, replOperand);
+                defineVar(result);
+                continue;
             }
 
-            // ===== 在完成“定义生效 & KILL”之后，再把当前表达式加入 available / exprToVal =====
-            // （这样就不会出现“先插入后又被KILL掉”的顺序问题）
-            if (!defVar.empty()) {
-                // 当前表达式在本位置产生的值（无论是否替换，结果都定义为 defVar）
-                exprToVal[e] = ExprValue{defVar, varVersion[defVar]}; // 【修改9】记录产出变量及其版本
-                available.insert(e);
+            // 不替换，保留原二元运算：定义生效 & KILL 之后，
+            // 若表达式未被自己的结果杀掉（如 x = x + 1），再记作块内可复用的值
+            defineVar(result);
+            const Expression& expr = exprList[e];
+            if (expr.lhs != result.id && expr.rhs != result.id) {
+                exprToVal[e] = ExprValue{result.id, varVersion[result.id]}; // 【修改9】记录产出变量及其版本
+                available.set(e);
             }
         }
     }
-
-    // ====== Step 5: 重建指令序列 ======
-    this->instructions.clear();
-    for (auto& blk : blocks)
-        for (auto& instr : blk->instructions)
-            this->instructions.push_back(instr);
 }
 
 
@@ -2224,25 +965,26 @@ void IRGenerator::commonSubexpressionElimination() {
  * 1. 删除不可达基本块
  * 2. 合并直连基本块
  * 3. 删除多余跳转
- * 4. 重新线性化指令
+ * 4. 校验CFG
+ * 块和边在原地修改，不重新构建
  */
 
 // 辅助：更新所有跳转指令目标标签，fromLabel -> toLabel
 void IRGenerator::updateJumpTargets(
-    std::vector<std::shared_ptr<BasicBlock>>& blocks,
-    const std::string& fromLabel,
-    const std::string& toLabel)
+    IRFunction& func,
+    OperandId fromLabel,
+    OperandId toLabel)
 {
-    for (auto& blk : blocks) {
+    for (auto& blk : func.blocks) {
         for (auto& instr : blk->instructions) {
-            if (auto gotoInstr = std::dynamic_pointer_cast<GotoInstr>(instr)) {
-                if (gotoInstr->target && gotoInstr->target->name == fromLabel) {
-                    gotoInstr->target->name = toLabel;
+            if (auto gotoInstr = instrCast<GotoInstr>(instr)) {
+                if (!gotoInstr->target.isNone() && gotoInstr->target.id == fromLabel) {
+                    gotoInstr->target.id = toLabel;
                 }
             }
-            if (auto ifGotoInstr = std::dynamic_pointer_cast<IfGotoInstr>(instr)) {
-                if (ifGotoInstr->target && ifGotoInstr->target->name == fromLabel) {
-                    ifGotoInstr->target->name = toLabel;
+            if (auto ifGotoInstr = instrCast<IfGotoInstr>(instr)) {
+                if (!ifGotoInstr->target.isNone() && ifGotoInstr->target.id == fromLabel) {
+                    ifGotoInstr->target.id = toLabel;
                 }
             }
         }
@@ -2250,259 +992,100 @@ void IRGenerator::updateJumpTargets(
 }
 
 // 校验 CFG 有效性，标签唯一且跳转目标存在
-bool IRGenerator::validateCFG(const std::vector<std::shared_ptr<BasicBlock>>& blocks) {
-    std::unordered_set<std::string> allLabels;
-    std::unordered_set<std::string> usedLabels;
+bool IRGenerator::validateCFG(const IRFunction& func) {
+    std::unordered_set<OperandId> allLabels;
+    std::unordered_set<OperandId> usedLabels;
 
-    for (const auto& blk : blocks) {
+    for (const auto& blk : func.blocks) {
         if (blk->instructions.empty()) continue;
-        // 基本块首指令必须是标签
-        auto firstInstr = blk->instructions.front();
-        auto labelInstr = std::dynamic_pointer_cast<LabelInstr>(firstInstr);
-        if (!labelInstr) {
-            std::cerr << "Error: BasicBlock missing starting LabelInstr\n";
-            return false;
-        }
-        // 标签唯一
-        if (allLabels.count(labelInstr->label)) {
-            std::cerr << "Error: Duplicate label: " << labelInstr->label << "\n";
-            return false;
+        // 带标签的块，标签必须唯一（函数开头和调用之后的块可以没有标签）
+        if (blk->label != kNoOperand) {
+            if (allLabels.count(blk->label)) {
+                std::cerr << "Error: Duplicate label: " << names.labelName(blk->label) << "\n";
+                return false;
+            }
+            allLabels.insert(blk->label);
         }
-        allLabels.insert(labelInstr->label);
 
         // 收集跳转目标
         for (const auto& instr : blk->instructions) {
-            if (auto g = std::dynamic_pointer_cast<GotoInstr>(instr)) {
-                if (g->target) usedLabels.insert(g->target->name);
+            if (auto g = instrCast<GotoInstr>(instr)) {
+                if (!g->target.isNone()) usedLabels.insert(g->target.id);
             }
-            if (auto ig = std::dynamic_pointer_cast<IfGotoInstr>(instr)) {
-                if (ig->target) usedLabels.insert(ig->target->name);
+            if (auto ig = instrCast<IfGotoInstr>(instr)) {
+                if (!ig->target.isNone()) usedLabels.insert(ig->target.id);
             }
         }
     }
 
     // 检查跳转目标是否都存在
-    for (const auto& label : usedLabels) {
+    for (auto label : usedLabels) {
         if (!allLabels.count(label)) {
-            std::cerr << "Error: Jump target label not found: " << label << "\n";
+            std::cerr << "Error: Jump target label not found: " << names.labelName(label) << "\n";
             return false;
         }
     }
     return true;
 }
 
-void IRGenerator::controlFlowOptimization() {
-    // 构建基本块和CFG
-    auto blocks = buildBasicBlocks();
-    buildCFG(blocks);
+void IRGenerator::controlFlowOptimization(IRFunction& func) {
+    auto& blocks = func.blocks;
     if (blocks.empty()) return;
 
     // Step 1: 删除不可达基本块
-    std::unordered_set<std::shared_ptr<BasicBlock>> reachable;      // 存储可达块
-    std::unordered_set<std::shared_ptr<BasicBlock>> inProgress;                     // 存储正在处理的块，用于检测循环
-
-    /*std::function<void(std::shared_ptr<BasicBlock>)> dfs =
-        [&](std::shared_ptr<BasicBlock> blk) {
-            if (!blk || reachable.count(blk)) return;
-            reachable.insert(blk);
-            for (auto& succ : blk->successors) {
-                dfs(succ);
-            }
-        };*/
-
-    // 使用安全的DFS遍历，避免循环导致的无限递归
-    std::function<void(std::shared_ptr<BasicBlock>)> dfs = [&](std::shared_ptr<BasicBlock> blk) {
-        if (!blk || reachable.count(blk)) return;  // 已访问的块直接返回
-    
-        // 检测是否在当前DFS路径上（循环检测）
-        if (inProgress.count(blk)) return;         // 如果当前块正在处理中，直接返回
-    
-        inProgress.insert(blk);                    // 标记当前块为处理中
-        reachable.insert(blk);                     // 标记当前块为可达
-    
-        // 递归处理所有后继块
-        for (auto succ : blk->successors) {
-            dfs(succ);
-        }
-    
-        inProgress.erase(blk);                     // 处理完成，从处理中集合移除
-    };
-
-
-    // 寻找程序入口
-    std::shared_ptr<BasicBlock> entry = nullptr;
-
-    for (auto& blk : blocks) {
-        for (auto& ins : blk->instructions) {
-            if (auto funcInstr = std::dynamic_pointer_cast<FunctionBeginInstr>(ins)) {
-                if (funcInstr->funcName == "main") { 
-                    entry = blk;
-                    goto found; // 直接跳出双层循环
-                }
-            }
-        }
-    }
-
-    found:
-    if (!entry) {
-        throw std::runtime_error("入口块 'main' 未找到");
-    }
-
-    dfs(entry);
-
-    // 过滤不可达块
-    std::vector<std::shared_ptr<BasicBlock>> newBlocks;
-    for (auto& blk : blocks) {
-        if (reachable.count(blk)) newBlocks.push_back(blk);
-    }
-    blocks.swap(newBlocks);
-
-
-    // Step 2: 合并直连基本块
-    std::unordered_set<std::shared_ptr<BasicBlock>> toRemove;
-
+    removeUnreachableBlocks(func);
+
+    // Step 2: 合并直连基本块：块以 goto 结尾，且目标块只有它一个前驱
+    std::vector<bool> dead(blocks.size());
+    for (auto& blkPtr : blocks) {
+        BasicBlock* blk = blkPtr.get();
+        if (dead[blk->id] || blk->instructions.empty()) continue;
+        if (!instrCast<GotoInstr>(blk->instructions.back())) continue;
+        if (blk->successors.size() != 1) continue;
+
+        BasicBlock* target = blk->successors[0];
+        if (target == blk || target == func.entry() || target == blocks.back().get()) continue;
+        if (target->predecessors.size() != 1) continue;
+
+        // 目标块若顺序流入下一块，合并后就失去了这条隐式的边；只有它紧跟在当前块之后时才能合并
+        auto& last = target->instructions.back();
+        bool fallsThrough = !instrCast<GotoInstr>(last) &&
+                            !instrCast<ReturnInstr>(last);
+        if (fallsThrough && func.nextBlock(blk) != target) continue;
+
+        // 删除当前块尾部的 goto；目标块只有一个前驱，不会有其它跳转引用它的标签，标签一并删除
+        blk->instructions.pop_back();
+        auto first = target->instructions.begin();
+        if (instrCast<LabelInstr>(*first)) ++first;
+        blk->instructions.insert(blk->instructions.end(), first, target->instructions.end());
+        target->instructions.clear();
+
+        // 目标块的出边转移到当前块
+        IRFunction::removeEdge(blk, target);
+        std::vector<BasicBlock*> succs = target->successors;
+        for (auto succ : succs) {
+            IRFunction::removeEdge(target, succ);
+            IRFunction::addEdge(blk, succ);
+        }
+        dead[target->id] = true;
+    }
+    func.removeBlocks(dead);
+
+    // Step 3: 删除跳到下一块的多余 goto，控制流边不变（改为顺序流入）
     for (auto& blk : blocks) {
         if (blk->instructions.empty()) continue;
+        auto gotoInstr = instrCast<GotoInstr>(blk->instructions.back());
+        if (!gotoInstr) continue;
 
-        // 必须保证第一个指令是标签
-        auto firstInstr = blk->instructions.front();
-        auto blkLabelInstr = std::dynamic_pointer_cast<LabelInstr>(firstInstr);
-        if (!blkLabelInstr) continue; // 【修改点】跳过无标签块，确保标签存在
-
-        // 检查最后一条是否为goto
-        if (auto gotoInstr = std::dynamic_pointer_cast<GotoInstr>(blk->instructions.back())) {
-            if (blk->successors.size() != 1) continue;
-            auto target = blk->successors[0];
-            if (!target || target->instructions.empty()) continue;
-
-            // 目标块必须只有一个前驱（即当前块）
-            if (target->predecessors.size() != 1 || target->predecessors[0] != blk) continue;
-
-            // 目标块第一个指令必须是标签
-            auto targetLabelInstr = std::dynamic_pointer_cast<LabelInstr>(target->instructions.front());
-            if (!targetLabelInstr) continue;
-
-            // 【修改点】合并块前先记录标签名
-            std::string blkLabel = blkLabelInstr->label;
-            std::string targetLabel = targetLabelInstr->label;
-
-            // 【修改点】合并时删除当前块尾部goto
+        BasicBlock* next = func.nextBlock(blk.get());
+        if (next && next->label == gotoInstr->target.id) {
             blk->instructions.pop_back();
-
-            // 【修改点】删除目标块标签指令（保持块唯一标签）
-            target->instructions.erase(target->instructions.begin());
-
-            // 合并目标块剩余指令
-            blk->instructions.insert(
-                blk->instructions.end(),
-                target->instructions.begin(),
-                target->instructions.end()
-            );
-
-            // 更新CFG successors
-            blk->successors = target->successors;
-
-            // 更新目标块后继的predecessors指向当前块
-            for (auto& succ : target->successors) {
-                for (auto& pred : succ->predecessors) {
-                    if (pred == target) {
-                        pred = blk;
-                    }
-                }
-            }
-
-            // 【修改点】更新所有跳转指令指向目标标签的，改为指向当前块标签
-            updateJumpTargets(blocks, targetLabel, blkLabel);
-
-            toRemove.insert(target);
-        }
-    }
-
-    // 删除合并块
-    blocks.erase(
-        std::remove_if(blocks.begin(), blocks.end(),
-            [&](const std::shared_ptr<BasicBlock>& b) { return toRemove.count(b); }),
-        blocks.end()
-    );
-
-    // Step 3: 删除多余跳转，且同步更新 successors
-    for (size_t i = 0; i + 1 < blocks.size(); ++i) {
-        auto& blk = blocks[i];
-        if (blk->instructions.empty()) continue;
-
-        if (auto gotoInstr = std::dynamic_pointer_cast<GotoInstr>(blk->instructions.back())) {
-            auto& nextBlk = blocks[i + 1];
-            if (nextBlk->instructions.empty()) continue;
-
-            auto labelInstr = std::dynamic_pointer_cast<LabelInstr>(nextBlk->instructions.front());
-            if (!labelInstr) continue;
-
-            if (gotoInstr->target && gotoInstr->target->name == labelInstr->label) {
-                // 删除跳转指令
-                blk->instructions.pop_back();
-
-                // 【修改点】同步删除 successors 中的 nextBlk
-                blk->successors.erase(
-                    std::remove(blk->successors.begin(), blk->successors.end(), nextBlk),
-                    blk->successors.end()
-                );
-            }
         }
     }
 
-    // Step 4: 重新线性化指令，优先fall-through后继
-    instructions.clear();   // 清空最终的指令序列，准备重新生成
-    for (auto& block : blocks) {
-        instructions.insert(instructions.end(), block->instructions.begin(), block->instructions.end());
-    }
-    /*std::unordered_set<std::shared_ptr<BasicBlock>> visited;
-
-    // 定义深度优先搜索（DFS）函数，用于线性化基本块
-    std::function<void(std::shared_ptr<BasicBlock>)> dfsLinearize = [&](std::shared_ptr<BasicBlock> blk) {
-        // 如果基本块为空或已访问过，直接返回
-        if (!blk || visited.count(blk)) return;
-
-        // 标记当前基本块为已访问
-        visited.insert(blk);
-
-        // 将当前基本块的所有指令追加到最终的指令序列中
-        instructions.insert(instructions.end(), blk->instructions.begin(), blk->instructions.end());
-
-        // 找fall-through后继（非跳转目标）
-        std::shared_ptr<BasicBlock> fallthrough = nullptr;
-        if (!blk->instructions.empty()) {
-            auto lastInstr = blk->instructions.back();  // 获取最后一条指令
-
-            // 如果是 `Goto` 或 `Return`，则没有 fall-through
-            if (std::dynamic_pointer_cast<GotoInstr>(lastInstr) || std::dynamic_pointer_cast<ReturnInstr>(lastInstr)) {
-                fallthrough = nullptr; // 无fall-through
-            } 
-            // 如果是 `IfGoto`（条件跳转），则 fall-through 是第二个后继（false 分支）
-            else if (auto ifGoto = std::dynamic_pointer_cast<IfGotoInstr>(lastInstr)) {
-                if (blk->successors.size() > 1) fallthrough = blk->successors[1];
-            } 
-            // 其他情况（普通指令），fall-through 是唯一后继（如果有的话）
-            else {
-                if (blk->successors.size() == 1) fallthrough = blk->successors[0];
-            }
-        }
-
-        // 优先处理 fall-through 后继（保证顺序执行）
-        if (fallthrough) dfsLinearize(fallthrough);
-
-        // 处理其他后继（跳转目标）
-        for (auto& succ : blk->successors) {
-            if (succ != fallthrough) dfsLinearize(succ);
-        }
-    };
-
-    // 从入口基本块开始线性化
-    dfsLinearize(entry);*/
-
-    // Step 5: 最后校验CFG有效性，避免标签或跳转错误
-    if (!validateCFG(blocks)) {
+    // Step 4: 最后校验CFG有效性，避免标签或跳转错误
+    if (!validateCFG(func)) {
         std::cerr << "Error: CFG validation failed after controlFlowOptimization\n";
-        // 这里可考虑回滚或抛异常
     }
 }
 
@@ -2526,7 +1109,7 @@ void IRGenerator::controlFlowOptimization() {
  * @param expr 数字表达式
  */
 void IRGenerator::visit(NumberExpr& expr) {
-    std::shared_ptr<Operand> constant = std::make_shared<Operand>(expr.value);
+    Operand constant = Operand(expr.value);
     operandStack.push_back(constant);
 }
 
@@ -2538,11 +1121,22 @@ void IRGenerator::visit(NumberExpr& expr) {
  * @param expr 变量表达式
  */
 void IRGenerator::visit(VariableExpr& expr) {
-    std::shared_ptr<Operand> var = getVariable(expr.name);
-    if (!var) return; // 错误已输出
+    Operand var = getVariable(expr.name);
+    if (var.isNone()) return; // 错误已输出
     operandStack.push_back(var);
 }
 
+// 二元运算符到IR操作码的映射表，按 BinOp 的枚举顺序排列
+static constexpr OpCode kBinOpCodes[] = {
+    OpCode::MUL, OpCode::DIV, OpCode::MOD,
+    OpCode::ADD, OpCode::SUB,
+    OpCode::LT, OpCode::GT, OpCode::LE, OpCode::GE, OpCode::EQ, OpCode::NE,
+    OpCode::AND,
+    OpCode::OR
+};
+static_assert(sizeof(kBinOpCodes) / sizeof(kBinOpCodes[0]) == static_cast<size_t>(BinOp::Or) + 1,
+              "kBinOpCodes must cover every BinOp");
+
 /**
  * 访问二元表达式。
  * 
@@ -2552,44 +1146,27 @@ void IRGenerator::visit(VariableExpr& expr) {
  */
 void IRGenerator::visit(BinaryExpr& expr) {
     // 处理逻辑运算符的短路求值
-    if (expr.op == "&&") {
+    if (expr.op == BinOp::And) {
         auto result = generateShortCircuitAnd(expr);
         operandStack.push_back(result);
         return;
-    } else if (expr.op == "||") {
+    } else if (expr.op == BinOp::Or) {
         auto result = generateShortCircuitOr(expr);
         operandStack.push_back(result);
         return;
     }
     // 正常二元表达式求值
-    expr.right->accept(*this);
-    std::shared_ptr<Operand> right = getTopOperand();
+    dispatch(*expr.right);
+    Operand right = getTopOperand();
     
-    expr.left->accept(*this);
-    std::shared_ptr<Operand> left = getTopOperand();
+    dispatch(*expr.left);
+    Operand left = getTopOperand();
     
-    std::shared_ptr<Operand> result = createTemp();
-    // 将运算符字符串映射到操作码
-    OpCode opcode;
-    if (expr.op == "+") opcode = OpCode::ADD;
-    else if (expr.op == "-") opcode = OpCode::SUB;
-    else if (expr.op == "*") opcode = OpCode::MUL;
-    else if (expr.op == "/") opcode = OpCode::DIV;
-    else if (expr.op == "%") opcode = OpCode::MOD;
-    else if (expr.op == "<") opcode = OpCode::LT;
-    else if (expr.op == ">") opcode = OpCode::GT;
-    else if (expr.op == "<=") opcode = OpCode::LE;
-    else if (expr.op == ">=") opcode = OpCode::GE;
-    else if (expr.op == "==") opcode = OpCode::EQ;
-    else if (expr.op == "!=") opcode = OpCode::NE;
-    else if (expr.op == "&&") opcode = OpCode::AND;
-    else if (expr.op == "||") opcode = OpCode::OR;
-    else {
-        std::cerr << "Error: Unknown binary operator: " << expr.op << std::endl;
-        opcode = OpCode::ADD; // 默认使用加法
-    }
+    Operand result = createTemp();
+    // 按运算符查表得到操作码
+    OpCode opcode = kBinOpCodes[static_cast<size_t>(expr.op)];
     
-    addInstruction(std::make_shared<BinaryOpInstr>(opcode, result, left, right));
+    addInstruction(makeInstr<BinaryOpInstr>(opcode, result, left, right));
     operandStack.push_back(result);
 }
 
@@ -2602,40 +1179,40 @@ void IRGenerator::visit(BinaryExpr& expr) {
  * @param expr 二元表达式
  * @return 结果操作数
  */
-std::shared_ptr<Operand> IRGenerator::generateShortCircuitAnd(BinaryExpr& expr) {
+Operand IRGenerator::generateShortCircuitAnd(BinaryExpr& expr) {
     // 评估左操作数
-    expr.left->accept(*this);
-    std::shared_ptr<Operand> left = getTopOperand();
+    dispatch(*expr.left);
+    Operand left = getTopOperand();
 
     // 创建结果临时变量和短路标签
-    std::shared_ptr<Operand> result = createTemp();
-    std::shared_ptr<Operand> shortCircuitLabel = createLabel();
-    std::shared_ptr<Operand> endLabel = createLabel();
+    Operand result = createTemp();
+    Operand shortCircuitLabel = createLabel();
+    Operand endLabel = createLabel();
 
     // 如果左操作数为假（0），短路
     // 因为IfGotoInstr在条件为真时跳转，所以需要翻转条件
-    //addInstruction(std::make_shared<IfGotoInstr>(left, shortCircuitLabel));
+    //addInstruction(makeInstr<IfGotoInstr>(left, shortCircuitLabel));
     // 创建左操作数的否定
-    std::shared_ptr<Operand> notLeft = createTemp();
-    addInstruction(std::make_shared<UnaryOpInstr>(OpCode::NOT, notLeft, left));
+    Operand notLeft = createTemp();
+    addInstruction(makeInstr<UnaryOpInstr>(OpCode::NOT, notLeft, left));
 
     // 如果左操作数为假（0），短路
-    addInstruction(std::make_shared<IfGotoInstr>(notLeft, shortCircuitLabel));
+    addInstruction(makeInstr<IfGotoInstr>(notLeft, shortCircuitLabel));
 
     // 左操作数为真，评估右操作数
-    expr.right->accept(*this);
-    std::shared_ptr<Operand> right = getTopOperand();
+    dispatch(*expr.right);
+    Operand right = getTopOperand();
 
     // 结果为右操作数
-    addInstruction(std::make_shared<AssignInstr>(result, right));
-    addInstruction(std::make_shared<GotoInstr>(endLabel));
+    addInstruction(makeInstr<AssignInstr>(result, right));
+    addInstruction(makeInstr<GotoInstr>(endLabel));
 
     // 短路：结果为假（0）
-    addInstruction(std::make_shared<LabelInstr>(shortCircuitLabel->name));
-    addInstruction(std::make_shared<AssignInstr>(result, std::make_shared<Operand>(0)));
+    addInstruction(makeInstr<LabelInstr>(shortCircuitLabel.id));
+    addInstruction(makeInstr<AssignInstr>(result, Operand(0)));
 
     // 结束
-    addInstruction(std::make_shared<LabelInstr>(endLabel->name));
+    addInstruction(makeInstr<LabelInstr>(endLabel.id));
     return result;
 }
 
@@ -2648,33 +1225,33 @@ std::shared_ptr<Operand> IRGenerator::generateShortCircuitAnd(BinaryExpr& expr)
  * @param expr 二元表达式
  * @return 结果操作数
  */
-std::shared_ptr<Operand> IRGenerator::generateShortCircuitOr(BinaryExpr& expr) {
+Operand IRGenerator::generateShortCircuitOr(BinaryExpr& expr) {
     // 评估左操作数
-    expr.left->accept(*this);
-    std::shared_ptr<Operand> left = getTopOperand();
+    dispatch(*expr.left);
+    Operand left = getTopOperand();
     
     // 创建结果临时变量和短路标签
-    std::shared_ptr<Operand> result = createTemp();
-    std::shared_ptr<Operand> shortCircuitLabel = createLabel();
-    std::shared_ptr<Operand> endLabel = createLabel();
+    Operand result = createTemp();
+    Operand shortCircuitLabel = createLabel();
+    Operand endLabel = createLabel();
     
     // 如果左操作数为真，短路并返回1
-    addInstruction(std::make_shared<IfGotoInstr>(left, shortCircuitLabel));
+    addInstruction(makeInstr<IfGotoInstr>(left, shortCircuitLabel));
     
     // 否则，计算右操作数
-    expr.right->accept(*this);
-    std::shared_ptr<Operand> right = getTopOperand();
+    dispatch(*expr.right);
+    Operand right = getTopOperand();
     
     // 结果等于右操作数
-    addInstruction(std::make_shared<AssignInstr>(result, right));
-    addInstruction(std::make_shared<GotoInstr>(endLabel));
+    addInstruction(makeInstr<AssignInstr>(result, right));
+    addInstruction(makeInstr<GotoInstr>(endLabel));
     
     // 短路处理：结果为1
-    addInstruction(std::make_shared<LabelInstr>(shortCircuitLabel->name));
-    addInstruction(std::make_shared<AssignInstr>(result, std::make_shared<Operand>(1)));
+    addInstruction(makeInstr<LabelInstr>(shortCircuitLabel.id));
+    addInstruction(makeInstr<AssignInstr>(result, Operand(1)));
     
     // 结束标签
-    addInstruction(std::make_shared<LabelInstr>(endLabel->name));
+    addInstruction(makeInstr<LabelInstr>(endLabel.id));
     
     return result;
 }
@@ -2687,25 +1264,25 @@ std::shared_ptr<Operand> IRGenerator::generateShortCircuitOr(BinaryExpr& expr) {
  * @param expr 一元表达式
  */
 void IRGenerator::visit(UnaryExpr& expr) {
-    expr.operand->accept(*this);
-    std::shared_ptr<Operand> operand = getTopOperand();
+    dispatch(*expr.operand);
+    Operand operand = getTopOperand();
     
-    std::shared_ptr<Operand> result = createTemp();
+    Operand result = createTemp();
     
     // 处理不同的一元运算符
-    if (expr.op == "-") {
-        // 取负
-        addInstruction(std::make_shared<UnaryOpInstr>(OpCode::NEG, result, operand));
-    } else if (expr.op == "!") {
-        // 逻辑非
-        addInstruction(std::make_shared<UnaryOpInstr>(OpCode::NOT, result, operand));
-    } else if (expr.op == "+") {
-        // 一元加（无效果）
-        addInstruction(std::make_shared<AssignInstr>(result, operand));
-    } else {
-        std::cerr << "错误: 未知的一元运算符: " << expr.op << std::endl;
-        // 默认为取负
-        addInstruction(std::make_shared<UnaryOpInstr>(OpCode::NEG, result, operand));
+    switch (expr.op) {
+        case UnOp::Neg:
+            // 取负
+            addInstruction(makeInstr<UnaryOpInstr>(OpCode::NEG, result, operand));
+            break;
+        case UnOp::Not:
+            // 逻辑非
+            addInstruction(makeInstr<UnaryOpInstr>(OpCode::NOT, result, operand));
+            break;
+        case UnOp::Plus:
+            // 一元加（无效果）
+            addInstruction(makeInstr<AssignInstr>(result, operand));
+            break;
     }
     
     operandStack.push_back(result);
@@ -2721,26 +1298,29 @@ void IRGenerator::visit(UnaryExpr& expr) {
  */
 void IRGenerator::visit(CallExpr& expr) {
     // 处理参数
-    std::vector<std::shared_ptr<Operand>> args;
+    std::vector<Operand> args;
     for (const auto& arg : expr.arguments) {
-        arg->accept(*this);
+        dispatch(*arg);
         args.push_back(getTopOperand());
     }
     
     // 从左到右添加参数指令（与RISC-V调用约定一致）
     for (const auto& arg : args) {
-        addInstruction(std::make_shared<ParamInstr>(arg));
+        addInstruction(makeInstr<ParamInstr>(arg));
     }
     
-    // 为结果创建临时变量
-    std::shared_ptr<Operand> result = createTemp();
+    // 为结果创建临时变量（void 函数没有返回值，不分配）
+    Operand result;
+    if (expr.type != ExprType::Void) {
+        result = createTemp();
+    }
     
     // 创建调用指令
-    auto callInstr = std::make_shared<CallInstr>(
-        result, expr.callee, expr.arguments.size());
+    auto callInstr = makeInstr<CallInstr>(
+        result, names.functionId(std::string(identifiers.spelling(expr.callee))), (int)expr.arguments.size());
     
     // 存储参数列表，便于代码生成
-    callInstr->params = args;
+    callInstr->params = irFunction->arena.copyList(args);
     
     // 调用函数
     addInstruction(callInstr);
@@ -2749,7 +1329,9 @@ void IRGenerator::visit(CallExpr& expr) {
     markFunctionAsUsed(expr.callee);
     
     // 将结果推入操作数栈
-    operandStack.push_back(result);
+    if (!result.isNone()) {
+        operandStack.push_back(result);
+    }
 }
 
 //------------------------------------------------------------------------------
@@ -2765,9 +1347,9 @@ void IRGenerator::visit(CallExpr& expr) {
  */
 void IRGenerator::visit(ExprStmt& stmt) {
     if (stmt.expression) {
-        stmt.expression->accept(*this);
-        // 表达式语句的结果会被丢弃
-        if (!operandStack.empty()) {
+        dispatch(*stmt.expression);
+        // 表达式语句的结果会被丢弃（void 调用不产生结果）
+        if (stmt.expression->type != ExprType::Void && !operandStack.empty()) {
             operandStack.pop_back();
         }
     }
@@ -2781,24 +1363,24 @@ void IRGenerator::visit(ExprStmt& stmt) {
  * @param stmt 变量声明语句
  */
 /*void IRGenerator::visit(VarDeclStmt& stmt) {
-    std::shared_ptr<Operand> var = getVariable(stmt.name);
+    Operand var = getVariable(stmt.name);
     
     if (stmt.initializer) {
-        stmt.initializer->accept(*this);
-        std::shared_ptr<Operand> value = getTopOperand();
+        dispatch(*stmt.initializer);
+        Operand value = getTopOperand();
         
-        addInstruction(std::make_shared<AssignInstr>(var, value));
+        addInstruction(makeInstr<AssignInstr>(var, value));
     }
 }*/
 void IRGenerator::visit(VarDeclStmt& stmt) {
     // 关键修改：使用 createInCurrentScope = true，强制在当前作用域创建新变量
-    std::shared_ptr<Operand> var = getVariable(stmt.name, true);
+    Operand var = getVariable(stmt.name, true);
     
     if (stmt.initializer) {
-        stmt.initializer->accept(*this);
-        std::shared_ptr<Operand> value = getTopOperand();
+        dispatch(*stmt.initializer);
+        Operand value = getTopOperand();
         
-        addInstruction(std::make_shared<AssignInstr>(var, value));
+        addInstruction(makeInstr<AssignInstr>(var, value));
     }
 }
 
@@ -2811,14 +1393,14 @@ void IRGenerator::visit(VarDeclStmt& stmt) {
  */
 void IRGenerator::visit(AssignStmt& stmt) {
     // 评估右侧
-    stmt.value->accept(*this);
-    std::shared_ptr<Operand> value = getTopOperand();
+    dispatch(*stmt.value);
+    Operand value = getTopOperand();
     
     // 获取变量
-    std::shared_ptr<Operand> var = getVariable(stmt.name);
+    Operand var = getVariable(stmt.name);
     
     // 将值赋给变量
-    addInstruction(std::make_shared<AssignInstr>(var, value));
+    addInstruction(makeInstr<AssignInstr>(var, value));
 }
 
 /**
@@ -2833,7 +1415,7 @@ void IRGenerator::visit(BlockStmt& stmt) {
     enterScope();
     
     for (const auto& s : stmt.statements) {
-        s->accept(*this);
+        dispatch(*s);
     }
     
     // 离开作用域
@@ -2849,40 +1431,40 @@ void IRGenerator::visit(BlockStmt& stmt) {
  */
 void IRGenerator::visit(IfStmt& stmt) {
     // 为else分支和结束创建标签
-    std::shared_ptr<Operand> elseLabel = createLabel();
-    std::shared_ptr<Operand> endLabel = stmt.elseBranch ? createLabel() : elseLabel;
+    Operand elseLabel = createLabel();
+    Operand endLabel = stmt.elseBranch ? createLabel() : elseLabel;
     
     // 评估条件
-    stmt.condition->accept(*this);
-    std::shared_ptr<Operand> condition = getTopOperand();
+    dispatch(*stmt.condition);
+    Operand condition = getTopOperand();
     
     // 如果条件为假，跳转到else分支
     // 注意：IfGotoInstr在条件为真时跳转，所以我们需要翻转逻辑
     // 我们想要的是：if (!condition) goto elseLabel
     // 但IfGotoInstr是：if (condition) goto target
     // 所以我们需要使用一个临时变量来存储!condition
-    std::shared_ptr<Operand> notCondition = createTemp();
-    addInstruction(std::make_shared<UnaryOpInstr>(OpCode::NOT, notCondition, condition));
-    addInstruction(std::make_shared<IfGotoInstr>(notCondition, elseLabel));
+    Operand notCondition = createTemp();
+    addInstruction(makeInstr<UnaryOpInstr>(OpCode::NOT, notCondition, condition));
+    addInstruction(makeInstr<IfGotoInstr>(notCondition, elseLabel));
     
     // 为then分支生成代码
-    stmt.thenBranch->accept(*this);
+    dispatch(*stmt.thenBranch);
     
     // 如果有else分支，在then分支之后添加跳转到结束
     if (stmt.elseBranch) {
-        addInstruction(std::make_shared<GotoInstr>(endLabel));
+        addInstruction(makeInstr<GotoInstr>(endLabel));
         
         // 添加else标签
-        addInstruction(std::make_shared<LabelInstr>(elseLabel->name));
+        addInstruction(makeInstr<LabelInstr>(elseLabel.id));
         
         // 为else分支生成代码
-        stmt.elseBranch->accept(*this);
+        dispatch(*stmt.elseBranch);
         
         // 添加结束标签
-        addInstruction(std::make_shared<LabelInstr>(endLabel->name));
+        addInstruction(makeInstr<LabelInstr>(endLabel.id));
     } else {
         // 没有else分支，只添加else/end标签
-        addInstruction(std::make_shared<LabelInstr>(elseLabel->name));
+        addInstruction(makeInstr<LabelInstr>(elseLabel.id));
     }
 }
 
@@ -2894,35 +1476,35 @@ void IRGenerator::visit(IfStmt& stmt) {
  * @param stmt while语句
  */
 void IRGenerator::visit(WhileStmt& stmt) {
-    std::shared_ptr<Operand> startLabel = createLabel();
-    std::shared_ptr<Operand> condLabel = createLabel();
-    std::shared_ptr<Operand> endLabel = createLabel();
+    Operand startLabel = createLabel();
+    Operand condLabel = createLabel();
+    Operand endLabel = createLabel();
     
     // 保存之前的break和continue标签
-    breakLabels.push_back(endLabel->name);
-    continueLabels.push_back(condLabel->name);
+    breakLabels.push_back(endLabel.id);
+    continueLabels.push_back(condLabel.id);
     
     // 跳转到条件判断
-    addInstruction(std::make_shared<GotoInstr>(condLabel));
+    addInstruction(makeInstr<GotoInstr>(condLabel));
     
     // 循环体开始标签
-    addInstruction(std::make_shared<LabelInstr>(startLabel->name));
+    addInstruction(makeInstr<LabelInstr>(startLabel.id));
     
     // 循环体
-    stmt.body->accept(*this);
+    dispatch(*stmt.body);
     
     // 条件判断标签
-    addInstruction(std::make_shared<LabelInstr>(condLabel->name));
+    addInstruction(makeInstr<LabelInstr>(condLabel.id));
     
     // 条件表达式
-    stmt.condition->accept(*this);
-    std::shared_ptr<Operand> condition = getTopOperand();
+    dispatch(*stmt.condition);
+    Operand condition = getTopOperand();
     
     // 条件为真时跳转到循环体开始
-    addInstruction(std::make_shared<IfGotoInstr>(condition, startLabel));
+    addInstruction(makeInstr<IfGotoInstr>(condition, startLabel));
     
     // 循环结束标签
-    addInstruction(std::make_shared<LabelInstr>(endLabel->name));
+    addInstruction(makeInstr<LabelInstr>(endLabel.id));
     
     // 恢复之前的break和continue标签
     breakLabels.pop_back();
@@ -2942,8 +1524,8 @@ void IRGenerator::visit(BreakStmt&) {
         return;
     }
     
-    std::shared_ptr<Operand> target = std::make_shared<Operand>(OperandType::LABEL, breakLabels.back());
-    addInstruction(std::make_shared<GotoInstr>(target));
+    Operand target = Operand(OperandType::LABEL, breakLabels.back());
+    addInstruction(makeInstr<GotoInstr>(target));
 }
 
 /**
@@ -2959,8 +1541,8 @@ void IRGenerator::visit(ContinueStmt&) {
         return;
     }
     
-    std::shared_ptr<Operand> target = std::make_shared<Operand>(OperandType::LABEL, continueLabels.back());
-    addInstruction(std::make_shared<GotoInstr>(target));
+    Operand target = Operand(OperandType::LABEL, continueLabels.back());
+    addInstruction(makeInstr<GotoInstr>(target));
 }
 
 /**
@@ -2972,12 +1554,12 @@ void IRGenerator::visit(ContinueStmt&) {
  */
 void IRGenerator::visit(ReturnStmt& stmt) {
     if (stmt.value) {
-        stmt.value->accept(*this);
-        std::shared_ptr<Operand> value = getTopOperand();
+        dispatch(*stmt.value);
+        Operand value = getTopOperand();
         
-        addInstruction(std::make_shared<ReturnInstr>(value));
+        addInstruction(makeInstr<ReturnInstr>(value));
     } else {
-        addInstruction(std::make_shared<ReturnInstr>());
+        addInstruction(makeInstr<ReturnInstr>());
     }
 }
 
@@ -2993,17 +1575,23 @@ void IRGenerator::visit(ReturnStmt& stmt) {
  * @param funcDef 函数定义
  */
 void IRGenerator::visit(FunctionDef& funcDef) {
-    currentFunction = funcDef.name;
+    currentFunction = std::string(identifiers.spelling(funcDef.name));
     currentFunctionReturnType = funcDef.returnType;
 
+    // 函数的指令分配在它自己的内存池中
+    module.functions.push_back(std::make_unique<IRFunction>(currentFunction));
+    irFunction = module.functions.back().get();
+    OperandId funcId = names.functionId(currentFunction);
+
     // 函数开始
-    auto funcBeginInstr = std::make_shared<FunctionBeginInstr>(funcDef.name, funcDef.returnType);
+    auto funcBeginInstr = makeInstr<FunctionBeginInstr>(funcId, funcDef.returnType != "void");
 
 
-    // 添加参数名列表
+    // 添加参数列表（参数变量使用原始名称，与 getVariable 中的规则一致）
     for (const auto& param : funcDef.params) {
-        funcBeginInstr->paramNames.push_back(param.name);
+        irFunction->params.push_back(names.vregId(std::string(identifiers.spelling(param.name))));
     }
+    funcBeginInstr->params = irFunction->arena.copyList(irFunction->params);
     
     addInstruction(funcBeginInstr);
   
@@ -3024,18 +1612,23 @@ void IRGenerator::visit(FunctionDef& funcDef) {
 
 
     // 函数体
-    funcDef.body->accept(*this);
+    dispatch(*funcDef.body);
   
     // 确保有返回指令
     if (funcDef.returnType == "void") {
-        addInstruction(std::make_shared<ReturnInstr>());
+        addInstruction(makeInstr<ReturnInstr>());
     }
     
     // 离开作用域
     exitScope();
 
     // 函数结束
-    addInstruction(std::make_shared<FunctionEndInstr>(funcDef.name));
+    addInstruction(makeInstr<FunctionEndInstr>(funcId));
+
+    // 划分基本块并建立控制流图
+    irFunction->buildBlocks(instructions);
+    instructions.clear();
+    irFunction = nullptr;
 }
 
 /**
@@ -3047,7 +1640,7 @@ void IRGenerator::visit(FunctionDef& funcDef) {
  */
 void IRGenerator::visit(CompUnit& compUnit) {
     for (const auto& func : compUnit.functions) {
-        func->accept(*this);
+        dispatch(*func);
     }
 }
 
@@ -3059,13 +1652,14 @@ void IRGenerator::visit(CompUnit& compUnit) {
  * 将IR指令打印到流。
  * 
  * @param instructions 要打印的IR指令
+ * @param names 操作数名字表
  * @param out 输出流
  */
-void IRPrinter::print(const std::vector<std::shared_ptr<IRInstr>>& instructions, std::ostream& out) {
+void IRPrinter::print(const std::vector<IRInstr*>& instructions, const IRNames& names, std::ostream& out) {
     out << "# Intermediate Representation\n";
     
     for (const auto& instr : instructions) {
-        out << instr->toString() << "\n";
+        out << instr->toString(names) << "\n";
     }
 }
 
@@ -3077,17 +1671,14 @@ void IRPrinter::print(const std::vector<std::shared_ptr<IRInstr>>& instructions,
  * 查找定义变量的指令。
  * 
  * @param instructions 要搜索的IR指令
- * @param operandName 要查找的变量名
+ * @param operand 要查找的变量编号
  * @return 定义指令的索引，如果未找到则为-1
  */
-int IRAnalyzer::findDefinition(const std::vector<std::shared_ptr<IRInstr>>& instructions, 
-                              const std::string& operandName) {
+int IRAnalyzer::findDefinition(const std::vector<IRInstr*>& instructions, 
+                              OperandId operand) {
     for (int i = 0; i < instructions.size(); ++i) {
-        auto instr = instructions[i];
-        
         // 检查是否定义了该操作数
-        auto definedVars = getDefinedVariables(instr);
-        if (std::find(definedVars.begin(), definedVars.end(), operandName) != definedVars.end()) {
+        if (definesVariable(instructions[i], operand)) {
             return i;
         }
     }
@@ -3099,19 +1690,16 @@ int IRAnalyzer::findDefinition(const std::vector<std::shared_ptr<IRInstr>>& inst
  * 查找使用变量的所有指令。
  * 
  * @param instructions 要搜索的IR指令
- * @param operandName 要查找的变量名
+ * @param operand 要查找的变量编号
  * @return 使用变量的指令索引向量
  */
-std::vector<int> IRAnalyzer::findUses(const std::vector<std::shared_ptr<IRInstr>>& instructions, 
-                                    const std::string& operandName) {
+std::vector<int> IRAnalyzer::findUses(const std::vector<IRInstr*>& instructions, 
+                                    OperandId operand) {
     std::vector<int> uses;
     
     for (int i = 0; i < instructions.size(); ++i) {
-        auto instr = instructions[i];
-        
         // 检查是否使用了该操作数
-        auto usedVars = getUsedVariables(instr);
-        if (std::find(usedVars.begin(), usedVars.end(), operandName) != usedVars.end()) {
+        if (usesVariable(instructions[i], operand)) {
             uses.push_back(i);
         }
     }
@@ -3125,23 +1713,21 @@ std::vector<int> IRAnalyzer::findUses(const std::vector<std::shared_ptr<IRInstr>
  * 如果变量在位置之后使用且未重新定义，则它是活跃的。
  * 
  * @param instructions 要搜索的IR指令
- * @param varName 要检查的变量名
+ * @param var 要检查的变量编号
  * @param position 要检查的位置
  * @return 如果变量在位置处活跃则为true
  */
-bool IRAnalyzer::isVariableLive(const std::vector<std::shared_ptr<IRInstr>>& instructions,
-                               const std::string& varName,
+bool IRAnalyzer::isVariableLive(const std::vector<IRInstr*>& instructions,
+                               OperandId var,
                                int position) {
     // 如果变量在position之后被使用，则认为它是活跃的
     for (int i = position + 1; i < instructions.size(); ++i) {
-        auto usedVars = getUsedVariables(instructions[i]);
-        if (std::find(usedVars.begin(), usedVars.end(), varName) != usedVars.end()) {
+        if (usesVariable(instructions[i], var)) {
             return true;
         }
         
         // 如果变量在这条指令中被重新定义，则之前的值不再活跃
-        auto definedVars = getDefinedVariables(instructions[i]);
-        if (std::find(definedVars.begin(), definedVars.end(), varName) != definedVars.end()) {
+        if (definesVariable(instructions[i], var)) {
             return false;
         }
     }
@@ -3150,94 +1736,42 @@ bool IRAnalyzer::isVariableLive(const std::vector<std::shared_ptr<IRInstr>>& ins
 }
 
 /**
- * 获取指令定义的所有变量。
+ * 检查指令是否定义了变量。
  * 
  * @param instr 要检查的指令
- * @return 指令定义的变量名向量
+ * @param var 变量编号
+ * @return 指令定义了 var 则为true
  */
-std::vector<std::string> IRAnalyzer::getDefinedVariables(const std::shared_ptr<IRInstr>& instr) {
-    std::vector<std::string> definedVars;
-    
-    if (auto binaryOp = std::dynamic_pointer_cast<BinaryOpInstr>(instr)) {
-        if (binaryOp->result) {
-            definedVars.push_back(binaryOp->result->name);
-        }
-    }
-    else if (auto unaryOp = std::dynamic_pointer_cast<UnaryOpInstr>(instr)) {
-        if (unaryOp->result) {
-            definedVars.push_back(unaryOp->result->name);
-        }
-    }
-    else if (auto assignInstr = std::dynamic_pointer_cast<AssignInstr>(instr)) {
-        if (assignInstr->target) {
-            definedVars.push_back(assignInstr->target->name);
-        }
-    }
-    else if (auto callInstr = std::dynamic_pointer_cast<CallInstr>(instr)) {
-        if (callInstr->result) {
-            definedVars.push_back(callInstr->result->name);
-        }
-    }
-    
-    return definedVars;
+bool IRAnalyzer::definesVariable(const IRInstr* instr, OperandId var) {
+    const Operand* def = defOperand(instr);
+    return def && def->id == var;
 }
 
 /**
- * 获取指令使用的所有变量。
+ * 检查指令是否使用了变量。
  * 
  * @param instr 要检查的指令
- * @return 指令使用的变量名向量
+ * @param var 变量编号
+ * @return 指令使用了 var 则为true
  */
-std::vector<std::string> IRAnalyzer::getUsedVariables(const std::shared_ptr<IRInstr>& instr) {
-    std::vector<std::string> usedVars;
-    
-    if (auto binaryOp = std::dynamic_pointer_cast<BinaryOpInstr>(instr)) {
-        if (binaryOp->left && binaryOp->left->type != OperandType::CONSTANT) {
-            usedVars.push_back(binaryOp->left->name);
-        }
-        if (binaryOp->right && binaryOp->right->type != OperandType::CONSTANT) {
-            usedVars.push_back(binaryOp->right->name);
-        }
-    }
-    else if (auto unaryOp = std::dynamic_pointer_cast<UnaryOpInstr>(instr)) {
-        if (unaryOp->operand && unaryOp->operand->type != OperandType::CONSTANT) {
-            usedVars.push_back(unaryOp->operand->name);
-        }
-    }
-    else if (auto assignInstr = std::dynamic_pointer_cast<AssignInstr>(instr)) {
-        if (assignInstr->source && assignInstr->source->type != OperandType::CONSTANT) {
-            usedVars.push_back(assignInstr->source->name);
-        }
-    }
-    else if (auto gotoInstr = std::dynamic_pointer_cast<GotoInstr>(instr)) {
-        // 标签不算变量使用
-    }
-    else if (auto ifGotoInstr = std::dynamic_pointer_cast<IfGotoInstr>(instr)) {
-        if (ifGotoInstr->condition && ifGotoInstr->condition->type != OperandType::CONSTANT) {
-            usedVars.push_back(ifGotoInstr->condition->name);
-        }
-    }
-    else if (auto paramInstr = std::dynamic_pointer_cast<ParamInstr>(instr)) {
-        if (paramInstr->param && paramInstr->param->type != OperandType::CONSTANT) {
-            usedVars.push_back(paramInstr->param->name);
-        }
-    }
-    else if (auto returnInstr = std::dynamic_pointer_cast<ReturnInstr>(instr)) {
-        if (returnInstr->value && returnInstr->value->type != OperandType::CONSTANT) {
-            usedVars.push_back(returnInstr->value->name);
-        }
-    }
-    
-    return usedVars;
+bool IRAnalyzer::usesVariable(const IRInstr* instr, OperandId var) {
+    bool used = false;
+    forEachUseOperand(instr, [&](const Operand& use) {
+        used = used || use.id == var;
+    });
+    return used;
 }
+
 /**
  * 检查函数是否被使用
  * 
  * @param instructions 要搜索的IR指令
+ * @param names 操作数名字表（查询被调函数名）
  * @param funcName 要检查的函数名
  * @return 如果函数被使用则为true
  */
-bool IRAnalyzer::isFunctionUsed(const std::vector<std::shared_ptr<IRInstr>>& instructions,
+bool IRAnalyzer::isFunctionUsed(const std::vector<IRInstr*>& instructions,
+                              const IRNames& names,
                               const std::string& funcName) {
     // 如果是main函数，总是被使用
     if (funcName == "main") {
@@ -3245,8 +1779,8 @@ bool IRAnalyzer::isFunctionUsed(const std::vector<std::shared_ptr<IRInstr>>& ins
     }
     
     for (const auto& instr : instructions) {
-        if (auto callInstr = std::dynamic_pointer_cast<CallInstr>(instr)) {
-            if (callInstr->funcName == funcName) {
+        if (auto callInstr = instrCast<CallInstr>(instr)) {
+            if (names.functionName(callInstr->callee) == funcName) {
                 return true;
             }
         }
@@ -3255,6 +1789,6 @@ bool IRAnalyzer::isFunctionUsed(const std::vector<std::shared_ptr<IRInstr>>& ins
     return false;
 }
 
-void IRGenerator::markFunctionAsUsed(const std::string& funcName) {
+void IRGenerator::markFunctionAsUsed(SymbolId funcName) {
     usedFunctions.insert(funcName);
 }
@@ -1,6 +1,8 @@
 // irgen.h - 定义IR生成器接口和优化器
 #pragma once
 #include "ir.h"
+#include "common/scopedTable.h"
+#include "common/stringInterner.h"
 #include "parser/ast.h"
 #include "parser/astVisitor.h"
 #include "semantic/semantic.h"
@@ -8,13 +10,9 @@
 #include <vector>
 #include <memory>
 #include <map>
-#include <stack>
 #include <functional>
-#include <queue>
 #include <unordered_set>
 
-using BlockID = int;
-
 // IR生成异常类
 class IRGenError : public std::runtime_error {
 public:
@@ -29,48 +27,71 @@ struct IRGenConfig {
 };
 
 // IRGenerator - IR生成器类，实现AST访问者接口
-class IRGenerator : public ASTVisitor {
+class IRGenerator : public StaticASTVisitor<IRGenerator> {
 private:
-    // 生成的IR指令序列
-    std::vector<std::shared_ptr<IRInstr>> instructions;
+    // 生成的IR指令序列：生成时为当前函数已生成的指令，生成完成后为 module 的扁平形式
+    std::vector<IRInstr*> instructions;
+    // 按函数和基本块组织的IR，优化遍在其上进行；指令归各函数的内存池所有
+    IRModule module;
+    // 正在生成的函数，新指令分配在它的内存池中
+    IRFunction* irFunction = nullptr;
     // 临时变量和标签计数器
     int tempCount = 0;
     int labelCount = 0;
-    // 变量映射表
-    std::map<std::string, std::shared_ptr<Operand>> variables;
+    // SSA 重命名时给变量新版本编号的计数器
+    int ssaNameCount = 0;
+    // SSA 版本的变量编号 -> 构建 SSA 前的原变量编号（其余编号为 kNoOperand 或超出范围）
+    std::vector<OperandId> ssaOrigin;
     // 当前函数上下文
     std::string currentFunction;
     std::string currentFunctionReturnType; // 当前函数的返回类型，用于检查 return 语句
     
     // 操作数栈，用于表达式计算
-    std::vector<std::shared_ptr<Operand>> operandStack;
+    std::vector<Operand> operandStack;
 
-    // 用于break和continue语句的标签栈
-    std::vector<std::string> breakLabels;
-    std::vector<std::string> continueLabels;
+    // 用于break和continue语句的标签栈（标签编号）
+    std::vector<OperandId> breakLabels;
+    std::vector<OperandId> continueLabels;
 
     // 生成器配置
     IRGenConfig config;
     
-    // 变量作用域管理
-    std::vector<std::map<std::string, std::shared_ptr<Operand>>> scopeStack;
+    // 标识符驻留表，用于生成操作数的名字
+    const StringInterner& identifiers;
+
+    // 操作数编号与名字的对照表
+    IRNames names;
+
+    // 变量作用域管理（所有作用域共用一张以标识符编号为键的表）
+    ScopedTable<Operand> scopes;
 
     // 函数使用跟踪
-    std::set<std::string> usedFunctions;
+    std::unordered_set<SymbolId> usedFunctions;
 
 public:
-    IRGenerator(const IRGenConfig& config = IRGenConfig()) : config(config) {
+    IRGenerator(const StringInterner& identifiers, const IRGenConfig& config = IRGenConfig())
+        : config(config), identifiers(identifiers) {
         // 初始化作用域栈
         enterScope();
     }
     
     // 获取生成的IR指令序列
-    const std::vector<std::shared_ptr<IRInstr>>& getInstructions() const { 
+    const std::vector<IRInstr*>& getInstructions() const { 
         return instructions; 
     }
+
+    // 获取按函数和基本块组织的IR
+    const IRModule& getModule() const {
+        return module;
+    }
+
+    // 获取操作数名字表，打印IR和生成代码时使用
+    const IRNames& getNames() const {
+        return names;
+    }
     
     // 生成IR
-    void generate(std::shared_ptr<CompUnit> ast);
+    void generate(CompUnit& ast);
     
     // 导出IR到文件
     void dumpIR(const std::string& filename) const;
@@ -80,51 +101,56 @@ public:
 
     // 辅助方法
     // 创建临时变量操作数
-    std::shared_ptr<Operand> createTemp();
+    Operand createTemp();
      // 创建标签操作数
-    std::shared_ptr<Operand> createLabel();
+    Operand createLabel();
+    // 在当前函数的内存池中创建指令
+    template <typename T, typename... Args>
+    T* makeInstr(Args&&... args) {
+        return irFunction->makeInstr<T>(std::forward<Args>(args)...);
+    }
     // 添加指令到指令序列
-    void addInstruction(std::shared_ptr<IRInstr> instr);
+    void addInstruction(IRInstr* instr);
     
     // 返回栈顶操作数
-    std::shared_ptr<Operand> getTopOperand();
+    Operand getTopOperand();
 
     // 获取使用过的函数列表
-    const std::set<std::string>& getUsedFunctions() const {
+    const std::unordered_set<SymbolId>& getUsedFunctions() const {
         return usedFunctions;
     }
     
-    // 实现ASTVisitor接口
-    void visit(NumberExpr& expr) override;
-    void visit(VariableExpr& expr) override;
-    void visit(BinaryExpr& expr) override;
-    void visit(UnaryExpr& expr) override;
-    void visit(CallExpr& expr) override;
+    // 各种AST节点的访问方法（由 StaticASTVisitor::dispatch 静态分派）
+    void visit(NumberExpr& expr);
+    void visit(VariableExpr& expr);
+    void visit(BinaryExpr& expr);
+    void visit(UnaryExpr& expr);
+    void visit(CallExpr& expr);
     
-    void visit(ExprStmt& stmt) override;
-    void visit(VarDeclStmt& stmt) override;
-    void visit(AssignStmt& stmt) override;
-    void visit(BlockStmt& stmt) override;
-    void visit(IfStmt& stmt) override;
-    void visit(WhileStmt& stmt) override;
-    void visit(BreakStmt& stmt) override;
-    void visit(ContinueStmt& stmt) override;
-    void visit(ReturnStmt& stmt) override;
+    void visit(ExprStmt& stmt);
+    void visit(VarDeclStmt& stmt);
+    void visit(AssignStmt& stmt);
+    void visit(BlockStmt& stmt);
+    void visit(IfStmt& stmt);
+    void visit(WhileStmt& stmt);
+    void visit(BreakStmt& stmt);
+    void visit(ContinueStmt& stmt);
+    void visit(ReturnStmt& stmt);
     
-    void visit(FunctionDef& funcDef) override;
-    void visit(CompUnit& compUnit) override;
+    void visit(FunctionDef& funcDef);
+    void visit(CompUnit& compUnit);
     
 private:
     // 获取或创建变量操作数
-    //std::shared_ptr<Operand> getVariable(const std::string& name);
+    //Operand getVariable(const std::string& name);
 
-    std::shared_ptr<Operand> getVariable(const std::string& name, bool createInCurrentScope = false);
+    Operand getVariable(SymbolId name, bool createInCurrentScope = false);
 
     int scopeDepth = 0;  // 当前作用域深度
     
     // 生成带作用域信息的变量名
-    std::string getScopedVariableName(const std::string& name) {
-        return name + "_scope" + std::to_string(scopeDepth);
+    std::string getScopedVariableName(SymbolId name) {
+        return std::string(identifiers.spelling(name)) + "_scope" + std::to_string(scopeDepth);
     }
 
     // 作用域管理
@@ -132,155 +158,94 @@ private:
     void exitScope();
     
     // 在当前作用域中查找变量
-    std::shared_ptr<Operand> findVariableInCurrentScope(const std::string& name);
+    Operand findVariableInCurrentScope(SymbolId name);
     
     // 在所有作用域中查找变量
-    std::shared_ptr<Operand> findVariable(const std::string& name);
+    Operand findVariable(SymbolId name);
     
     // 在当前作用域中定义变量
-    void defineVariable(const std::string& name, std::shared_ptr<Operand> var);
+    void defineVariable(SymbolId name, Operand var);
     
-    // 优化相关方法
-    void constantFolding();        // 常量折叠
-    //void constantPropagation();    // 常量传播
-    void constantPropagationCFG();   // 常量传播
-    void deadCodeElimination();    // 死代码删除
-    void copyPropagationCFG();      // 复制传播优化
-    void controlFlowOptimization();// 控制流优化
+    // 优化相关方法（均在单个函数上进行）
+    void constantFolding(IRFunction& func);        // 常量折叠
+    void deadCodeElimination(IRFunction& func);    // 死代码删除
+    void copyPropagationCFG(IRFunction& func);      // 复制传播优化
+    void controlFlowOptimization(IRFunction& func);// 控制流优化
+    void removeUnreachableBlocks(IRFunction& func); // 删除从入口不可达的块
+
+    // SSA 形式（见 ssa.cpp）
+    void constructSSA(IRFunction& func);            // 转换为剪枝 SSA 形式
+    void destructSSA(IRFunction& func);             // 消去 φ，转换回普通三地址码
+    BasicBlock* splitEdge(IRFunction& func, BasicBlock* from, BasicBlock* to);  // 在边上插入新块
+    void sequentializeCopies(IRFunction& func, std::vector<std::pair<Operand, Operand>> copies,
+                             std::vector<IRInstr*>& out);                       // 并行复制顺序化
+    void coalesceSSAVersions(IRFunction& func);     // 把互不冲突的版本合并回原变量
+    OperandId ssaOriginOf(OperandId id) const;      // SSA 版本对应的原变量编号
+    void sparseConditionalConstantPropagation(IRFunction& func);   // 稀疏条件常量传播（见 sccp.cpp）
+    void globalValueNumbering(IRFunction& func);    // 基于支配树的全局值编号（见 gvn.cpp）
+    void loopInvariantCodeMotion(IRFunction& func); // 循环不变量外提到前置块（见 licm.cpp）
 
     // 判断指令是否具有副作用
-    bool isSideEffectInstr(const std::shared_ptr<IRInstr>& instr);
+    bool isSideEffectInstr(const IRInstr* instr);
 
-    // 递归解析常量表达式，depth 避免循环引用
-    std::shared_ptr<Operand> resolveConstant(
-        const std::string& name,
-        std::unordered_map<std::string, std::shared_ptr<Operand>>& constants,
-        std::unordered_set<std::string>& visited,
-        int depth = 0);
-    
     // 短路求值支持
-    std::shared_ptr<Operand> generateShortCircuitAnd(BinaryExpr& expr);
-    std::shared_ptr<Operand> generateShortCircuitOr(BinaryExpr& expr);
+    Operand generateShortCircuitAnd(BinaryExpr& expr);
+    Operand generateShortCircuitOr(BinaryExpr& expr);
     
     // 控制流分析
-    /*struct BasicBlock {
-        std::string label;
-        std::vector<int> instructionIndices;  // 指令索引
-        std::vector<std::string> successors;  // 后继基本块
-        std::vector<std::string> predecessors;// 前驱基本块
-    };*/
-    struct BasicBlock {
-        int id;
-        std::vector<std::shared_ptr<IRInstr>> instructions;
-        std::vector<std::shared_ptr<BasicBlock>> successors;
-        std::vector<std::shared_ptr<BasicBlock>> predecessors;
-        std::string label; // 如果以标签开头则记录标签名（可选）
-        std::string functionName;   // 记录该基本块属于哪个函数
-    };
+    // 基本块与控制流图见 ir.h 中的 IRModule / IRFunction / BasicBlock
 
     // 生成常量操作数
-    std::shared_ptr<Operand> makeConstantOperand(int v,std::string name);
-
-    // 构建基本快
-    std::vector<std::shared_ptr<BasicBlock>> buildBasicBlocks();
-
-    // 执复制传播时仅通过标签划分基本块
-    std::vector<std::shared_ptr<BasicBlock>> buildBasicBlocksByLabel();
-
-    // 获取循环体内定义的所有变量集合（循环定义变量分析）
-    /*std::unordered_set<std::string> getLoopDefs(
-        const std::unordered_map<BlockID, std::vector<BlockID>>& cfg,
-        BlockID fromBlk, BlockID toBlk,
-        const std::unordered_map<BlockID, BasicBlock>& blocks
-    );*/
-    std::unordered_set<std::string> getLoopDefs(
-        const std::unordered_set<BlockID>& loopBlocks,
-        const std::unordered_map<BlockID, IRGenerator::BasicBlock>& blocks);
-
-    // 返回循环体内所有块ID
-    std::unordered_set<int> getLoopBlocks(
-        const std::unordered_map<int, std::vector<int>>& cfg,
-        int fromBlk, int toBlk);
-   
-    // 构建CFG
-    void buildCFG(std::vector<std::shared_ptr<BasicBlock>>& blocks);
+    Operand makeConstantOperand(int v);
+    // 编译期计算常量运算（SCCP 和 GVN 共用），二元运算不能计算时返回 false
+    static bool evaluateBinaryOp(OpCode opcode, int lval, int rval, int& out);
+    static int evaluateUnaryOp(OpCode opcode, int value);
 
     // 更新所有跳转指令目标标签，fromLabel -> toLabel
     void updateJumpTargets(
-        std::vector<std::shared_ptr<BasicBlock>>& blocks,
-        const std::string& fromLabel,
-        const std::string& toLabel);
+        IRFunction& func,
+        OperandId fromLabel,
+        OperandId toLabel);
 
     // 校验 CFG 有效性
-    bool validateCFG(const std::vector<std::shared_ptr<BasicBlock>>& blocks);
+    bool validateCFG(const IRFunction& func);
 
+    // 可用表达式：操作码和两个操作数的键（见 irgen.cpp 中的 operandKey）
     struct Expression {
         OpCode op;
-        std::string lhs;
-        std::string rhs;
-        bool someFlag;       
+        uint64_t lhs;
+        uint64_t rhs;
 
         bool operator==(const Expression& other) const {
-            return op == other.op &&
-                lhs == other.lhs &&
-                rhs == other.rhs &&
-                someFlag == other.someFlag;
+            return op == other.op && lhs == other.lhs && rhs == other.rhs;
         }
     };
     
     struct ExpressionHash {
         std::size_t operator()(const Expression& e) const {
-
-            std::string op;
-            switch (e.op) {
-                case OpCode::ADD: op = "ADD";
-                case OpCode::SUB: op = "SUB";
-                case OpCode::MUL: op = "MUL";
-                case OpCode::DIV: op = "DIV";
-                case OpCode::MOD: op = "MOD";
-                case OpCode::NEG: op = "NEG";
-                case OpCode::NOT: op = "NOT";
-                case OpCode::LT:  op = "LT";
-                case OpCode::GT:  op = "GT";
-                case OpCode::LE:  op = "LE";
-                case OpCode::GE:  op = "GE";
-                case OpCode::EQ:  op = "EQ";
-                case OpCode::NE:  op = "NE";
-                case OpCode::AND: op = "AND";
-                case OpCode::OR:  op = "OR";
-                case OpCode::ASSIGN: op = "ASSIGN";
-                case OpCode::GOTO: op = "GOTO";
-                case OpCode::IF_GOTO: op = "IF_GOTO";
-                case OpCode::PARAM: op = "PARAM";
-                case OpCode::CALL: op = "CALL";
-                case OpCode::RETURN: op = "RETURN";
-                case OpCode::LABEL: op = "LABEL";
-                case OpCode::FUNCTION_BEGIN: op = "FUNCTION_BEGIN";
-                case OpCode::FUNCTION_END: op = "FUNCTION_END";
-                default: op = "UNKNOWN_OP";
-            }
-
-            return std::hash<std::string>()(op + "|" + e.lhs + "|" + e.rhs);
+            std::size_t h = std::hash<uint64_t>()(e.lhs);
+            h = h * 31 + std::hash<uint64_t>()(e.rhs);
+            return h * 31 + static_cast<std::size_t>(e.op);
         }
     };
     
     // 公共子表达式消除
-    void commonSubexpressionElimination();
+    void commonSubexpressionElimination(IRFunction& func);
     
     // 构建控制流图
     //std::map<std::string, BasicBlock> buildControlFlowGraph();
     
     // 检查指令是否是控制流指令
-    //bool isControlFlowInstruction(const std::shared_ptr<IRInstr>& instr) const;
+    //bool isControlFlowInstruction(const IRInstr* instr) const;
     
     // 获取控制流指令的目标标签
-    //std::vector<std::string> getControlFlowTargets(const std::shared_ptr<IRInstr>& instr) const;
+    //std::vector<std::string> getControlFlowTargets(const IRInstr* instr) const;
 
     // 辅助函数，递归判断一个语句是否所有路径都 return
-    bool allPathsReturn(const std::shared_ptr<Stmt>& stmt);
+    bool allPathsReturn(const Stmt* stmt);
 
     // 记录函数被使用
-    void markFunctionAsUsed(const std::string& funcName);
+    void markFunctionAsUsed(SymbolId funcName);
 };
 
 // IR优化器接口
@@ -288,13 +253,13 @@ class IROptimizer {
 public:
     virtual ~IROptimizer() = default;
     // 优化IR指令序列
-    virtual void optimize(std::vector<std::shared_ptr<IRInstr>>& instructions) = 0;
+    virtual void optimize(std::vector<IRInstr*>& instructions) = 0;
 };
 
 // 常量折叠优化器
 class ConstantFoldingOptimizer : public IROptimizer {
 public:
-    void optimize(std::vector<std::shared_ptr<IRInstr>>& instructions) override;
+    void optimize(std::vector<IRInstr*>& instructions) override;
 private:
     bool evaluateConstantExpression(OpCode op, int left, int right, int& result);
 };
@@ -302,12 +267,12 @@ private:
 // 死代码消除优化器
 class DeadCodeOptimizer : public IROptimizer {
 public:
-    void optimize(std::vector<std::shared_ptr<IRInstr>>& instructions) override;
+    void optimize(std::vector<IRInstr*>& instructions) override;
 private:
     // 找出活跃的指令
-    std::vector<bool> findLiveInstructions(const std::vector<std::shared_ptr<IRInstr>>& instructions);
+    std::vector<bool> findLiveInstructions(const std::vector<IRInstr*>& instructions);
     // 检查指令是否活跃
-    bool isInstructionLive(const std::shared_ptr<IRInstr>& instr, 
+    bool isInstructionLive(const IRInstr* instr, 
                           const std::map<std::string, bool>& liveVars);
 };
 
@@ -317,9 +282,9 @@ public:
     virtual ~IRToRISCVGenerator() = default;
     
     // 将IR转换为RISC-V汇编代码并写入文件
-    virtual void generate(const std::vector<std::shared_ptr<IRInstr>>& instructions, 
+    virtual void generate(const std::vector<IRInstr*>& instructions, 
                          const std::string& outputFile) = 0;
                          
     // 将单个IR指令转换为RISC-V汇编代码
-    virtual std::vector<std::string> translateInstruction(const std::shared_ptr<IRInstr>& instr) = 0;
+    virtual std::vector<std::string> translateInstruction(const IRInstr* instr) = 0;
 };
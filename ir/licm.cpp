@@ -0,0 +1,161 @@
+// licm.cpp - SSA 形式上的循环不变量外提
+#include "irgen.h"
+#include "dominators.h"
+#include <algorithm>
+
+/**
+ * 循环不变量外提（Loop-Invariant Code Motion）
+ *
+ * 循环由支配树找出：终点支配起点的边是回边，回边的终点是循环头，
+ * 从循环头的其余前驱逆着控制流走到循环头为止经过的块组成循环体（同一循环头的回边合为一个循环）。
+ * 每个循环有一个前置块：循环头唯一的循环外前驱只有这一个后继时直接使用它，否则在这条边上插入新块。
+ * 操作数都是常量或在循环外定义的一元、二元运算是不变量，移到前置块末尾，只计算一次；
+ * while 的条件和循环体中 if 的条件是比较运算，不变时同样被外提，循环中只留下条件跳转。
+ * 在 SSA 形式上每个变量只有一个定义，移动定义不会与其它定义冲突。
+ */
+
+// 除法和取模在除数为零时没有定义，只有除数是非零常量时才能提前计算
+static bool canSpeculate(const IRInstr* instr) {
+    if (instr->opcode != OpCode::DIV && instr->opcode != OpCode::MOD) return true;
+    const Operand& divisor = static_cast<const BinaryOpInstr*>(instr)->right;
+    return divisor.type == OperandType::CONSTANT && divisor.value != 0;
+}
+
+/**
+ * 把 SSA 形式的函数中循环不变的一元、二元运算外提到循环前置块
+ * 算法步骤：
+ * 1. 用支配树找出循环头，为每个循环头准备前置块（必要时拆分入口边）
+ * 2. 求每个循环的循环体，按块数从小到大（内层循环在前）排列
+ * 3. 按逆后序扫描循环体，操作数都不在循环内定义的运算移到前置块末尾的跳转之前，并记为在前置块中定义，
+ *    依赖它的运算随后也能外提；内层的前置块属于外层循环，外层循环处理时其中的运算可以继续外提
+ */
+void IRGenerator::loopInvariantCodeMotion(IRFunction& func) {
+    if (func.blocks.empty()) return;
+
+    // ====== Step 1: 循环头与前置块 ======
+    struct Loop {
+        BasicBlock* header;
+        BasicBlock* preheader = nullptr;
+        std::vector<BasicBlock*> body;
+    };
+    std::vector<Loop> loops;
+    {
+        DominatorTree domTree(func);
+        for (BasicBlock* block : domTree.preorder()) {
+            for (BasicBlock* pred : block->predecessors) {
+                if (domTree.dominates(block, pred)) {
+                    loops.push_back(Loop{block, nullptr, {}});
+                    break;
+                }
+            }
+        }
+        // 循环外的前驱是不被循环头支配的前驱；结构化的 while 循环只有一个，有多个时不处理
+        for (Loop& loop : loops) {
+            BasicBlock* entry = nullptr;
+            size_t entries = 0;
+            for (BasicBlock* pred : loop.header->predecessors) {
+                if (!domTree.dominates(loop.header, pred)) {
+                    entry = pred;
+                    ++entries;
+                }
+            }
+            if (entries == 1) loop.preheader = entry;
+        }
+    }
+    if (loops.empty()) return;
+
+    // 拆分边会插入块、改变块的编号，支配树在此之后不再使用
+    for (Loop& loop : loops) {
+        if (loop.preheader && loop.preheader->successors.size() > 1) {
+            loop.preheader = splitEdge(func, loop.preheader, loop.header);
+        }
+    }
+    loops.erase(std::remove_if(loops.begin(), loops.end(), [](const Loop& loop) { return !loop.preheader; }),
+                loops.end());
+
+    // ====== Step 2: 循环体 ======
+    const size_t blockCount = func.blocks.size();
+    std::vector<int> rpoIndex(blockCount, -1);
+    {
+        std::vector<BasicBlock*> rpo = func.reversePostOrder();
+        for (size_t i = 0; i < rpo.size(); ++i) rpoIndex[rpo[i]->id] = static_cast<int>(i);
+    }
+    std::vector<char> inLoop(blockCount, 0);
+    std::vector<BasicBlock*> stack;
+    for (Loop& loop : loops) {
+        loop.body.push_back(loop.header);
+        inLoop[loop.header->id] = 1;
+        for (BasicBlock* pred : loop.header->predecessors) {
+            if (pred != loop.preheader && !inLoop[pred->id]) {
+                inLoop[pred->id] = 1;
+                stack.push_back(pred);
+            }
+        }
+        while (!stack.empty()) {
+            BasicBlock* block = stack.back();
+            stack.pop_back();
+            loop.body.push_back(block);
+            for (BasicBlock* pred : block->predecessors) {
+                if (!inLoop[pred->id]) {
+                    inLoop[pred->id] = 1;
+                    stack.push_back(pred);
+                }
+            }
+        }
+        for (BasicBlock* block : loop.body) inLoop[block->id] = 0;
+        std::sort(loop.body.begin(), loop.body.end(), [&](BasicBlock* a, BasicBlock* b) {
+            return rpoIndex[a->id] < rpoIndex[b->id];
+        });
+    }
+    std::stable_sort(loops.begin(), loops.end(), [](const Loop& a, const Loop& b) {
+        return a.body.size() < b.body.size();
+    });
+
+    // ====== Step 3: 外提 ======
+    const size_t varCount = names.vregCount();
+    std::vector<BasicBlock*> defBlock(varCount, nullptr);      // 变量的定义块，形参和未定义的变量为空
+    for (auto& block : func.blocks) {
+        for (auto instr : block->instructions) {
+            if (const Operand* def = defOperand(instr)) defBlock[def->id] = block.get();
+        }
+    }
+
+    std::vector<IRInstr*> hoisted;
+    for (Loop& loop : loops) {
+        for (BasicBlock* block : loop.body) inLoop[block->id] = 1;
+
+        hoisted.clear();
+        for (BasicBlock* block : loop.body) {
+            auto& instrs = block->instructions;
+            size_t out = 0;
+            for (auto instr : instrs) {
+                const Operand* result = defOperand(instr);
+                bool invariant = result && (instrCast<BinaryOpInstr>(instr) || instrCast<UnaryOpInstr>(instr)) &&
+                                 canSpeculate(instr);
+                if (invariant) {
+                    forEachUseOperand(instr, [&](const Operand& use) {
+                        BasicBlock* def = defBlock[use.id];
+                        if (def && inLoop[def->id]) invariant = false;
+                    });
+                }
+                if (invariant) {
+                    hoisted.push_back(instr);
+                    defBlock[result->id] = loop.preheader;
+                } else {
+                    instrs[out++] = instr;
+                }
+            }
+            instrs.resize(out);
+        }
+
+        if (!hoisted.empty()) {
+            auto& instrs = loop.preheader->instructions;
+            auto at = instrs.end();
+            if (!instrs.empty() && (instrs.back()->opcode == OpCode::GOTO || instrs.back()->opcode == OpCode::IF_GOTO)) {
+                --at;
+            }
+            instrs.insert(at, hoisted.begin(), hoisted.end());
+        }
+        for (BasicBlock* block : loop.body) inLoop[block->id] = 0;
+    }
+}
@@ -0,0 +1,196 @@
+// module.cpp - 实现IR模块、函数与基本块的构建和控制流边的维护
+#include "ir.h"
+#include <algorithm>
+#include <unordered_map>
+
+//------------------------------------------------------------------------------
+// IRFunction
+//------------------------------------------------------------------------------
+
+// 按输出顺序排在 block 之后的块
+BasicBlock* IRFunction::nextBlock(const BasicBlock* block) const {
+    size_t next = static_cast<size_t>(block->id) + 1;
+    return next < blocks.size() ? blocks[next].get() : nullptr;
+}
+
+// 查找以指定标签开头的块
+BasicBlock* IRFunction::findBlock(OperandId label) const {
+    for (auto& block : blocks) {
+        if (block->label == label) return block.get();
+    }
+    return nullptr;
+}
+
+// 添加一条边（已存在时不重复添加）
+void IRFunction::addEdge(BasicBlock* from, BasicBlock* to) {
+    if (std::find(from->successors.begin(), from->successors.end(), to) != from->successors.end()) {
+        return;
+    }
+    from->successors.push_back(to);
+    to->predecessors.push_back(from);
+}
+
+// 删除一条边
+void IRFunction::removeEdge(BasicBlock* from, BasicBlock* to) {
+    auto& succs = from->successors;
+    succs.erase(std::remove(succs.begin(), succs.end(), to), succs.end());
+    auto& preds = to->predecessors;
+    preds.erase(std::remove(preds.begin(), preds.end(), from), preds.end());
+}
+
+// 删除 dead[id] 为真的块并重新编号
+void IRFunction::removeBlocks(const std::vector<bool>& dead) {
+    // 先断开被删除块的所有边，避免剩余块中留下悬空指针
+    for (auto& block : blocks) {
+        if (!dead[block->id]) continue;
+        while (!block->successors.empty()) removeEdge(block.get(), block->successors.back());
+        while (!block->predecessors.empty()) removeEdge(block->predecessors.back(), block.get());
+    }
+
+    blocks.erase(std::remove_if(blocks.begin(), blocks.end(),
+        [&](const std::unique_ptr<BasicBlock>& block) { return dead[block->id]; }),
+        blocks.end());
+
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        blocks[i]->id = static_cast<BlockID>(i);
+    }
+}
+
+// 在 position 处插入空块并重新编号
+BasicBlock* IRFunction::insertBlock(BlockID position) {
+    auto it = blocks.insert(blocks.begin() + position, std::make_unique<BasicBlock>());
+    for (size_t i = static_cast<size_t>(position); i < blocks.size(); ++i) {
+        blocks[i]->id = static_cast<BlockID>(i);
+    }
+    return it->get();
+}
+
+// 从入口可达的块的逆后序，用显式栈做深度优先遍历
+std::vector<BasicBlock*> IRFunction::reversePostOrder() const {
+    std::vector<BasicBlock*> order;
+    if (blocks.empty()) return order;
+
+    std::vector<char> visited(blocks.size(), 0);
+    // 栈中每项为（块，下一个要访问的后继下标）
+    std::vector<std::pair<BasicBlock*, size_t>> stack;
+    stack.emplace_back(entry(), 0);
+    visited[entry()->id] = 1;
+    while (!stack.empty()) {
+        auto& [block, next] = stack.back();
+        if (next < block->successors.size()) {
+            BasicBlock* succ = block->successors[next++];
+            if (!visited[succ->id]) {
+                visited[succ->id] = 1;
+                stack.emplace_back(succ, 0);
+            }
+        } else {
+            order.push_back(block);
+            stack.pop_back();
+        }
+    }
+    std::reverse(order.begin(), order.end());
+    return order;
+}
+
+// 按块的顺序把指令追加到 out
+void IRFunction::appendInstructions(std::vector<IRInstr*>& out) const {
+    for (auto& block : blocks) {
+        out.insert(out.end(), block->instructions.begin(), block->instructions.end());
+    }
+}
+
+// 把函数的指令划分为基本块并连接控制流边
+void IRFunction::buildBlocks(const std::vector<IRInstr*>& instrs) {
+    // 标签 -> 指令位置
+    std::unordered_map<OperandId, int> labelToIndex;
+    for (int i = 0; i < (int)instrs.size(); ++i) {
+        if (auto lbl = instrCast<LabelInstr>(instrs[i])) {
+            labelToIndex[lbl->label] = i;
+        }
+    }
+
+    // 标记 leader（基本块起点）
+    std::vector<char> isLeader(instrs.size(), 0);
+    if (!instrs.empty()) isLeader[0] = 1;       // 第一条指令
+
+    for (int i = 0; i < (int)instrs.size(); ++i) {
+        IRInstr* ins = instrs[i];
+        bool endsBlock = false;
+
+        switch (ins->opcode) {
+            case OpCode::IF_GOTO:
+            case OpCode::GOTO: {
+                // 跳转目标是 leader，跳转的下一条也是
+                OperandId target = ins->opcode == OpCode::GOTO ? static_cast<GotoInstr*>(ins)->target.id
+                                                               : static_cast<IfGotoInstr*>(ins)->target.id;
+                auto it = labelToIndex.find(target);
+                if (it != labelToIndex.end()) isLeader[it->second] = 1;
+                endsBlock = true;
+                break;
+            }
+            case OpCode::RETURN:
+                endsBlock = true;
+                break;
+            case OpCode::LABEL:
+                isLeader[i] = 1;                // 标签自身是 leader
+                break;
+            case OpCode::CALL:
+                endsBlock = true;               // 函数调用之后另起一块（保守策略）
+                break;
+            default:
+                break;
+        }
+
+        if (endsBlock && i + 1 < (int)instrs.size()) isLeader[i + 1] = 1;
+    }
+
+    // 根据 leader 划分基本块
+    for (int i = 0; i < (int)instrs.size(); ++i) {
+        if (isLeader[i]) {
+            auto block = std::make_unique<BasicBlock>();
+            block->id = (int)blocks.size();
+            if (auto lbl = instrCast<LabelInstr>(instrs[i])) {
+                block->label = lbl->label;
+            }
+            blocks.push_back(std::move(block));
+        }
+        blocks.back()->instructions.push_back(instrs[i]);
+    }
+
+    // 根据块尾指令连接后继
+    std::unordered_map<OperandId, BasicBlock*> labelToBlock;
+    for (auto& block : blocks) {
+        if (block->label != kNoOperand) labelToBlock[block->label] = block.get();
+    }
+    auto findTarget = [&](OperandId label) -> BasicBlock* {
+        auto it = labelToBlock.find(label);
+        return it != labelToBlock.end() ? it->second : nullptr;
+    };
+    for (auto& block : blocks) {
+        IRInstr* last = block->instructions.back();
+        BasicBlock* next = nextBlock(block.get());
+
+        if (auto ifg = instrCast<IfGotoInstr>(last)) {
+            if (auto target = findTarget(ifg->target.id)) addEdge(block.get(), target);
+            if (next) addEdge(block.get(), next);
+        } else if (auto g = instrCast<GotoInstr>(last)) {
+            if (auto target = findTarget(g->target.id)) addEdge(block.get(), target);
+        } else if (last->opcode != OpCode::RETURN) {
+            // 其余指令（包括函数调用）顺序流入下一块
+            if (next) addEdge(block.get(), next);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+// IRModule
+//------------------------------------------------------------------------------
+
+// 按函数和块的顺序输出扁平的指令序列
+std::vector<IRInstr*> IRModule::linearize() const {
+    std::vector<IRInstr*> out;
+    for (auto& func : functions) {
+        func->appendInstructions(out);
+    }
+    return out;
+}
@@ -0,0 +1,252 @@
+// sccp.cpp - SSA 形式上的稀疏条件常量传播
+#include "irgen.h"
+#include <algorithm>
+
+/**
+ * 稀疏条件常量传播（Sparse Conditional Constant Propagation，Wegman-Zadeck）
+ *
+ * 同时求两样东西：哪些控制流边可执行，以及每个 SSA 值的常量状态。
+ * 块只有在某条入边可执行之后才被求值，φ 只合并来自可执行入边的值；
+ * 条件跳转的条件是常量时只有一条出边可执行，另一侧的代码不会让任何值变成非常量。
+ * 每个值只有一个定义，格值改变时只重新求值它的使用者，不需要按块逐变量迭代。
+ * 循环中每轮都取同一常量的变量也能被识别出来。
+ */
+
+// 格值：尚未确定（乐观初值）/ 常量 / 非常量，只会沿这个顺序下降
+enum class SCCPKind { Undefined, Constant, Overdefined };
+
+struct SCCPValue {
+    SCCPKind kind = SCCPKind::Undefined;
+    int constant = 0;       // 仅当 kind == SCCPKind::Constant 时有效
+
+    bool operator==(const SCCPValue& o) const {
+        return kind == o.kind && (kind != SCCPKind::Constant || constant == o.constant);
+    }
+};
+
+// meet：尚未确定的一方不影响结果，两个不同的常量合并为非常量
+static SCCPValue meetValues(const SCCPValue& a, const SCCPValue& b) {
+    if (a.kind == SCCPKind::Undefined) return b;
+    if (b.kind == SCCPKind::Undefined) return a;
+    if (a == b) return a;
+    return SCCPValue{SCCPKind::Overdefined, 0};
+}
+
+// 块的跳转目标：后继中以 label 开头的块，没有时返回空指针
+static BasicBlock* jumpTarget(const BasicBlock* block, OperandId label) {
+    for (BasicBlock* succ : block->successors) {
+        if (succ->label == label) return succ;
+    }
+    return nullptr;
+}
+
+/**
+ * 在 SSA 形式的函数上做稀疏条件常量传播，删除不可执行的分支和块
+ * 算法步骤：
+ * 1. 记录每个值的使用者；没有定义的值（形参、未赋值就读取的变量）为非常量，其余为尚未确定
+ * 2. 从入口出发交替处理两张工作表：边工作表中的边第一次可执行时求值目标块（块已求值过时只重新求值 φ），
+ *    值工作表中是格值下降的值的使用者，所在块可执行时重新求值；块尾的条件跳转按条件的格值决定哪些出边可执行
+ * 3. 把常量值的使用替换为常量并删除其定义；条件为常量的条件跳转改为无条件跳转或删去
+ * 4. 删除不可执行的边和块（保留含函数结束指令的最后一块），φ 只保留来自可执行入边的入口
+ */
+void IRGenerator::sparseConditionalConstantPropagation(IRFunction& func) {
+    auto& blocks = func.blocks;
+    if (blocks.empty()) return;
+    const size_t varCount = names.vregCount();
+    const size_t blockCount = blocks.size();
+
+    // ====== Step 1: 使用者与初值 ======
+    std::vector<SCCPValue> values(varCount);
+    std::vector<char> defined(varCount, 0);
+    std::vector<std::vector<std::pair<IRInstr*, BasicBlock*>>> users(varCount);
+    for (auto& block : blocks) {
+        for (auto instr : block->instructions) {
+            if (const Operand* def = defOperand(instr)) defined[def->id] = 1;
+            forEachUseOperand(instr, [&](Operand& use) { users[use.id].emplace_back(instr, block.get()); });
+        }
+    }
+    for (OperandId id = 0; id < varCount; ++id) {
+        if (!defined[id]) values[id] = SCCPValue{SCCPKind::Overdefined, 0};
+    }
+
+    // ====== Step 2: 求解 ======
+    std::vector<char> executable(blockCount, 0);
+    std::vector<std::vector<BasicBlock*>> executablePreds(blockCount);    // 每块可执行的入边的起点
+    std::vector<std::pair<BasicBlock*, BasicBlock*>> flowWorklist;        // （起点，终点），起点为空表示函数入口
+    std::vector<std::pair<IRInstr*, BasicBlock*>> ssaWorklist;            // （使用者，所在块）
+
+    auto valueOf = [&](const Operand& op) {
+        if (op.type == OperandType::CONSTANT) return SCCPValue{SCCPKind::Constant, op.value};
+        if (op.isReg()) return values[op.id];
+        return SCCPValue{SCCPKind::Overdefined, 0};
+    };
+    // 让定义的值下降到 value，值变化时它的使用者进入工作表
+    auto lower = [&](const Operand& def, const SCCPValue& value) {
+        SCCPValue merged = meetValues(values[def.id], value);
+        if (merged == values[def.id]) return;
+        values[def.id] = merged;
+        ssaWorklist.insert(ssaWorklist.end(), users[def.id].begin(), users[def.id].end());
+    };
+    auto isExecutableEdge = [&](BasicBlock* from, BasicBlock* to) {
+        auto& preds = executablePreds[to->id];
+        return std::find(preds.begin(), preds.end(), from) != preds.end();
+    };
+
+    auto visit = [&](IRInstr* instr, BasicBlock* block) {
+        switch (instr->opcode) {
+            case OpCode::PHI: {
+                auto phi = static_cast<PhiInstr*>(instr);
+                SCCPValue merged;
+                for (auto& in : phi->incoming) {
+                    if (isExecutableEdge(in.block, block)) merged = meetValues(merged, valueOf(in.value));
+                }
+                lower(phi->result, merged);
+                break;
+            }
+            case OpCode::ASSIGN: {
+                auto assign = static_cast<AssignInstr*>(instr);
+                lower(assign->target, valueOf(assign->source));
+                break;
+            }
+            case OpCode::NEG:
+            case OpCode::NOT: {
+                auto unaryOp = static_cast<UnaryOpInstr*>(instr);
+                SCCPValue operand = valueOf(unaryOp->operand);
+                if (operand.kind == SCCPKind::Constant) {
+                    operand.constant = evaluateUnaryOp(instr->opcode, operand.constant);
+                }
+                lower(unaryOp->result, operand);
+                break;
+            }
+            case OpCode::CALL: {
+                auto call = static_cast<CallInstr*>(instr);
+                if (!call->result.isNone()) lower(call->result, SCCPValue{SCCPKind::Overdefined, 0});
+                break;
+            }
+            case OpCode::IF_GOTO: {
+                auto ifg = static_cast<IfGotoInstr*>(instr);
+                SCCPValue cond = valueOf(ifg->condition);
+                if (cond.kind == SCCPKind::Undefined) break;
+
+                BasicBlock* taken = jumpTarget(block, ifg->target.id);
+                BasicBlock* next = func.nextBlock(block);
+                if (cond.kind == SCCPKind::Constant) {
+                    BasicBlock* succ = cond.constant ? taken : next;
+                    if (succ) flowWorklist.emplace_back(block, succ);
+                } else {
+                    for (BasicBlock* succ : block->successors) flowWorklist.emplace_back(block, succ);
+                }
+                break;
+            }
+            default:
+                if (auto binOp = instrCast<BinaryOpInstr>(instr)) {
+                    SCCPValue l = valueOf(binOp->left);
+                    SCCPValue r = valueOf(binOp->right);
+                    SCCPValue result;
+                    if (l.kind == SCCPKind::Overdefined || r.kind == SCCPKind::Overdefined) {
+                        result.kind = SCCPKind::Overdefined;
+                    } else if (l.kind == SCCPKind::Constant && r.kind == SCCPKind::Constant) {
+                        if (evaluateBinaryOp(binOp->opcode, l.constant, r.constant, result.constant)) {
+                            result.kind = SCCPKind::Constant;
+                        } else {
+                            result.kind = SCCPKind::Overdefined;
+                        }
+                    }
+                    lower(binOp->result, result);
+                }
+                break;
+        }
+    };
+
+    flowWorklist.emplace_back(nullptr, func.entry());
+    while (!flowWorklist.empty() || !ssaWorklist.empty()) {
+        while (!flowWorklist.empty()) {
+            auto [from, to] = flowWorklist.back();
+            flowWorklist.pop_back();
+            if (from) {
+                if (isExecutableEdge(from, to)) continue;
+                executablePreds[to->id].push_back(from);
+            }
+
+            if (executable[to->id]) {
+                // 块已求值过：新的入边只影响 φ
+                for (auto instr : to->instructions) {
+                    if (instr->opcode == OpCode::PHI) visit(instr, to);
+                    else if (instr->opcode != OpCode::LABEL) break;
+                }
+                continue;
+            }
+            executable[to->id] = 1;
+            for (auto instr : to->instructions) visit(instr, to);
+            // 条件跳转的出边在求值它时决定，其余块的出边都可执行
+            if (to->instructions.empty() || to->instructions.back()->opcode != OpCode::IF_GOTO) {
+                for (BasicBlock* succ : to->successors) flowWorklist.emplace_back(to, succ);
+            }
+        }
+        while (!ssaWorklist.empty()) {
+            auto [instr, block] = ssaWorklist.back();
+            ssaWorklist.pop_back();
+            if (executable[block->id]) visit(instr, block);
+        }
+    }
+
+    // ====== Step 3: 替换常量，化简条件跳转 ======
+    std::vector<bool> dead(blockCount);
+    for (auto& block : blocks) {
+        dead[block->id] = !executable[block->id];
+    }
+    dead[blockCount - 1] = false;
+
+    std::vector<IRInstr*> kept;
+    for (auto& block : blocks) {
+        if (dead[block->id]) continue;
+        auto& instrs = block->instructions;
+
+        kept.clear();
+        for (auto instr : instrs) {
+            forEachUseOperand(instr, [&](Operand& use) {
+                const SCCPValue& value = values[use.id];
+                if (value.kind == SCCPKind::Constant) use = makeConstantOperand(value.constant);
+            });
+            // 结果为常量的定义不再被使用（函数调用的结果总是非常量）
+            const Operand* def = defOperand(instr);
+            if (def && values[def->id].kind == SCCPKind::Constant) continue;
+            kept.push_back(instr);
+        }
+        instrs.assign(kept.begin(), kept.end());
+
+        if (instrs.empty()) continue;
+        auto ifg = instrCast<IfGotoInstr>(instrs.back());
+        if (!ifg || ifg->condition.type != OperandType::CONSTANT) continue;
+        BasicBlock* taken = jumpTarget(block.get(), ifg->target.id);
+        if (!taken) continue;
+        if (!ifg->condition.value || taken == func.nextBlock(block.get())) {
+            instrs.pop_back();
+        } else {
+            instrs.back() = func.makeInstr<GotoInstr>(ifg->target);
+        }
+    }
+
+    // ====== Step 4: 删除不可执行的边和块 ======
+    std::vector<PhiIncoming> incoming;
+    for (auto& block : blocks) {
+        if (dead[block->id]) continue;
+        std::vector<BasicBlock*> succs = block->successors;
+        for (BasicBlock* succ : succs) {
+            if (!isExecutableEdge(block.get(), succ)) IRFunction::removeEdge(block.get(), succ);
+        }
+        for (auto instr : block->instructions) {
+            auto phi = instrCast<PhiInstr>(instr);
+            if (!phi) {
+                if (instr->opcode == OpCode::LABEL) continue;
+                break;
+            }
+            incoming.clear();
+            for (auto& in : phi->incoming) {
+                if (isExecutableEdge(in.block, block.get())) incoming.push_back(in);
+            }
+            if (incoming.size() != phi->incoming.size()) phi->incoming = func.arena.copyList(incoming);
+        }
+    }
+    if (std::find(dead.begin(), dead.end(), true) != dead.end()) func.removeBlocks(dead);
+}
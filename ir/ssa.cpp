@@ -0,0 +1,484 @@
+// ssa.cpp - SSA 形式的构建与消去
+#include "irgen.h"
+#include "dataflow.h"
+#include "dominators.h"
+#include <algorithm>
+#include <unordered_set>
+
+/**
+ * SSA（静态单赋值）形式的构建和消去
+ *
+ * 构建：先删除不可达块，然后在每个变量定义块的迭代支配边界上放置 φ（只放在变量
+ * 活跃的汇合点，即剪枝 SSA），再沿支配树前序重命名，每个定义得到一个新版本。
+ * 形参和未经定义就读取的变量保留原编号，作为它们在函数入口处的值。
+ *
+ * 消去：拆分通往含 φ 的块的关键边，把每个前驱上的 φ 入口值作为一组并行复制，
+ * 顺序化后放到前驱末尾，然后把互不冲突的版本合并回原变量，消去多余的复制。
+ */
+
+// 块首的 φ 指令的下标范围 [first, last)：φ 紧跟在块首标签之后
+static std::pair<size_t, size_t> phiRange(const BasicBlock* block) {
+    size_t first = 0;
+    if (!block->instructions.empty() && instrCast<LabelInstr>(block->instructions[0])) first = 1;
+    size_t last = first;
+    while (last < block->instructions.size() && block->instructions[last]->opcode == OpCode::PHI) ++last;
+    return {first, last};
+}
+
+// 块是否会顺序流入下一块（空块总是顺序流过）
+static bool fallsThrough(const BasicBlock* block) {
+    if (block->instructions.empty()) return true;
+    OpCode last = block->instructions.back()->opcode;
+    return last != OpCode::GOTO && last != OpCode::RETURN;
+}
+
+// 删除从入口不可达的块；最后一块包含函数结束指令，代码生成在那里输出函数尾声，总是保留
+void IRGenerator::removeUnreachableBlocks(IRFunction& func) {
+    auto& blocks = func.blocks;
+    if (blocks.empty()) return;
+
+    // 从函数入口出发，用显式栈遍历避免深递归
+    std::vector<bool> reachable(blocks.size());
+    std::vector<BasicBlock*> stack{func.entry()};
+    reachable[func.entry()->id] = true;
+    while (!stack.empty()) {
+        BasicBlock* blk = stack.back();
+        stack.pop_back();
+        for (auto succ : blk->successors) {
+            if (!reachable[succ->id]) {
+                reachable[succ->id] = true;
+                stack.push_back(succ);
+            }
+        }
+    }
+    reachable[blocks.size() - 1] = true;
+
+    std::vector<bool> dead(blocks.size());
+    for (size_t i = 0; i < blocks.size(); ++i) dead[i] = !reachable[i];
+    func.removeBlocks(dead);
+}
+
+// 变量的原始编号：SSA 版本映射回构建 SSA 前的变量，其余编号映射到自身
+OperandId IRGenerator::ssaOriginOf(OperandId id) const {
+    return id < ssaOrigin.size() && ssaOrigin[id] != kNoOperand ? ssaOrigin[id] : id;
+}
+
+/**
+ * 把函数转换为剪枝 SSA 形式
+ * 算法步骤：
+ * 1. 删除不可达块，构建支配树、支配边界和活跃变量
+ * 2. 在每个变量定义块的迭代支配边界上、变量活跃的块中放置 φ
+ * 3. 沿支配树前序重命名：定义得到新版本，使用改为当前版本，并填写后继块中 φ 的入口值
+ */
+void IRGenerator::constructSSA(IRFunction& func) {
+    removeUnreachableBlocks(func);
+    if (func.blocks.empty()) return;
+
+    // ====== Step 1: 支配树、支配边界、活跃变量 ======
+    const size_t varCount = names.vregCount();
+    const size_t blockCount = func.blocks.size();
+    DominatorTree domTree(func);
+    std::vector<std::vector<BasicBlock*>> frontiers = domTree.frontiers();
+    std::vector<BitVector> liveIn = computeLiveness(func, varCount).in;
+
+    // 每个变量的定义块（按支配树前序，不重复）和操作数类型
+    std::vector<std::vector<BasicBlock*>> defBlocks(varCount);
+    std::vector<OperandType> varType(varCount, OperandType::VARIABLE);
+    for (BasicBlock* block : domTree.preorder()) {
+        for (auto instr : block->instructions) {
+            if (const Operand* def = defOperand(instr)) {
+                auto& list = defBlocks[def->id];
+                if (list.empty() || list.back() != block) list.push_back(block);
+                varType[def->id] = def->type;
+            }
+        }
+    }
+
+    // ====== Step 2: 放置 φ ======
+    // 每个块中新放置的 φ 及其对应的原变量
+    std::vector<std::vector<std::pair<PhiInstr*, OperandId>>> phis(blockCount);
+    std::vector<OperandId> hasPhi(blockCount, kNoOperand);      // 块中已为哪个变量放置了 φ
+    std::vector<OperandId> queued(blockCount, kNoOperand);      // 块已为哪个变量进过工作表
+    std::vector<BasicBlock*> worklist;
+    std::vector<PhiIncoming> incoming;
+    for (OperandId var = 0; var < varCount; ++var) {
+        if (defBlocks[var].empty()) continue;
+
+        worklist = defBlocks[var];
+        for (BasicBlock* block : worklist) queued[block->id] = var;
+        while (!worklist.empty()) {
+            BasicBlock* block = worklist.back();
+            worklist.pop_back();
+            for (BasicBlock* join : frontiers[block->id]) {
+                // 剪枝：变量在汇合点不活跃时不需要 φ
+                if (hasPhi[join->id] == var || !liveIn[join->id].test(var)) continue;
+                hasPhi[join->id] = var;
+
+                Operand original(varType[var], var);
+                PhiInstr* phi = func.makeInstr<PhiInstr>(original);
+                incoming.clear();
+                for (BasicBlock* pred : join->predecessors) incoming.push_back(PhiIncoming{pred, original});
+                phi->incoming = func.arena.copyList(incoming);
+                phis[join->id].emplace_back(phi, var);
+
+                // φ 也是一个定义，它所在的块同样要加入工作表
+                if (queued[join->id] != var) {
+                    queued[join->id] = var;
+                    worklist.push_back(join);
+                }
+            }
+        }
+    }
+
+    for (auto& block : func.blocks) {
+        auto& blockPhis = phis[block->id];
+        if (blockPhis.empty()) continue;
+        size_t at = phiRange(block.get()).first;
+        std::vector<IRInstr*> phiInstrs;
+        for (auto& [phi, var] : blockPhis) phiInstrs.push_back(phi);
+        block->instructions.insert(block->instructions.begin() + at, phiInstrs.begin(), phiInstrs.end());
+    }
+
+    // ====== Step 3: 重命名 ======
+    // 每个原变量的版本栈，栈空时当前版本就是原编号（形参或未定义的值）
+    std::vector<std::vector<OperandId>> versions(varCount);
+    std::vector<OperandId> pushed;      // 按压栈顺序记录的原变量，离开支配树结点时据此出栈
+    auto current = [&](OperandId var) { return versions[var].empty() ? var : versions[var].back(); };
+    auto rename = [&](Operand& def) {
+        OperandId var = def.id;
+        OperandId origin = ssaOriginOf(var);
+        OperandId id = names.vregId(names.vregName(origin) + "." + std::to_string(ssaNameCount++));
+        if (ssaOrigin.size() <= id) ssaOrigin.resize(id + 1, kNoOperand);
+        ssaOrigin[id] = origin;
+        versions[var].push_back(id);
+        pushed.push_back(var);
+        def.id = id;
+    };
+
+    // 沿支配树做深度优先遍历；栈中每项为（块，下一个要访问的子结点下标，进入时 pushed 的长度）
+    struct Frame {
+        BasicBlock* block;
+        size_t nextChild;
+        size_t pushedMark;
+    };
+    std::vector<Frame> stack;
+    auto enter = [&](BasicBlock* block) {
+        stack.push_back(Frame{block, 0, pushed.size()});
+        for (auto instr : block->instructions) {
+            // φ 的入口值由前驱填写，这里只重命名定义
+            if (instr->opcode != OpCode::PHI) {
+                forEachUseOperand(instr, [&](Operand& use) { use.id = current(use.id); });
+            }
+            if (Operand* def = defOperand(instr)) rename(*def);
+        }
+        for (BasicBlock* succ : block->successors) {
+            for (auto& [phi, var] : phis[succ->id]) {
+                for (auto& in : phi->incoming) {
+                    if (in.block == block) in.value.id = current(var);
+                }
+            }
+        }
+    };
+
+    enter(func.entry());
+    while (!stack.empty()) {
+        Frame& frame = stack.back();
+        const auto& children = domTree.children(frame.block);
+        if (frame.nextChild < children.size()) {
+            enter(children[frame.nextChild++]);
+        } else {
+            while (pushed.size() > frame.pushedMark) {
+                versions[pushed.back()].pop_back();
+                pushed.pop_back();
+            }
+            stack.pop_back();
+        }
+    }
+}
+
+/**
+ * 拆分控制流边 from -> to，返回插入在边上的新块
+ * 顺序流入的边：在两块之间插入空块。
+ * 跳转边：新块带新标签，放在 to 之前顺序流入 to，原跳转改跳到新标签；
+ * 如果 to 原来的前一块顺序流入 to，先在它们之间插入一个跳到 to 的块
+ */
+BasicBlock* IRGenerator::splitEdge(IRFunction& func, BasicBlock* from, BasicBlock* to) {
+    BasicBlock* middle = nullptr;
+    if (func.nextBlock(from) == to && (from->instructions.empty() ||
+                                       from->instructions.back()->opcode != OpCode::GOTO)) {
+        middle = func.insertBlock(to->id);
+    } else {
+        BasicBlock* prev = func.blocks[to->id - 1].get();
+        if (fallsThrough(prev)) {
+            BasicBlock* jump = splitEdge(func, prev, to);
+            jump->instructions.push_back(func.makeInstr<GotoInstr>(Operand(OperandType::LABEL, to->label)));
+        }
+
+        middle = func.insertBlock(to->id);
+        Operand label = createLabel();
+        middle->label = label.id;
+        middle->instructions.push_back(func.makeInstr<LabelInstr>(label.id));
+
+        IRInstr* last = from->instructions.back();
+        if (auto g = instrCast<GotoInstr>(last)) {
+            g->target = label;
+        } else if (auto ifg = instrCast<IfGotoInstr>(last)) {
+            ifg->target = label;
+        }
+    }
+
+    IRFunction::removeEdge(from, to);
+    IRFunction::addEdge(from, middle);
+    IRFunction::addEdge(middle, to);
+
+    // to 中 φ 来自 from 的入口改为来自新块
+    auto [first, last] = phiRange(to);
+    for (size_t i = first; i < last; ++i) {
+        for (auto& in : static_cast<PhiInstr*>(to->instructions[i])->incoming) {
+            if (in.block == from) in.block = middle;
+        }
+    }
+    return middle;
+}
+
+/**
+ * 把一组并行复制（所有源在任何目标被写之前读取）顺序化为赋值指令
+ * 每次输出一条目标不再被其余复制读取的复制；剩下的都在环上时，
+ * 把其中一个目标的旧值存入新的临时变量，改由临时变量提供给读它的复制，从而打开环
+ * @param copies （目标，源）对，目标互不相同
+ * @param out 顺序化后的赋值指令追加到这里
+ */
+void IRGenerator::sequentializeCopies(IRFunction& func, std::vector<std::pair<Operand, Operand>> copies,
+                                      std::vector<IRInstr*>& out) {
+    // 自身复制没有效果
+    copies.erase(std::remove_if(copies.begin(), copies.end(), [](const std::pair<Operand, Operand>& c) {
+        return c.second.isReg() && c.second.id == c.first.id;
+    }), copies.end());
+
+    auto isRead = [&](OperandId id) {
+        for (auto& c : copies) {
+            if (c.second.isReg() && c.second.id == id) return true;
+        }
+        return false;
+    };
+
+    while (!copies.empty()) {
+        auto ready = std::find_if(copies.begin(), copies.end(),
+                                  [&](const std::pair<Operand, Operand>& c) { return !isRead(c.first.id); });
+        if (ready != copies.end()) {
+            out.push_back(func.makeInstr<AssignInstr>(ready->first, ready->second));
+            copies.erase(ready);
+            continue;
+        }
+
+        // 所有目标都还要被读取：都在环上
+        Operand saved = copies.front().first;
+        Operand temp = createTemp();
+        out.push_back(func.makeInstr<AssignInstr>(temp, saved));
+        for (auto& c : copies) {
+            if (c.second.isReg() && c.second.id == saved.id) c.second = temp;
+        }
+    }
+}
+
+/**
+ * 把 SSA 形式的函数转换回普通的三地址码
+ * 算法步骤：
+ * 1. 拆分通往含 φ 的块的关键边（前驱有多个后继）
+ * 2. 每个前驱上的 φ 入口值组成一组并行复制，顺序化后放到前驱末尾的跳转之前，然后删除 φ
+ * 3. 把同一原变量中互不冲突的版本合并回原变量，删除由此产生的自身复制
+ * 4. 撤销最终没有放入复制的边拆分
+ */
+void IRGenerator::destructSSA(IRFunction& func) {
+    // ====== Step 1: 拆分关键边 ======
+    // 插入的块都在当前块之前，当前块之后会被再次访问，那时它已没有关键边
+    std::unordered_set<const BasicBlock*> original;
+    for (auto& block : func.blocks) original.insert(block.get());
+    for (size_t i = 0; i < func.blocks.size(); ++i) {
+        BasicBlock* block = func.blocks[i].get();
+        auto [first, last] = phiRange(block);
+        if (first == last) continue;
+
+        std::vector<BasicBlock*> preds = block->predecessors;
+        for (BasicBlock* pred : preds) {
+            // 拆分其它边时可能已经把这条边转移到了新块上
+            auto& current = block->predecessors;
+            if (std::find(current.begin(), current.end(), pred) == current.end()) continue;
+            if (pred->successors.size() > 1) splitEdge(func, pred, block);
+        }
+    }
+
+    // ====== Step 2: 在前驱末尾插入顺序化的并行复制，删除 φ ======
+    std::vector<std::vector<std::pair<Operand, Operand>>> copies(func.blocks.size());
+    for (auto& block : func.blocks) {
+        auto [first, last] = phiRange(block.get());
+        for (size_t i = first; i < last; ++i) {
+            auto phi = static_cast<PhiInstr*>(block->instructions[i]);
+            for (auto& in : phi->incoming) copies[in.block->id].emplace_back(phi->result, in.value);
+        }
+        block->instructions.erase(block->instructions.begin() + first, block->instructions.begin() + last);
+    }
+
+    std::vector<IRInstr*> sequence;
+    for (auto& block : func.blocks) {
+        if (copies[block->id].empty()) continue;
+        auto& instrs = block->instructions;
+
+        // 前驱现在只有一个后继；以条件跳转结尾时两条出边去往同一块，条件跳转没有作用
+        if (!instrs.empty() && instrs.back()->opcode == OpCode::IF_GOTO) instrs.pop_back();
+
+        sequence.clear();
+        sequentializeCopies(func, std::move(copies[block->id]), sequence);
+        auto at = !instrs.empty() && instrs.back()->opcode == OpCode::GOTO ? instrs.end() - 1 : instrs.end();
+        instrs.insert(at, sequence.begin(), sequence.end());
+    }
+
+    // ====== Step 3: 合并版本 ======
+    coalesceSSAVersions(func);
+
+    // ====== Step 4: 撤销没有用上的边拆分 ======
+    // 拆分出的块只剩标签时，原跳转改回跳到后继；只剩跳到下一块的 goto 时删去 goto；
+    // 最后删除空块，它们没有标签，只会被顺序流入
+    std::vector<bool> dead(func.blocks.size());
+    bool anyDead = false;
+    auto bypass = [&](BasicBlock* block) {
+        BasicBlock* succ = block->successors[0];
+        std::vector<BasicBlock*> preds = block->predecessors;
+        for (BasicBlock* pred : preds) {
+            IRFunction::removeEdge(pred, block);
+            IRFunction::addEdge(pred, succ);
+        }
+        IRFunction::removeEdge(block, succ);
+        dead[block->id] = true;
+        anyDead = true;
+    };
+    for (auto& block : func.blocks) {
+        if (original.count(block.get()) || block->instructions.size() != 1 || block->successors.size() != 1) continue;
+        if (auto label = instrCast<LabelInstr>(block->instructions[0])) {
+            updateJumpTargets(func, label->label, block->successors[0]->label);
+            block->instructions.clear();
+            bypass(block.get());
+        }
+    }
+    for (auto& block : func.blocks) {
+        if (dead[block->id] || original.count(block.get()) || block->instructions.size() != 1) continue;
+        auto jump = instrCast<GotoInstr>(block->instructions[0]);
+        BasicBlock* next = func.nextBlock(block.get());
+        while (next && dead[next->id]) next = func.nextBlock(next);
+        if (jump && next && next->label == jump->target.id) block->instructions.clear();
+    }
+    for (auto& block : func.blocks) {
+        if (!dead[block->id] && block->instructions.empty() && block->successors.size() == 1) bypass(block.get());
+    }
+    if (anyDead) func.removeBlocks(dead);
+}
+
+/**
+ * 把同一原变量的 SSA 版本合并回原变量，使没有经过变换的代码恢复原来的变量
+ * 两个版本冲突，当且仅当一个在另一个的定义处活跃（定义是从另一个复制而来的除外，此时二者的值相同）。
+ * 每个原变量按编号顺序贪心地接纳与已接纳的版本都不冲突的版本，最后删除变成自身复制的赋值
+ * 算法步骤：
+ * 1. 反向扫描每个块，按原变量分组维护当前活跃的版本；每个定义只与同组中活跃的版本比较，记下冲突
+ * 2. 冲突按（较大编号，较小编号）排序；按编号顺序处理版本时，只需二分找到它与编号更小的版本的冲突，
+ *    查看其中是否有已并入原变量的版本，代价与冲突数成正比
+ */
+void IRGenerator::coalesceSSAVersions(IRFunction& func) {
+    const size_t varCount = names.vregCount();
+
+    // 每个原变量的成员：原变量自身和它的各个版本
+    std::vector<std::vector<OperandId>> members(varCount);
+    for (OperandId id = 0; id < varCount; ++id) {
+        OperandId origin = ssaOriginOf(id);
+        if (origin != id) {
+            if (members[origin].empty()) members[origin].push_back(origin);
+            members[origin].push_back(id);
+        }
+    }
+
+    // ====== Step 1: 冲突 ======
+    // 每个原变量当前活跃的成员；livePos 为成员在其中的位置，不活跃时为 kNotLive
+    constexpr uint32_t kNotLive = UINT32_MAX;
+    std::vector<std::vector<OperandId>> liveMembers(varCount);
+    std::vector<uint32_t> livePos(varCount, kNotLive);
+    std::vector<OperandId> touched;     // 本块中曾置为活跃的成员，块扫描完后逐个清除
+    auto setLive = [&](OperandId id) {
+        OperandId origin = ssaOriginOf(id);
+        if (livePos[id] != kNotLive || members[origin].empty()) return;
+        livePos[id] = static_cast<uint32_t>(liveMembers[origin].size());
+        liveMembers[origin].push_back(id);
+        touched.push_back(id);
+    };
+    auto resetLive = [&](OperandId id) {
+        if (livePos[id] == kNotLive) return;
+        auto& live = liveMembers[ssaOriginOf(id)];
+        OperandId last = live.back();
+        live[livePos[id]] = last;
+        livePos[last] = livePos[id];
+        live.pop_back();
+        livePos[id] = kNotLive;
+    };
+
+    // 冲突的版本对，按（较大编号，较小编号）记录
+    std::vector<std::pair<OperandId, OperandId>> conflicts;
+    std::vector<BitVector> liveOut = computeLiveness(func, varCount).out;
+    for (auto& block : func.blocks) {
+        touched.clear();
+        liveOut[block->id].forEach([&](size_t id) { setLive(static_cast<OperandId>(id)); });
+        for (auto it = block->instructions.rbegin(); it != block->instructions.rend(); ++it) {
+            IRInstr* instr = *it;
+            if (const Operand* def = defOperand(instr)) {
+                OperandId copiedFrom = kNoOperand;
+                if (auto assign = instrCast<AssignInstr>(instr)) {
+                    if (assign->isSimpleCopy()) copiedFrom = assign->source.id;
+                }
+                for (OperandId other : liveMembers[ssaOriginOf(def->id)]) {
+                    if (other != def->id && other != copiedFrom) {
+                        conflicts.emplace_back(std::max(other, def->id), std::min(other, def->id));
+                    }
+                }
+                resetLive(def->id);
+            }
+            forEachUseOperand(instr, [&](const Operand& u) { setLive(u.id); });
+        }
+        for (OperandId id : touched) resetLive(id);
+    }
+    std::sort(conflicts.begin(), conflicts.end());
+
+    // ====== Step 2: 贪心合并 ======
+    // replacement[id] 为合并后的编号；成员按编号从小到大处理，原变量自身最先
+    std::vector<OperandId> replacement(varCount, kNoOperand);
+    bool anyMerged = false;
+    for (OperandId origin = 0; origin < varCount; ++origin) {
+        if (members[origin].empty()) continue;
+        replacement[origin] = origin;
+        for (size_t i = 1; i < members[origin].size(); ++i) {
+            OperandId version = members[origin][i];
+            auto next = std::lower_bound(conflicts.begin(), conflicts.end(), std::make_pair(version, OperandId(0)));
+            bool free = true;
+            for (; next != conflicts.end() && next->first == version; ++next) {
+                if (replacement[next->second] == origin) free = false;
+            }
+            if (free) {
+                replacement[version] = origin;
+                anyMerged = true;
+            }
+        }
+        replacement[origin] = kNoOperand;
+    }
+    if (!anyMerged) return;
+
+    auto replace = [&](Operand& op) {
+        if (op.isReg() && replacement[op.id] != kNoOperand) op.id = replacement[op.id];
+    };
+    for (auto& block : func.blocks) {
+        auto& instrs = block->instructions;
+        for (auto instr : instrs) {
+            forEachUseOperand(instr, replace);
+            if (Operand* def = defOperand(instr)) replace(*def);
+        }
+        instrs.erase(std::remove_if(instrs.begin(), instrs.end(), [](IRInstr* instr) {
+            auto assign = instrCast<AssignInstr>(instr);
+            return assign && assign->isSimpleCopy() && assign->source.id == assign->target.id;
+        }), instrs.end());
+    }
+}
@@ -1,6 +1,8 @@
 // Token.h - 定义了词法分析过程中产生的标记（Token）的结构和类型
 #pragma once
-#include <string>
+#include "common/stringInterner.h"
+#include "lexer/sourceManager.h"
+#include <cstdint>
 
 // TokenType 枚举类 - 定义了所有可能的标记类型
 enum class TokenType {
@@ -23,13 +25,16 @@ enum class TokenType {
     END_OF_FILE, UNKNOWN
 };
 // Token 结构体 - 表示源代码中的一个词法单元
+// 只记录类型和在源代码中的范围，词素与行列号都通过 SourceManager 按需取得
 struct Token {
-    TokenType type;     // 标记类型
-    std::string lexeme; // 词素（标记的原始文本）
-    int line;           // 标记在源代码中的行号
-    int column;         // 标记在源代码中的列号
+    TokenType type;       // 标记类型
+    SourceOffset offset;  // 词素在源代码中的起始偏移量
+    uint32_t length;      // 词素长度
+    SymbolId symbol;      // 标识符的驻留编号，其它标记为 kNoSymbol
     
+    // 默认构造函数 - 供缓冲区预分配使用
+    Token() : type(TokenType::UNKNOWN), offset(0), length(0), symbol(kNoSymbol) {}
     // 构造函数 - 初始化一个标记
-    Token(TokenType type, const std::string& lexeme, int line, int column)
-        : type(type), lexeme(lexeme), line(line), column(column) {}
+    Token(TokenType type, SourceOffset offset, uint32_t length, SymbolId symbol = kNoSymbol)
+        : type(type), offset(offset), length(length), symbol(symbol) {}
 };
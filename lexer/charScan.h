@@ -0,0 +1,222 @@
+// lexer/charScan.h - 词法分析器的批量字符扫描：空白、注释与标识符
+// 支持 AVX2（每次 32 字节）和 SSE2（每次 16 字节），不支持时退回到查表的标量实现
+// 定义 TOYC_NO_SIMD 可强制使用标量实现
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if !defined(TOYC_NO_SIMD) && (defined(__AVX2__) || defined(__SSE2__))
+#include <immintrin.h>
+#define TOYC_LEXER_SIMD 1
+#endif
+
+namespace charscan {
+
+constexpr size_t npos = static_cast<size_t>(-1);
+
+// 字符类别位图：每类 256 位，按字符编码索引
+struct CharClassBitmap {
+    uint64_t bits[4] = {0, 0, 0, 0};
+
+    constexpr void set(unsigned char c) { bits[c >> 6] |= uint64_t(1) << (c & 63); }
+    constexpr bool test(unsigned char c) const { return (bits[c >> 6] >> (c & 63)) & 1; }
+};
+
+constexpr CharClassBitmap makeBlankBitmap() {
+    CharClassBitmap map;
+    map.set(' ');
+    map.set('\t');
+    map.set('\r');
+    map.set('\n');
+    return map;
+}
+
+constexpr CharClassBitmap makeIdentBitmap() {
+    CharClassBitmap map;
+    for (int c = 'a'; c <= 'z'; c++) map.set(static_cast<unsigned char>(c));
+    for (int c = 'A'; c <= 'Z'; c++) map.set(static_cast<unsigned char>(c));
+    for (int c = '0'; c <= '9'; c++) map.set(static_cast<unsigned char>(c));
+    map.set('_');
+    return map;
+}
+
+constexpr CharClassBitmap kBlankChars = makeBlankBitmap();  // 空白字符：空格、制表、回车、换行
+constexpr CharClassBitmap kIdentChars = makeIdentBitmap();  // 标识符后续字符：字母、数字、下划线
+
+inline bool isBlank(char c) { return kBlankChars.test(static_cast<unsigned char>(c)); }
+inline bool isIdentChar(char c) { return kIdentChars.test(static_cast<unsigned char>(c)); }
+inline bool isIdentStart(char c) { return c == '_' || (isIdentChar(c) && !(c >= '0' && c <= '9')); }
+
+#ifdef TOYC_LEXER_SIMD
+// === 向量化的字符分类：每个函数返回一块数据的位掩码，第 i 位对应第 i 个字节 ===
+#if defined(__AVX2__)
+constexpr size_t kBlock = 32;
+using Vec = __m256i;
+inline Vec load(const char* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+inline Vec splat(char c) { return _mm256_set1_epi8(c); }
+inline Vec eq(Vec a, Vec b) { return _mm256_cmpeq_epi8(a, b); }
+inline Vec gt(Vec a, Vec b) { return _mm256_cmpgt_epi8(a, b); }
+inline Vec vor(Vec a, Vec b) { return _mm256_or_si256(a, b); }
+inline Vec vand(Vec a, Vec b) { return _mm256_and_si256(a, b); }
+inline uint32_t movemask(Vec v) { return static_cast<uint32_t>(_mm256_movemask_epi8(v)); }
+#else
+constexpr size_t kBlock = 16;
+using Vec = __m128i;
+inline Vec load(const char* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+inline Vec splat(char c) { return _mm_set1_epi8(c); }
+inline Vec eq(Vec a, Vec b) { return _mm_cmpeq_epi8(a, b); }
+inline Vec gt(Vec a, Vec b) { return _mm_cmpgt_epi8(a, b); }
+inline Vec vor(Vec a, Vec b) { return _mm_or_si128(a, b); }
+inline Vec vand(Vec a, Vec b) { return _mm_and_si128(a, b); }
+inline uint32_t movemask(Vec v) { return static_cast<uint32_t>(_mm_movemask_epi8(v)); }
+#endif
+
+// 整块都满足条件时的掩码
+constexpr uint32_t kFullMask = kBlock == 32 ? 0xffffffffu : 0xffffu;
+
+inline uint32_t byteMask(const char* p, char c) {
+    return movemask(eq(load(p), splat(c)));
+}
+
+inline uint32_t blankMask(const char* p) {
+    Vec v = load(p);
+    return movemask(vor(vor(eq(v, splat(' ')), eq(v, splat('\t'))),
+                        vor(eq(v, splat('\r')), eq(v, splat('\n')))));
+}
+
+// 有符号比较下，0x80 以上的字节为负数，不会落入任何区间
+inline uint32_t identMask(const char* p) {
+    Vec v = load(p);
+    Vec lower = vor(v, splat(0x20));  // 大写字母转为小写
+    Vec letter = vand(gt(lower, splat('a' - 1)), gt(splat('z' + 1), lower));
+    Vec digit = vand(gt(v, splat('0' - 1)), gt(splat('9' + 1), v));
+    return movemask(vor(vor(letter, digit), eq(v, splat('_'))));
+}
+
+#endif
+
+/*
+ * 统计区间内换行符的个数（按块取掩码后做位计数）
+ * @param p 起始位置
+ * @param n 区间长度
+ * @return 换行符个数
+*/
+inline size_t countNewlines(const char* p, size_t n) {
+    size_t count = 0;
+    size_t i = 0;
+#ifdef TOYC_LEXER_SIMD
+    for (; i + kBlock <= n; i += kBlock) {
+        count += static_cast<size_t>(__builtin_popcount(byteMask(p + i, '\n')));
+    }
+#endif
+    for (; i < n; i++) {
+        count += p[i] == '\n';
+    }
+    return count;
+}
+
+/*
+ * 按顺序对区间内每个换行符的相对位置调用 visit
+ * @param p 起始位置
+ * @param n 区间长度
+ * @param visit 回调，参数为换行符的相对位置
+*/
+template <typename Visitor>
+inline void forEachNewline(const char* p, size_t n, Visitor&& visit) {
+    size_t i = 0;
+#ifdef TOYC_LEXER_SIMD
+    for (; i + kBlock <= n; i += kBlock) {
+        // 依次取出掩码中最低的置位
+        for (uint32_t mask = byteMask(p + i, '\n'); mask; mask &= mask - 1) {
+            visit(i + static_cast<size_t>(__builtin_ctz(mask)));
+        }
+    }
+#endif
+    for (; i < n; i++) {
+        if (p[i] == '\n') visit(i);
+    }
+}
+
+/*
+ * 跳过连续的空白字符
+ * @param p 起始位置
+ * @param n 剩余长度
+ * @return 空白字符的个数
+*/
+inline size_t skipBlanks(const char* p, size_t n) {
+    size_t i = 0;
+#ifdef TOYC_LEXER_SIMD
+    for (; i + kBlock <= n; i += kBlock) {
+        uint32_t blank = blankMask(p + i);
+        if (blank != kFullMask) {
+            // 第一个非空白字符之前的部分才算被跳过
+            return i + static_cast<size_t>(__builtin_ctz(~blank));
+        }
+    }
+#endif
+    while (i < n && isBlank(p[i])) {
+        i++;
+    }
+    return i;
+}
+
+/*
+ * 查找多行注释的结束符（'*' 后紧跟 '/'）
+ * @param p 注释内容的起始位置（已跳过开头的两个字符）
+ * @param n 剩余长度
+ * @return 结束符中 '*' 的相对位置，未找到时返回 npos
+*/
+inline size_t findBlockCommentEnd(const char* p, size_t n) {
+    size_t i = 0;
+#ifdef TOYC_LEXER_SIMD
+    // 每块最后一个字节的 '/' 可能属于下一块，因此只在 i + kBlock < n 时按块处理
+    for (; i + kBlock < n; i += kBlock) {
+        uint32_t star = byteMask(p + i, '*');
+        uint32_t slash = byteMask(p + i + 1, '/');
+        uint32_t end = star & slash;
+        if (end) {
+            return i + static_cast<size_t>(__builtin_ctz(end));
+        }
+    }
+#endif
+    for (; i + 1 < n; i++) {
+        if (p[i] == '*' && p[i + 1] == '/') {
+            return i;
+        }
+    }
+    return npos;
+}
+
+/*
+ * 查找单行注释的结束位置（换行符）
+ * @return 换行符的相对位置，未找到时返回 n
+*/
+inline size_t findLineEnd(const char* p, size_t n) {
+    const void* newline = std::memchr(p, '\n', n);
+    return newline ? static_cast<size_t>(static_cast<const char*>(newline) - p) : n;
+}
+
+/*
+ * 计算标识符后续字符（字母、数字、下划线）的连续长度
+ * @param p 起始位置
+ * @param n 剩余长度
+ * @return 连续标识符字符的个数
+*/
+inline size_t identLength(const char* p, size_t n) {
+    size_t i = 0;
+#ifdef TOYC_LEXER_SIMD
+    for (; i + kBlock <= n; i += kBlock) {
+        uint32_t ident = identMask(p + i);
+        if (ident != kFullMask) {
+            return i + static_cast<size_t>(__builtin_ctz(~ident));
+        }
+    }
+#endif
+    while (i < n && isIdentChar(p[i])) {
+        i++;
+    }
+    return i;
+}
+
+} // namespace charscan
@@ -1,72 +1,96 @@
 #include "lexer.h"
+#include <array>
 #include <cctype>
 #include <iostream>
 #include <stdexcept>
 
+namespace {
+
 /*
- * Lexer 类的构造函数
- * 初始化词法分析器的状态和关键字映射表
- * @param source 源代码字符串
+ * 关键字识别：先按长度、再按首字符分派，最后比较一次完整字符串
+ * 整个函数在编译期求值，不需要运行时构造任何查找表
+ * @param text 标识符文本
+ * @return 关键字对应的标记类型，不是关键字时返回 IDENTIFIER
 */
-
-// 默认构造函数
-Lexer::Lexer() : source(""), position(0), line(1), column(1) {
-    // 初始化关键字映射表
-    keywords["int"] = TokenType::INT;
-    keywords["void"] = TokenType::VOID;
-    keywords["if"] = TokenType::IF;
-    keywords["else"] = TokenType::ELSE;
-    keywords["while"] = TokenType::WHILE;
-    keywords["break"] = TokenType::BREAK;
-    keywords["continue"] = TokenType::CONTINUE;
-    keywords["return"] = TokenType::RETURN;
-    
-    // 初始化运算符映射表
-    initOperators();
+constexpr TokenType keywordType(std::string_view text) {
+    switch (text.size()) {
+        case 2:
+            if (text == "if") return TokenType::IF;
+            break;
+        case 3:
+            if (text == "int") return TokenType::INT;
+            break;
+        case 4:
+            if (text[0] == 'v' && text == "void") return TokenType::VOID;
+            if (text[0] == 'e' && text == "else") return TokenType::ELSE;
+            break;
+        case 5:
+            if (text[0] == 'w' && text == "while") return TokenType::WHILE;
+            if (text[0] == 'b' && text == "break") return TokenType::BREAK;
+            break;
+        case 6:
+            if (text == "return") return TokenType::RETURN;
+            break;
+        case 8:
+            if (text == "continue") return TokenType::CONTINUE;
+            break;
+    }
+    return TokenType::IDENTIFIER;
 }
 
-// 带参数的构造函数
-Lexer::Lexer(const std::string& source) : source(source), position(0), line(1), column(1) {
-    // 初始化关键字映射表
-    keywords["int"] = TokenType::INT;
-    keywords["void"] = TokenType::VOID;
-    keywords["if"] = TokenType::IF;
-    keywords["else"] = TokenType::ELSE;
-    keywords["while"] = TokenType::WHILE;
-    keywords["break"] = TokenType::BREAK;
-    keywords["continue"] = TokenType::CONTINUE;
-    keywords["return"] = TokenType::RETURN;
+static_assert(keywordType("int") == TokenType::INT, "keyword table broken");
+static_assert(keywordType("continue") == TokenType::CONTINUE, "keyword table broken");
+static_assert(keywordType("whilex") == TokenType::IDENTIFIER, "keyword table broken");
 
-    // 初始化运算符映射表
-    initOperators();
-}
+// 运算符分派表项：首字符单独成符时的类型，以及可与之组成双字符运算符的第二个字符
+struct OperatorEntry {
+    TokenType single = TokenType::UNKNOWN; // 单字符时的类型
+    char second = '\0';                    // 双字符运算符的第二个字符，'\0' 表示没有
+    TokenType pair = TokenType::UNKNOWN;   // 双字符时的类型
+};
 
-// 初始化运算符映射表
-// 将所有ToyC支持的运算符和标点符号映射到对应的标记类型
-void Lexer::initOperators() {
-    operators["="] = TokenType::ASSIGN;
-    operators["+"] = TokenType::PLUS;
-    operators["-"] = TokenType::MINUS;
-    operators["*"] = TokenType::MULTIPLY;
-    operators["/"] = TokenType::DIVIDE;
-    operators["%"] = TokenType::MODULO;
-    operators["<"] = TokenType::LT;
-    operators[">"] = TokenType::GT;
-    operators["<="] = TokenType::LE;
-    operators[">="] = TokenType::GE;
-    operators["=="] = TokenType::EQ;
-    operators["!="] = TokenType::NEQ;
-    operators["&&"] = TokenType::AND;
-    operators["||"] = TokenType::OR;
-    operators["!"] = TokenType::NOT;
-    operators["("] = TokenType::LPAREN;
-    operators[")"] = TokenType::RPAREN;
-    operators["{"] = TokenType::LBRACE;
-    operators["}"] = TokenType::RBRACE;
-    operators[";"] = TokenType::SEMICOLON;
-    operators[","] = TokenType::COMMA;
+// 按首字符直接索引的运算符和分隔符表，在编译期生成
+constexpr std::array<OperatorEntry, 256> makeOperatorTable() {
+    std::array<OperatorEntry, 256> table{};
+    auto set = [&table](char c, TokenType single, char second = '\0', TokenType pair = TokenType::UNKNOWN) {
+        OperatorEntry& entry = table[static_cast<unsigned char>(c)];
+        entry.single = single;
+        entry.second = second;
+        entry.pair = pair;
+    };
+    set('(', TokenType::LPAREN);
+    set(')', TokenType::RPAREN);
+    set('{', TokenType::LBRACE);
+    set('}', TokenType::RBRACE);
+    set(';', TokenType::SEMICOLON);
+    set(',', TokenType::COMMA);
+    set('+', TokenType::PLUS);
+    set('-', TokenType::MINUS);
+    set('*', TokenType::MULTIPLY);
+    set('/', TokenType::DIVIDE);
+    set('%', TokenType::MODULO);
+    set('=', TokenType::ASSIGN, '=', TokenType::EQ);
+    set('!', TokenType::NOT, '=', TokenType::NEQ);
+    set('<', TokenType::LT, '=', TokenType::LE);
+    set('>', TokenType::GT, '=', TokenType::GE);
+    set('&', TokenType::UNKNOWN, '&', TokenType::AND);   // 单个 '&' 不是合法符号
+    set('|', TokenType::UNKNOWN, '|', TokenType::OR);    // 单个 '|' 不是合法符号
+    return table;
 }
 
+constexpr std::array<OperatorEntry, 256> kOperatorTable = makeOperatorTable();
+
+} // namespace
+
+/*
+ * Lexer 类的构造函数
+ * 关键字和运算符都在编译期识别，构造时无需初始化任何表
+ * @param sources 源代码管理器
+ * @param identifiers 标识符驻留表
+*/
+Lexer::Lexer(const SourceManager& sources, StringInterner& identifiers)
+    : sources(sources), source(sources.text()), identifiers(identifiers), position(0) {}
+
 /*
  * 将源代码转换为标记序列
  * @return 包含所有标记的向量
@@ -85,7 +109,7 @@ std::vector<Token> Lexer::tokenize() {
     }
     
     // 添加文件结束标记
-    tokens.push_back(Token(TokenType::END_OF_FILE, "", line, column));
+    tokens.push_back(makeToken(TokenType::END_OF_FILE, position));
     return tokens;
 }
 
@@ -106,15 +130,7 @@ char Lexer::peek(int offset) const {
  * @return 当前字符
 */
 char Lexer::advance() {
-    char current = source[position++];
-    // 更新行列信息
-    if (current == '\n') {
-        line++;
-        column = 1;
-    } else {
-        column++;
-    }
-    return current;
+    return source[position++];
 }
 
 
@@ -126,69 +142,45 @@ bool Lexer::isAtEnd() const {
     return position >= source.length();
 }
 
+/*
+ * 以 [start, position) 范围构造标记
+ * @param type 标记类型
+ * @param start 词素起始偏移量
+ * @return 新的标记
+*/
+Token Lexer::makeToken(TokenType type, SourceOffset start) const {
+    return Token(type, start, position - start);
+}
+
 /*
  * 跳过空白字符和注释
  * 处理空格、制表符、回车符、换行符以及单行和多行注释
+ * 空白按块批量跳过，行列号不在这里维护
 */
 void Lexer::skipWhitespace() {
     while (!isAtEnd()) {
-        char c = peek();
-        switch (c) {
-            //空白字符
-            case ' ':
-            case '\t':
-            case '\r':
-                advance();
-                break;
-            case '\n':
-                advance();
-                break;
-            
-            case '/':
-                if (peek(1) == '/' || peek(1) == '*') {
-                    skipComment();
-                } else {
-                    return;
-                }
-                break;
-            default:
-                return;
+        position += static_cast<SourceOffset>(charscan::skipBlanks(source.data() + position, source.size() - position));
+
+        if (peek() == '/' && (peek(1) == '/' || peek(1) == '*')) {
+            skipComment();
+        } else {
+            return;
         }
     }
 }
 
 // 跳过注释
 void Lexer::skipComment() {
-    char c = peek();
-    if (c == '/') {
-        // 单行注释
-        if (peek(1) == '/') {
-            position += 2;
-            column += 2;
-            while (!isAtEnd() && peek() != '\n') {
-                advance();
-            }
-        }
-        // 多行注释
-        else if (peek(1) == '*') {
-            position += 2;
-            column += 2;
-            while (!isAtEnd()) {
-                if (peek() == '*' && peek(1) == '/') {
-                    position += 2;
-                    column += 2;
-                    break;
-                }
-                if (peek() == '\n') {
-                    line++;
-                    column = 1;
-                    position++;
-                } else {
-                    position++;
-                    column++;
-                }
-            }
-        }
+    const char* start = source.data() + position;
+    size_t remaining = source.size() - position;
+    // 单行注释：跳到换行符之前，换行符留给空白处理
+    if (peek(1) == '/') {
+        position += static_cast<SourceOffset>(charscan::findLineEnd(start, remaining));
+    }
+    // 多行注释：找到结束符后一次性跳过
+    else if (peek(1) == '*') {
+        size_t end = charscan::findBlockCommentEnd(start + 2, remaining - 2);
+        position += static_cast<SourceOffset>(end == charscan::npos ? remaining : end + 4);
     }
 }
 
@@ -199,90 +191,20 @@ void Lexer::skipComment() {
  * @return 下一个标记
 */
 Token Lexer::scanToken() {
-    char c = advance();
+    char c = peek();
     
     // 标识符或关键字（以字母或下划线开头）
-    if (isalpha(c) || c == '_') {
-        position--; // 回退一步，让scanIdentifier处理
-        column--;
+    if (charscan::isIdentStart(c)) {
         return scanIdentifier();
     }
     
     // 数字（以数字开头）
     if (isdigit(c)) {
-        position--; // 回退一步，让scanNumber处理
-        column--;
         return scanNumber();
     }
-    //记录当前标记的行列位置
-    int tokenLine = line;
-    int tokenColumn = column - 1; // 调整列号，因为advance已经增加了
     
-    //处理各种符号
-    switch (c) {
-        //单字符标记
-        case '(': return Token(TokenType::LPAREN, "(", tokenLine, tokenColumn);
-        case ')': return Token(TokenType::RPAREN, ")", tokenLine, tokenColumn);
-        case '{': return Token(TokenType::LBRACE, "{", tokenLine, tokenColumn);
-        case '}': return Token(TokenType::RBRACE, "}", tokenLine, tokenColumn);
-        case ';': return Token(TokenType::SEMICOLON, ";", tokenLine, tokenColumn);
-        case ',': return Token(TokenType::COMMA, ",", tokenLine, tokenColumn);
-        
-        //算术运算符
-        case '+': return Token(TokenType::PLUS, "+", tokenLine, tokenColumn);
-        case '-': return Token(TokenType::MINUS, "-", tokenLine, tokenColumn);
-        case '*': return Token(TokenType::MULTIPLY, "*", tokenLine, tokenColumn);
-        case '%': return Token(TokenType::MODULO, "%", tokenLine, tokenColumn);
-        
-        // 可能是单字符或双字符的运算符
-        case '=':
-            if (peek() == '=') {
-                advance();
-                return Token(TokenType::EQ, "==", tokenLine, tokenColumn);
-            }
-            return Token(TokenType::ASSIGN, "=", tokenLine, tokenColumn);
-            
-        case '!':
-            if (peek() == '=') {
-                advance();
-                return Token(TokenType::NEQ, "!=", tokenLine, tokenColumn);
-            }
-            return Token(TokenType::NOT, "!", tokenLine, tokenColumn);
-            
-        case '<':
-            if (peek() == '=') {
-                advance();
-                return Token(TokenType::LE, "<=", tokenLine, tokenColumn);
-            }
-            return Token(TokenType::LT, "<", tokenLine, tokenColumn);
-            
-        case '>':
-            if (peek() == '=') {
-                advance();
-                return Token(TokenType::GE, ">=", tokenLine, tokenColumn);
-            }
-            return Token(TokenType::GT, ">", tokenLine, tokenColumn);
-            
-        case '&':
-            if (peek() == '&') {
-                advance();
-                return Token(TokenType::AND, "&&", tokenLine, tokenColumn);
-            }
-            return Token(TokenType::UNKNOWN, "&", tokenLine, tokenColumn);
-            
-        case '|':
-            if (peek() == '|') {
-                advance();
-                return Token(TokenType::OR, "||", tokenLine, tokenColumn);
-            }
-            return Token(TokenType::UNKNOWN, "|", tokenLine, tokenColumn);
-            
-        case '/':
-            return Token(TokenType::DIVIDE, "/", tokenLine, tokenColumn);
-    }
-    
-    //未识别的字符
-    return Token(TokenType::UNKNOWN, std::string(1, c), tokenLine, tokenColumn);
+    // 运算符、分隔符及未识别的字符
+    return readOperatorOrPunctuator();
 }
 
 /*
@@ -291,30 +213,18 @@ Token Lexer::scanToken() {
  * @return 标识符或关键字的标记
 */
 Token Lexer::scanIdentifier() {
-    int startPos = position;
-    int startColumn = column;
-    int startLine = line;
-    
-    // 第一个字符必须是字母或下划线
-    if (isalpha(peek()) || peek() == '_') {
-        advance();
-    }
+    SourceOffset start = position;
     
-    // 后续字符可以是字母、数字或下划线
-    while (!isAtEnd() && (isalnum(peek()) || peek() == '_')) {
-        advance();
-    }
+    // 第一个字符已由 scanToken 确认是字母或下划线，后续字符可以是字母、数字或下划线
+    position += static_cast<SourceOffset>(1 + charscan::identLength(source.data() + position + 1, source.size() - position - 1));
 
-    //提取词素
-    std::string lexeme = source.substr(startPos, position - startPos);
-    
-    // 检查是否是关键字
-    if (keywords.find(lexeme) != keywords.end()) {
-        return Token(keywords[lexeme], lexeme, startLine, startColumn);
+    // 检查是否是关键字，不是关键字则为标识符，标识符在此驻留
+    std::string_view text = source.substr(start, position - start);
+    TokenType type = keywordType(text);
+    if (type != TokenType::IDENTIFIER) {
+        return makeToken(type, start);
     }
-    
-    //不是关键字，则是标识符
-    return Token(TokenType::IDENTIFIER, lexeme, startLine, startColumn);
+    return Token(type, start, position - start, identifiers.intern(text));
 }
 
 /*
@@ -323,9 +233,7 @@ Token Lexer::scanIdentifier() {
  * @return 数字的标记
 */
 Token Lexer::scanNumber() {
-    int startPos = position;
-    int startColumn = column;
-    int startLine = line;
+    SourceOffset start = position;
     
     // 处理可能的负号
     if (peek() == '-') {
@@ -337,74 +245,46 @@ Token Lexer::scanNumber() {
         advance();
     }
     
-    // 提取词素
-    std::string lexeme = source.substr(startPos, position - startPos);
-    return Token(TokenType::NUMBER, lexeme, startLine, startColumn);
+    return makeToken(TokenType::NUMBER, start);
 }
 
-// 读取运算符或标点符号
+/*
+ * 读取运算符或标点符号
+ * 以首字符直接索引分派表，最多再检查一个字符即可确定类型
+ * @return 运算符、分隔符或未识别字符的标记
+*/
 Token Lexer::readOperatorOrPunctuator() {
-    int start = position;
-    int startLine = line;
-    int startColumn = column;
+    SourceOffset start = position;
 
-    char c = peek();
-    position++;
-    column++;
+    const OperatorEntry& entry = kOperatorTable[static_cast<unsigned char>(advance())];
 
     // 检查双字符符号
-    if (position < source.length()) {
-        char next = peek();
-        std::string twoCharOp = std::string(1, c) + next;
-        if (operators.find(twoCharOp) != operators.end()) {
-            position++;
-            column++;
-            return Token(operators.at(twoCharOp), twoCharOp, startLine, startColumn);
-        }
-    }
-
-    // 单字符符号
-    std::string singleCharOp = std::string(1, c);
-    if (operators.find(singleCharOp) != operators.end()) {
-        return Token(operators.at(singleCharOp), singleCharOp, startLine, startColumn);
+    if (entry.second != '\0' && peek() == entry.second) {
+        advance();
+        return makeToken(entry.pair, start);
     }
 
-    // 未知符号
-    return Token(TokenType::UNKNOWN, singleCharOp, startLine, startColumn);
+    // 单字符符号（未识别的字符为 UNKNOWN）
+    return makeToken(entry.single, start);
 }
 
 // 获取下一个标记
 Token Lexer::nextToken() {
-    while (true) {
-        // 跳过空格、制表、换行、回车符
-        skipWhitespace();
-        // 检查是否已到末尾
-        if (isAtEnd()) {
-            return Token(TokenType::END_OF_FILE, "", line, column);
-        }
-        
-        // 使用原有的scanToken函数来获取下一个标记
-        return scanToken();
+    // 跳过空格、制表、换行、回车符和注释
+    skipWhitespace();
+    // 检查是否已到末尾
+    if (isAtEnd()) {
+        return makeToken(TokenType::END_OF_FILE, position);
     }
+    
+    // 使用原有的scanToken函数来获取下一个标记
+    return scanToken();
 }
 
 // 查看下一个标记但不消耗它
 Token Lexer::peekToken() {
-    int savedPosition = position;
-    int savedLine = line;
-    int savedColumn = column;
-
+    SourceOffset savedPosition = position;
     Token token = nextToken();
-
     position = savedPosition;
-    line = savedLine;
-    column = savedColumn;
-
     return token;
 }
-
-// 带参数的标记化函数
-std::vector<Token> Lexer::tokenize(const std::string& source) {
-    Lexer lexer(source);
-    return lexer.tokenize();
-}
\ No newline at end of file
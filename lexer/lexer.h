@@ -1,37 +1,34 @@
 // Lexer.h - 定义了词法分析器的接口和基本结构
 #pragma once
 #include "Token.h"
+#include "common/stringInterner.h"
+#include "lexer/charScan.h"
+#include "lexer/sourceManager.h"
 #include <vector>
 #include <string>
-#include <unordered_map>
+#include <string_view>
 
 // Lexer 类 - 负责将源代码字符串分解为标记序列
+// 词法分析只推进偏移量，不维护行列号；行列号由 SourceManager 在需要时计算
 class Lexer {
 private:
-    std::string source;   //源代码字符串
-    int position = 0;     //当前处理位置
-    int line = 1;         //当前行号
-    int column = 1;       //当前列号
-    // 关键字映射表：将关键字字符串映射到相应的标记类型
-    std::unordered_map<std::string, TokenType> keywords;
-    // 运算符映射表：将运算符字符串映射到相应的标记类型
-    std::unordered_map<std::string, TokenType> operators;
+    const SourceManager& sources; //源代码管理器（不拥有缓冲区，由调用者保证其生命周期覆盖所有Token）
+    std::string_view source;      //源代码视图
+    StringInterner& identifiers;  //标识符驻留表，扫描到标识符时填入
+    SourceOffset position = 0;    //当前处理位置
 
 public:
     // === 公共接口 ===
 
-    // 带参数的构造函数 - 使用源代码初始化词法分析器
-    Lexer(const std::string& source);
+    // 带参数的构造函数 - 使用源代码初始化词法分析器，识别出的标识符驻留到 identifiers 中
+    Lexer(const SourceManager& sources, StringInterner& identifiers);
     // 标记化方法 - 将源代码转换为标记序列
     std::vector<Token> tokenize();
     
-    Lexer(); // 默认构造函数
     Token nextToken(); // 获取下一个词法单元
     Token peekToken(); // 查看下一个词法单元但不消耗它
-    int getLine() const { return line; }// 获取当前行号
-    int getColumn() const { return column; }// 获取当前列号
-    // 带参数的标记化方法 - 使用提供的源代码创建标记序列
-    std::vector<Token> tokenize(const std::string& source); // 带参数版本
+    int getLine() const { return sources.getLocation(position).line; }// 获取当前行号
+    int getColumn() const { return sources.getLocation(position).column; }// 获取当前列号
     
 private:
     // 原有私有方法
@@ -43,6 +40,6 @@ private:
     Token scanIdentifier();// 扫描标识符或关键字
     Token scanNumber();// 扫描数字字面量
     void skipComment();// 跳过注释
+    Token makeToken(TokenType type, SourceOffset start) const;// 以 [start, position) 构造标记
     Token readOperatorOrPunctuator();// 读取运算符或标点符号
-    void initOperators(); // 初始化运算符映射表
 };
@@ -0,0 +1,107 @@
+#include "lexer/sourceFile.h"
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+SourceFile::~SourceFile() {
+    release();
+}
+
+// 释放映射或缓冲区
+void SourceFile::release() {
+    if (mappedData) {
+        munmap(const_cast<char*>(mappedData), mappedSize);
+        mappedData = nullptr;
+        mappedSize = 0;
+    }
+    buffer.clear();
+    content = std::string_view();
+}
+
+/*
+ * 打开源文件并映射到内存
+ * 普通文件使用 mmap 只读映射，不再经过流和字符串复制；
+ * 不能映射的文件（如命名管道）退回到读入缓冲区
+ * @param path 文件路径
+ * @return 成功返回 true
+*/
+bool SourceFile::openFile(const std::string& path) {
+    release();
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    bool ok = mapDescriptor(fd) || readDescriptor(fd);
+    close(fd);
+    return ok;
+}
+
+// 读取标准输入
+bool SourceFile::openStdin() {
+    release();
+    return mapDescriptor(STDIN_FILENO) || readDescriptor(STDIN_FILENO);
+}
+
+/*
+ * 映射普通文件
+ * 映射在关闭文件描述符后仍然有效
+ * @param fd 已打开的文件描述符
+ * @return 映射成功（或文件为空）返回 true
+*/
+bool SourceFile::mapDescriptor(int fd) {
+    struct stat info;
+    if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+        return false;
+    }
+    // 标准输入可能已被读取过一部分，此时从头映射会得到错误内容，改为直接读取
+    if (lseek(fd, 0, SEEK_CUR) > 0) {
+        return false;
+    }
+    if (info.st_size == 0) {
+        content = std::string_view();
+        return true;
+    }
+
+    size_t size = static_cast<size_t>(info.st_size);
+    void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+        return false;
+    }
+    // 词法分析按顺序扫描整个文件，提示内核提前预读
+    madvise(data, size, MADV_SEQUENTIAL);
+
+    mappedData = static_cast<const char*>(data);
+    mappedSize = size;
+    content = std::string_view(mappedData, mappedSize);
+    return true;
+}
+
+/*
+ * 将描述符中的全部内容读入单个缓冲区
+ * 缓冲区按倍数增长，数据直接读到最终位置，不经过中间流
+ * @param fd 已打开的文件描述符
+ * @return 读取成功返回 true
+*/
+bool SourceFile::readDescriptor(int fd) {
+    buffer.clear();
+    size_t used = 0;
+    buffer.resize(64 * 1024);
+    while (true) {
+        if (used == buffer.size()) {
+            buffer.resize(buffer.size() * 2);
+        }
+        ssize_t count = read(fd, &buffer[used], buffer.size() - used);
+        if (count < 0) {
+            if (errno == EINTR) continue;
+            buffer.clear();
+            return false;
+        }
+        if (count == 0) break;
+        used += static_cast<size_t>(count);
+    }
+    buffer.resize(used);
+    content = std::string_view(buffer);
+    return true;
+}
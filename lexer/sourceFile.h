@@ -0,0 +1,34 @@
+// lexer/sourceFile.h - 源文件输入：普通文件以只读方式映射到内存，管道输入读入单个缓冲区
+#pragma once
+#include <string>
+#include <string_view>
+
+// SourceFile 类 - 持有整个编译期间使用的源代码缓冲区
+// 词法分析器和Token直接引用这里的内存，因此对象必须存活到编译结束
+class SourceFile {
+private:
+    const char* mappedData = nullptr;  // mmap 得到的只读映射
+    size_t mappedSize = 0;             // 映射长度
+    std::string buffer;                // 无法映射时（管道、终端）读入的缓冲区
+    std::string_view content;          // 对外提供的源代码视图
+
+public:
+    SourceFile() = default;
+    ~SourceFile();
+    SourceFile(const SourceFile&) = delete;
+    SourceFile& operator=(const SourceFile&) = delete;
+
+    // 打开指定文件，失败时返回 false
+    bool openFile(const std::string& path);
+    // 读取标准输入：重定向自普通文件时直接映射，否则一次性读入缓冲区
+    bool openStdin();
+
+    std::string_view text() const { return content; }
+
+private:
+    // 尝试映射一个已打开的普通文件，返回 false 表示该描述符不能映射
+    bool mapDescriptor(int fd);
+    // 从描述符读取全部内容到 buffer
+    bool readDescriptor(int fd);
+    void release();
+};
@@ -0,0 +1,36 @@
+#include "lexer/sourceManager.h"
+#include "lexer/charScan.h"
+#include <algorithm>
+
+/*
+ * 建立行首偏移表
+ * 先用位计数统计换行个数以一次性分配空间，再逐个记录换行之后的位置
+*/
+void SourceManager::buildLineTable() const {
+    lineStarts.reserve(charscan::countNewlines(buffer.data(), buffer.size()) + 1);
+    lineStarts.push_back(0);
+    charscan::forEachNewline(buffer.data(), buffer.size(), [this](size_t newline) {
+        lineStarts.push_back(static_cast<SourceOffset>(newline + 1));
+    });
+}
+
+/*
+ * 将偏移量转换为行列号
+ * @param offset 源代码中的字节偏移量
+ * @return 对应的行号和列号（均从 1 开始）
+*/
+SourceLocation SourceManager::getLocation(SourceOffset offset) const {
+    if (offset == kNoLocation) {
+        return SourceLocation();
+    }
+    std::call_once(lineTableBuilt, [this] { buildLineTable(); });
+
+    // 找到最后一个不大于 offset 的行首
+    auto next = std::upper_bound(lineStarts.begin(), lineStarts.end(), offset);
+    size_t lineIndex = static_cast<size_t>(next - lineStarts.begin()) - 1;
+
+    SourceLocation location;
+    location.line = static_cast<int>(lineIndex) + 1;
+    location.column = static_cast<int>(offset - lineStarts[lineIndex]) + 1;
+    return location;
+}
@@ -0,0 +1,43 @@
+// lexer/sourceManager.h - 源代码管理：用 32 位偏移量表示位置，按需计算行列号
+#pragma once
+#include <cstdint>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+// 源代码中的位置：相对于缓冲区起始的字节偏移量
+using SourceOffset = uint32_t;
+
+// 表示"没有位置信息"的偏移量
+constexpr SourceOffset kNoLocation = UINT32_MAX;
+
+// 行列号，只在需要输出诊断信息时计算
+struct SourceLocation {
+    int line = 0;    // 行号，从 1 开始
+    int column = 0;  // 列号，从 1 开始
+};
+
+// SourceManager 类 - 持有源代码视图，负责偏移量与行列号之间的转换
+// 行首偏移表在第一次查询时才建立，之后每次查询为一次二分查找
+class SourceManager {
+private:
+    std::string_view buffer;                    // 源代码（由 SourceFile 持有）
+    mutable std::vector<SourceOffset> lineStarts; // 每一行首字符的偏移量
+    mutable std::once_flag lineTableBuilt;      // 保证行首表只建立一次（可被多个线程查询）
+
+public:
+    explicit SourceManager(std::string_view buffer) : buffer(buffer) {}
+
+    // 源代码能否用 32 位偏移量表示
+    static bool fits(std::string_view buffer) { return buffer.size() < kNoLocation; }
+
+    std::string_view text() const { return buffer; }
+    // 取出 [offset, offset + length) 范围的源代码文本
+    std::string_view slice(SourceOffset offset, uint32_t length) const { return buffer.substr(offset, length); }
+
+    // 将偏移量转换为行列号，kNoLocation 返回 {0, 0}
+    SourceLocation getLocation(SourceOffset offset) const;
+
+private:
+    void buildLineTable() const;
+};
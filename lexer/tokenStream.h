@@ -0,0 +1,65 @@
+// lexer/tokenStream.h - 语法分析器使用的Token流，按需从词法分析器拉取Token
+#pragma once
+#include "lexer/Token.h"
+#include "lexer/lexer.h"
+#include <array>
+#include <vector>
+
+// TokenStream 类 - 用一个小环形缓冲区为语法分析器提供前瞻
+// 流式模式下每次只向 Lexer 请求一个 Token，内存占用与源文件大小无关；
+// 也可以包装一个已经生成好的Token序列或其中一段（不复制），两种模式共用同一套环形缓冲区逻辑
+class TokenStream {
+public:
+    // 语法分析器需要的最大前瞻距离（Parser::stmt 中的 peek(1)）
+    static constexpr int kMaxLookahead = 1;
+
+private:
+    // 缓冲区需要容纳：前一个Token、当前Token以及 kMaxLookahead 个前瞻Token
+    static constexpr int kRingSize = 4;
+    static_assert(kRingSize >= kMaxLookahead + 2, "ring buffer too small for lookahead");
+    static_assert((kRingSize & (kRingSize - 1)) == 0, "ring size must be a power of two");
+
+    Lexer* lexer = nullptr;          // 流式模式下的Token来源
+    const Token* first = nullptr;    // 序列模式下的Token区间 [first, last)
+    const Token* last = nullptr;
+    Token endToken;                  // 序列模式下区间之后一直返回的 END_OF_FILE
+    std::array<Token, kRingSize> ring;
+    int position = 0;                // 当前Token的逻辑下标
+    int filled = 0;                  // 已拉取进缓冲区的Token数量
+
+public:
+    // 流式模式：从词法分析器按需拉取
+    explicit TokenStream(Lexer& lexer) : lexer(&lexer) { fill(); }
+    // 序列模式：包装调用者持有的Token序列（序列以 END_OF_FILE 结尾）
+    explicit TokenStream(const std::vector<Token>& tokens)
+        : first(tokens.data()), last(tokens.data() + tokens.size() - 1), endToken(tokens.back()) { fill(); }
+    // 片段模式：包装序列中的一段 [first, last)，之后返回 end（类型应为 END_OF_FILE）
+    TokenStream(const Token* first, const Token* last, const Token& end)
+        : first(first), last(last), endToken(end) { fill(); }
+
+    // 查看当前位置向前偏移的Token，offset 不能超过 kMaxLookahead
+    const Token& peek(int offset) const { return ring[(position + offset) & (kRingSize - 1)]; }
+    // 前一个已消费的Token
+    const Token& previous() const { return ring[(position - 1) & (kRingSize - 1)]; }
+    // 前进一个Token，并补充一个前瞻Token
+    void advance() {
+        position++;
+        fill();
+    }
+
+private:
+    // 保证缓冲区中有 [position, position + kMaxLookahead] 范围内的Token
+    void fill() {
+        while (filled <= position + kMaxLookahead) {
+            ring[filled & (kRingSize - 1)] = pull();
+            filled++;
+        }
+    }
+
+    // 从来源取下一个Token，到达末尾后一直返回 END_OF_FILE
+    Token pull() {
+        if (lexer) return lexer->nextToken();
+        if (first < last) return *first++;
+        return endToken;
+    }
+};
@@ -1,14 +1,35 @@
 // main.cpp - 编译器主程序
 #include "lexer/lexer.h"
+#include "lexer/sourceFile.h"
 #include "parser/parser.h"
+#include "parser/parallelParser.h"
+#include "common/threadPool.h"
 #include "semantic/semantic.h"
+#include "semantic/constantFolder.h"
 #include "ir/ir.h"
 #include "ir/irgen.h"
 #include "codegen/codegen.h"
-#include <fstream>
 #include <iostream>
+#include <memory>
 #include <sstream>
 #include <string>
+#include <algorithm>
+#include <thread>
+
+// 解析 -jN 中的线程数 N：必须是正的十进制整数，超过硬件线程数时按硬件线程数处理
+static bool parseThreadCount(const std::string& digits, unsigned& count) {
+    if (digits.empty()) return false;
+    const unsigned limit = std::max(1u, std::thread::hardware_concurrency());
+    unsigned value = 0;
+    for (char c : digits) {
+        if (c < '0' || c > '9') return false;
+        // 已超过上限后不再累加，避免溢出
+        if (value <= limit) value = value * 10 + static_cast<unsigned>(c - '0');
+    }
+    if (value == 0) return false;
+    count = std::min(value, limit);
+    return true;
+}
 
 int main(int argc, char* argv[]) {
     // 检查是否有 -opt 参数
@@ -33,57 +54,91 @@ int main(int argc, char* argv[]) {
     std::string source = buffer.str();*/
 
     //从指定文件读入源代码
-    std::stringstream buffer;
     std::string filename;
+
+    // 并行编译：-j 使用全部硬件线程，-jN 使用 N 个线程（不超过硬件线程数）；默认顺序流式解析、顺序语义分析
+    bool parallel = false;
+    unsigned threadCount = 0;
     
     // 处理命令行参数
     for (int i = 1; i < argc; ++i) {
         std::string arg = argv[i];
         if (arg == "-opt") {
             enableOptimization = true;
+        } else if (arg == "-j") {
+            parallel = true;
+            threadCount = 0;
+        } else if (arg.rfind("-j", 0) == 0) {
+            if (!parseThreadCount(arg.substr(2), threadCount)) {
+                std::cerr << "Error: Invalid thread count in " << arg << std::endl;
+                std::cerr << "Usage: " << argv[0] << " [-opt] [-j | -jN] [file]" << std::endl;
+                return 1;
+            }
+            parallel = true;
         } else {
             filename = arg; // 将不是 -opt 的参数作为文件名处理
         }
     }
     
-    // 从文件或标准输入读取源代码
+    // 从文件或标准输入读取源代码：普通文件直接映射到内存，管道输入读入单个缓冲区
+    SourceFile sourceFile;
     if (!filename.empty()) {
-        std::ifstream inputFile(filename);
-        if (!inputFile) {
+        if (!sourceFile.openFile(filename)) {
             std::cerr << "Error: Cannot open file " << filename << std::endl;
             return 1;
         }
-        buffer << inputFile.rdbuf();
-    } else {
-        buffer << std::cin.rdbuf();
+    } else if (!sourceFile.openStdin()) {
+        std::cerr << "Error: Cannot read standard input" << std::endl;
+        return 1;
     }
     
-    std::string source = buffer.str();
+    // 位置信息统一使用 32 位偏移量
+    if (!SourceManager::fits(sourceFile.text())) {
+        std::cerr << "Error: Source file is too large" << std::endl;
+        return 1;
+    }
+    SourceManager sources(sourceFile.text());
+    // 标识符驻留表：词法分析时填入，后续各阶段按编号查找
+    StringInterner identifiers;
     
 
     std::cerr << "初始化完成，开始编译\n";
 
-    // 词法分析
-    Lexer lexer(source);
-    std::vector<Token> tokens = lexer.tokenize();
-    std::cerr << "词法分析完成\n";
-
-    // 语法分析
-    Parser parser(tokens);
-    std::shared_ptr<CompUnit> ast = parser.parse();
+    // 词法分析与语法分析（Token 只记录在 sourceFile 中的偏移量，sourceFile 需存活到编译结束）
+    Lexer lexer(sources, identifiers);
+    std::unique_ptr<CompUnit> ast;
+    std::unique_ptr<ThreadPool> pool;
+    if (parallel) {
+        // 并行：先完整地词法分析，再按顶层函数切分后并行解析
+        std::vector<Token> tokens = lexer.tokenize();
+        pool = std::make_unique<ThreadPool>(threadCount);
+        ParallelParser parser(tokens, sources, *pool);
+        ast = parser.parse();
+    } else {
+        // 流式：语法分析器按需从词法分析器拉取Token
+        Parser parser(lexer, sources);
+        ast = parser.parse();
+    }
     if (!ast) {
         std::cerr << "Error: Parsing failed." << std::endl;
         return 1;
     }
+    std::cerr << "词法分析完成\n";
     std::cerr << "语法分析完成\n";
 
     // 语义分析
-    SemanticAnalyzer semanticAnalyzer;
-    if (!semanticAnalyzer.analyze(ast)) {
+    SemanticAnalyzer semanticAnalyzer(sources, identifiers);
+    if (!semanticAnalyzer.analyze(*ast, pool.get())) {
         std::cerr << "Error: Semantic analysis failed." << std::endl;
         return 1;
     }
 
+    // 优化时先在AST上折叠常量、化简恒等式，减少生成的IR
+    if (enableOptimization) {
+        ConstantFolder folder;
+        folder.fold(*ast);
+    }
+
     // IR生成配置
     IRGenConfig irConfig;
     if(enableOptimization) {
@@ -92,13 +147,13 @@ int main(int argc, char* argv[]) {
     }
     
     // IR生成
-    IRGenerator irGenerator(irConfig);
-    irGenerator.generate(ast);
+    IRGenerator irGenerator(identifiers, irConfig);
+    irGenerator.generate(*ast);
     
     // 可选：打印IR用于调试（输出到stderr不影响标准输出）
     if (enablePrintIR) {
         std::cerr << "IR生成完成，开始打印IR\n";
-        IRPrinter::print(irGenerator.getInstructions(), std::cerr);
+        IRPrinter::print(irGenerator.getInstructions(), irGenerator.getNames(), std::cerr);
     }
     std::cerr << "IR生成完成\n";
 
@@ -117,7 +172,7 @@ int main(int argc, char* argv[]) {
     std::cerr << "代码生成开始\n";
     std::cerr << "准备创建CodeGenerator\n";
     // 代码生成
-    CodeGenerator generator(outputStream, irGenerator.getInstructions(), config);
+    CodeGenerator generator(outputStream, irGenerator.getInstructions(), irGenerator.getNames(), config);
     std::cerr << "CodeGenerator创建完成\n";
     std::cerr << "开始生成代码\n";
     generator.generate();
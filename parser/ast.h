@@ -1,267 +1,354 @@
 // AST.h - 定义了抽象语法树(Abstract Syntax Tree)的各种节点类型
+// 除根节点 CompUnit 外，所有节点都分配在 CompUnit 持有的内存池中，
+// 节点之间用普通指针相连，标识符以驻留编号表示，整棵树随 CompUnit 一次性释放
 #pragma once
-#include <string>
-#include <vector>
-#include <memory>
+#include <cstdint>
+#include <string_view>
+#include "common/stringInterner.h"
+#include "lexer/sourceManager.h"
+#include "common/arena.h"
 
-// ASTNode - 所有AST节点的基类，提供基本的位置信息和访问者模式接口
+// BinOp - 二元运算符，按优先级从高到低排列
+enum class BinOp : uint8_t {
+    Mul, Div, Mod,          // 乘除模
+    Add, Sub,               // 加减
+    Lt, Gt, Le, Ge, Eq, Ne, // 关系运算
+    And,                    // 逻辑与
+    Or                      // 逻辑或
+};
+
+// UnOp - 一元运算符
+enum class UnOp : uint8_t {
+    Plus, Neg, Not
+};
+
+// 运算符的源代码写法，仅用于诊断信息
+constexpr std::string_view toString(BinOp op) {
+    switch (op) {
+        case BinOp::Mul: return "*";
+        case BinOp::Div: return "/";
+        case BinOp::Mod: return "%";
+        case BinOp::Add: return "+";
+        case BinOp::Sub: return "-";
+        case BinOp::Lt:  return "<";
+        case BinOp::Gt:  return ">";
+        case BinOp::Le:  return "<=";
+        case BinOp::Ge:  return ">=";
+        case BinOp::Eq:  return "==";
+        case BinOp::Ne:  return "!=";
+        case BinOp::And: return "&&";
+        case BinOp::Or:  return "||";
+    }
+    return "?";
+}
+
+constexpr std::string_view toString(UnOp op) {
+    switch (op) {
+        case UnOp::Plus: return "+";
+        case UnOp::Neg:  return "-";
+        case UnOp::Not:  return "!";
+    }
+    return "?";
+}
+
+// 结果为真值（0 或 1）的运算符：关系运算和逻辑运算
+constexpr bool isConditionOp(BinOp op) {
+    return op >= BinOp::Lt;
+}
+
+// ExprType - 表达式的类型，由语义分析计算后记录在表达式节点上
+// Unknown 表示尚未分析，Error 表示表达式本身或其子表达式有语义错误
+enum class ExprType : uint8_t {
+    Unknown, Int, Void, Error
+};
+
+// 类型名，用于诊断信息
+constexpr std::string_view toString(ExprType type) {
+    switch (type) {
+        case ExprType::Unknown: return "unknown";
+        case ExprType::Int:     return "int";
+        case ExprType::Void:    return "void";
+        case ExprType::Error:   return "error";
+    }
+    return "?";
+}
+
+// ConstState - 表达式是否为编译期常量，由 analyzeHelper::evaluateConstant 第一次求值时记录
+enum class ConstState : uint8_t {
+    Unevaluated, Constant, NotConstant
+};
+
+// NodeKind - 节点种类标签，静态分派（见 astVisitor.h 中的 StaticASTVisitor）和 nodeCast 据此判断节点类型
+enum class NodeKind : uint8_t {
+    // 表达式
+    Number, Variable, Binary, Unary, Call,
+    // 语句
+    ExprStmt, VarDecl, Assign, Block, If, While, Break, Continue, Return,
+    // 其它
+    FunctionDef, CompUnit
+};
+
+// ASTNode - 所有AST节点的基类，提供节点种类标签和位置信息（没有虚函数，节点不带虚表）
 class ASTNode {
 public:
-    int line = 0;    // 源代码行号
-    int column = 0;  // 源代码列号
-
-    virtual ~ASTNode() = default;
-    virtual void accept(class ASTVisitor& visitor) = 0;
+    const NodeKind kind;                // 节点种类，构造时确定
+    SourceOffset offset = kNoLocation;  // 在源代码中的偏移量，行列号由 SourceManager 按需计算
 
     // 设置位置信息的方法
-    void setLocation(int line, int column) {
-        this->line = line;
-        this->column = column;
+    void setLocation(SourceOffset offset) {
+        this->offset = offset;
     }
+
+protected:
+    explicit ASTNode(NodeKind kind) : kind(kind) {}
+    // 节点由内存池统一释放，不通过基类指针析构
+    ~ASTNode() = default;
 };
 
+// 节点种类与 T::kKind 相同时转换为 T*，否则返回空指针（替代 dynamic_cast）
+template <typename T>
+T* nodeCast(ASTNode* node) {
+    return node && node->kind == T::kKind ? static_cast<T*>(node) : nullptr;
+}
+
+template <typename T>
+const T* nodeCast(const ASTNode* node) {
+    return node && node->kind == T::kKind ? static_cast<const T*>(node) : nullptr;
+}
+
 // Expr - 表达式节点的基类，所有表达式类型都继承自此类
 class Expr : public ASTNode {
+protected:
+    explicit Expr(NodeKind kind) : ASTNode(kind) {}
+
 public:
-    virtual ~Expr() = default;
+    ExprType type = ExprType::Unknown;  // 语义分析得到的类型，IR生成直接使用
+    ConstState constState = ConstState::Unevaluated;  // 常量求值结果的缓存
+    int constValue = 0;                 // constState 为 Constant 时的值
 };
 
 // Stmt - 语句节点的基类，所有语句类型都继承自此类
 class Stmt : public ASTNode {
-public:
-    virtual ~Stmt() = default;
+protected:
+    explicit Stmt(NodeKind kind) : ASTNode(kind) {}
 };
 
 // NumberExpr - 表示数字字面量的表达式节点
 class NumberExpr : public Expr {
 public:
+    static constexpr NodeKind kKind = NodeKind::Number;
     int value;// 数字的值
     
-    NumberExpr(int value, int line = 0, int column = 0) : value(value) {
-        this->line = line;
-        this->column = column;
+    NumberExpr(int value, SourceOffset offset = kNoLocation) : Expr(kKind), value(value) {
+        this->offset = offset;
     }
-    void accept(ASTVisitor& visitor) override;
 };
 
 // VariableExpr - 表示变量引用的表达式节点
 class VariableExpr : public Expr {
 public:
-    std::string name;
+    static constexpr NodeKind kKind = NodeKind::Variable;
+    SymbolId name;
     
-    VariableExpr(const std::string& name, int line = 0, int column = 0) : name(name) {
-        this->line = line;
-        this->column = column;
+    VariableExpr(SymbolId name, SourceOffset offset = kNoLocation) : Expr(kKind), name(name) {
+        this->offset = offset;
     }
-    void accept(ASTVisitor& visitor) override;
 };
 
 // BinaryExpr - 表示二元操作的表达式节点(如加减乘除、比较、逻辑运算等)
 class BinaryExpr : public Expr {
 public:
-    std::shared_ptr<Expr> left;
-    std::string op;
-    std::shared_ptr<Expr> right;
+    static constexpr NodeKind kKind = NodeKind::Binary;
+    Expr* left;
+    BinOp op;
+    Expr* right;
     
-    BinaryExpr(std::shared_ptr<Expr> left, const std::string& op, std::shared_ptr<Expr> right,
-              int line = 0, int column = 0)
-        : left(left), op(op), right(right) {
-        this->line = line;
-        this->column = column;
+    BinaryExpr(Expr* left, BinOp op, Expr* right,
+              SourceOffset offset = kNoLocation)
+        : Expr(kKind), left(left), op(op), right(right) {
+        this->offset = offset;
     }
-    void accept(ASTVisitor& visitor) override;
 };
 
 // UnaryExpr - 表示一元操作的表达式节点(如正负号、逻辑非等)
 class UnaryExpr : public Expr {
 public:
-    std::string op;
-    std::shared_ptr<Expr> operand;
+    static constexpr NodeKind kKind = NodeKind::Unary;
+    UnOp op;
+    Expr* operand;
     
-    UnaryExpr(const std::string& op, std::shared_ptr<Expr> operand,
-             int line = 0, int column = 0)
-        : op(op), operand(operand) {
-        this->line = line;
-        this->column = column;
+    UnaryExpr(UnOp op, Expr* operand,
+             SourceOffset offset = kNoLocation)
+        : Expr(kKind), op(op), operand(operand) {
+        this->offset = offset;
     }
-    void accept(ASTVisitor& visitor) override;
 };
 
 // CallExpr - 表示函数调用的表达式节点
 class CallExpr : public Expr {
 public:
-    std::string callee;
-    std::vector<std::shared_ptr<Expr>> arguments;
+    static constexpr NodeKind kKind = NodeKind::Call;
+    SymbolId callee;
+    NodeList<Expr*> arguments;
     
-    CallExpr(const std::string& callee, const std::vector<std::shared_ptr<Expr>>& arguments,
-            int line = 0, int column = 0)
-        : callee(callee), arguments(arguments) {
-        this->line = line;
-        this->column = column;
+    CallExpr(SymbolId callee, NodeList<Expr*> arguments,
+            SourceOffset offset = kNoLocation)
+        : Expr(kKind), callee(callee), arguments(arguments) {
+        this->offset = offset;
     }
-    void accept(ASTVisitor& visitor) override;
 };
 
 // ExprStmt - 表示表达式语句的节点(如函数调用语句)
 class ExprStmt : public Stmt {
 public:
-    std::shared_ptr<Expr> expression;
+    static constexpr NodeKind kKind = NodeKind::ExprStmt;
+    Expr* expression;
     
-    ExprStmt(std::shared_ptr<Expr> expression, int line = 0, int column = 0)
-        : expression(expression) {
-        this->line = line;
-        this->column = column;
+    ExprStmt(Expr* expression, SourceOffset offset = kNoLocation)
+        : Stmt(kKind), expression(expression) {
+        this->offset = offset;
     }
-    void accept(ASTVisitor& visitor) override;
 };
 
 // VarDeclStmt - 表示变量声明语句的节点
 class VarDeclStmt : public Stmt {
 public:
-    std::string name;
-    std::shared_ptr<Expr> initializer;
+    static constexpr NodeKind kKind = NodeKind::VarDecl;
+    SymbolId name;
+    Expr* initializer;
     
-    VarDeclStmt(const std::string& name, std::shared_ptr<Expr> initializer,
-               int line = 0, int column = 0)
-        : name(name), initializer(initializer) {
-        this->line = line;
-        this->column = column;
+    VarDeclStmt(SymbolId name, Expr* initializer,
+               SourceOffset offset = kNoLocation)
+        : Stmt(kKind), name(name), initializer(initializer) {
+        this->offset = offset;
     }
-    void accept(ASTVisitor& visitor) override;
 };
 
 // AssignStmt - 表示赋值语句的节点
 class AssignStmt : public Stmt {
 public:
-    std::string name;
-    std::shared_ptr<Expr> value;
+    static constexpr NodeKind kKind = NodeKind::Assign;
+    SymbolId name;
+    Expr* value;
     
-    AssignStmt(const std::string& name, std::shared_ptr<Expr> value,
-              int line = 0, int column = 0)
-        : name(name), value(value) {
-        this->line = line;
-        this->column = column;
+    AssignStmt(SymbolId name, Expr* value,
+              SourceOffset offset = kNoLocation)
+        : Stmt(kKind), name(name), value(value) {
+        this->offset = offset;
     }
-    void accept(ASTVisitor& visitor) override;
 };
 
 // BlockStmt - 表示语句块的节点(由大括号括起的一系列语句)
 class BlockStmt : public Stmt {
 public:
-    std::vector<std::shared_ptr<Stmt>> statements;
+    static constexpr NodeKind kKind = NodeKind::Block;
+    NodeList<Stmt*> statements;
     
-    BlockStmt(const std::vector<std::shared_ptr<Stmt>>& statements,
-             int line = 0, int column = 0)
-        : statements(statements) {
-        this->line = line;
-        this->column = column;
+    BlockStmt(NodeList<Stmt*> statements,
+             SourceOffset offset = kNoLocation)
+        : Stmt(kKind), statements(statements) {
+        this->offset = offset;
     }
-    void accept(ASTVisitor& visitor) override;
 };
 
 // IfStmt - 表示if条件语句的节点
 class IfStmt : public Stmt {
 public:
-    std::shared_ptr<Expr> condition;
-    std::shared_ptr<Stmt> thenBranch;
-    std::shared_ptr<Stmt> elseBranch; // 可能为nullptr
+    static constexpr NodeKind kKind = NodeKind::If;
+    Expr* condition;
+    Stmt* thenBranch;
+    Stmt* elseBranch; // 可能为nullptr
     
-    IfStmt(std::shared_ptr<Expr> condition, std::shared_ptr<Stmt> thenBranch, std::shared_ptr<Stmt> elseBranch,
-          int line = 0, int column = 0)
-        : condition(condition), thenBranch(thenBranch), elseBranch(elseBranch) {
-        this->line = line;
-        this->column = column;
+    IfStmt(Expr* condition, Stmt* thenBranch, Stmt* elseBranch,
+          SourceOffset offset = kNoLocation)
+        : Stmt(kKind), condition(condition), thenBranch(thenBranch), elseBranch(elseBranch) {
+        this->offset = offset;
     }
-    void accept(ASTVisitor& visitor) override;
 };
 
 // WhileStmt - 表示while循环语句的节点
 class WhileStmt : public Stmt {
 public:
-    std::shared_ptr<Expr> condition;
-    std::shared_ptr<Stmt> body;
+    static constexpr NodeKind kKind = NodeKind::While;
+    Expr* condition;
+    Stmt* body;
     
-    WhileStmt(std::shared_ptr<Expr> condition, std::shared_ptr<Stmt> body,
-             int line = 0, int column = 0)
-        : condition(condition), body(body) {
-        this->line = line;
-        this->column = column;
+    WhileStmt(Expr* condition, Stmt* body,
+             SourceOffset offset = kNoLocation)
+        : Stmt(kKind), condition(condition), body(body) {
+        this->offset = offset;
     }
-    void accept(ASTVisitor& visitor) override;
 };
 
 // BreakStmt - 表示break语句的节点
 class BreakStmt : public Stmt {
 public:
-    BreakStmt(int line = 0, int column = 0) {
-        this->line = line;
-        this->column = column;
+    static constexpr NodeKind kKind = NodeKind::Break;
+    BreakStmt(SourceOffset offset = kNoLocation) : Stmt(kKind) {
+        this->offset = offset;
     }
-    void accept(ASTVisitor& visitor) override;
 };
 
 // ContinueStmt - 表示continue语句的节点
 class ContinueStmt : public Stmt {
 public:
-    ContinueStmt(int line = 0, int column = 0) {
-        this->line = line;
-        this->column = column;
+    static constexpr NodeKind kKind = NodeKind::Continue;
+    ContinueStmt(SourceOffset offset = kNoLocation) : Stmt(kKind) {
+        this->offset = offset;
     }
-    void accept(ASTVisitor& visitor) override;
 };
 
 // ReturnStmt - 表示return语句的节点
 class ReturnStmt : public Stmt {
 public:
-    std::shared_ptr<Expr> value; // 可能为nullptr
+    static constexpr NodeKind kKind = NodeKind::Return;
+    Expr* value; // 可能为nullptr
     
-    ReturnStmt(std::shared_ptr<Expr> value, int line = 0, int column = 0)
-        : value(value) {
-        this->line = line;
-        this->column = column;
+    ReturnStmt(Expr* value, SourceOffset offset = kNoLocation)
+        : Stmt(kKind), value(value) {
+        this->offset = offset;
     }
-    void accept(ASTVisitor& visitor) override;
 };
 
 // Param - 表示函数参数的类
 class Param {
 public:
-    std::string name;
-    int line = 0;
-    int column = 0;
+    SymbolId name;
+    SourceOffset offset = kNoLocation;
     
-    Param(const std::string& name, int line = 0, int column = 0)
-        : name(name), line(line), column(column) {}
+    Param(SymbolId name, SourceOffset offset = kNoLocation)
+        : name(name), offset(offset) {}
 };
 
 // FunctionDef - 表示函数定义的节点
 class FunctionDef : public ASTNode {
 public:
-    std::string returnType; // "int" 或 "void"
-    std::string name;
-    std::vector<Param> params;
-    std::shared_ptr<BlockStmt> body;
+    static constexpr NodeKind kKind = NodeKind::FunctionDef;
+    std::string_view returnType; // "int" 或 "void"
+    SymbolId name;
+    NodeList<Param> params;
+    BlockStmt* body;
     
-    FunctionDef(const std::string& returnType, const std::string& name, 
-               const std::vector<Param>& params, std::shared_ptr<BlockStmt> body,
-               int line = 0, int column = 0)
-        : returnType(returnType), name(name), params(params), body(body) {
-        this->line = line;
-        this->column = column;
+    FunctionDef(std::string_view returnType, SymbolId name,
+               NodeList<Param> params, BlockStmt* body,
+               SourceOffset offset = kNoLocation)
+        : ASTNode(kKind), returnType(returnType), name(name), params(params), body(body) {
+        this->offset = offset;
     }
-    void accept(ASTVisitor& visitor) override;
 };
 
 // CompUnit - 表示编译单元的节点(整个程序的根节点)
+// 根节点本身不在内存池中，它持有内存池，析构时整棵树一并释放
 class CompUnit : public ASTNode {
 public:
-    std::vector<std::shared_ptr<FunctionDef>> functions;
+    static constexpr NodeKind kKind = NodeKind::CompUnit;
+    Arena arena;                        // 所有子节点所在的内存池
+    NodeList<FunctionDef*> functions;
     
-    CompUnit(const std::vector<std::shared_ptr<FunctionDef>>& functions,
-            int line = 0, int column = 0)
-        : functions(functions) {
-        this->line = line;
-        this->column = column;
+    CompUnit(Arena&& arena, NodeList<FunctionDef*> functions,
+            SourceOffset offset = kNoLocation)
+        : ASTNode(kKind), arena(std::move(arena)), functions(functions) {
+        this->offset = offset;
     }
-    void accept(ASTVisitor& visitor) override;
+    ~CompUnit() = default;
 };
@@ -1,32 +1,35 @@
-// ASTVisitor.h - 定义了AST访问者接口
+// astVisitor.h - 定义了AST访问者基类
 #pragma once
 #include "ast.h"
-// ASTVisitor类 - 抽象基类，定义了访问AST各种节点的接口
-// 使用访问者模式，允许在不修改节点类的情况下扩展对节点的操作
-class ASTVisitor {
+// StaticASTVisitor - 按节点种类标签静态分派的访问者基类（CRTP）
+// Derived 为每种节点提供非虚的 visit 重载，dispatch 按 node.kind 直接调用对应的重载，
+// 不经过虚调用，编译器可以把各个 visit 内联进遍历过程。
+// 编译器内部的各个遍（语义分析、常量折叠、IR生成）都基于它
+template <typename Derived>
+class StaticASTVisitor {
 public:
-    virtual ~ASTVisitor() = default;
-    
-    // 表达式节点的访问方法
-    virtual void visit(NumberExpr& expr) = 0;     // 访问数字表达式
-    virtual void visit(VariableExpr& expr) = 0;   // 访问变量表达式
-    virtual void visit(BinaryExpr& expr) = 0;     // 访问二元表达式
-    virtual void visit(UnaryExpr& expr) = 0;      // 访问一元表达式
-    virtual void visit(CallExpr& expr) = 0;       // 访问函数调用表达式
-    
-    // 语句节点的访问方法
-    virtual void visit(ExprStmt& stmt) = 0;       // 访问表达式语句
-    virtual void visit(VarDeclStmt& stmt) = 0;    // 访问变量声明语句
-    virtual void visit(AssignStmt& stmt) = 0;     // 访问赋值语句
-    virtual void visit(BlockStmt& stmt) = 0;      // 访问语句块
-    virtual void visit(IfStmt& stmt) = 0;         // 访问if语句
-    virtual void visit(WhileStmt& stmt) = 0;      // 访问while语句
-    virtual void visit(BreakStmt& stmt) = 0;      // 访问break语句
-    virtual void visit(ContinueStmt& stmt) = 0;   // 访问continue语句
-    virtual void visit(ReturnStmt& stmt) = 0;     // 访问return语句
-    
-    // 其他节点的访问方法
-    virtual void visit(FunctionDef& funcDef) = 0; // 访问函数定义
-    virtual void visit(CompUnit& compUnit) = 0;   // 访问编译单元
-};
+    void dispatch(ASTNode& node) {
+        Derived& self = static_cast<Derived&>(*this);
+        switch (node.kind) {
+            case NodeKind::Number:      self.visit(static_cast<NumberExpr&>(node)); return;
+            case NodeKind::Variable:    self.visit(static_cast<VariableExpr&>(node)); return;
+            case NodeKind::Binary:      self.visit(static_cast<BinaryExpr&>(node)); return;
+            case NodeKind::Unary:       self.visit(static_cast<UnaryExpr&>(node)); return;
+            case NodeKind::Call:        self.visit(static_cast<CallExpr&>(node)); return;
+            case NodeKind::ExprStmt:    self.visit(static_cast<ExprStmt&>(node)); return;
+            case NodeKind::VarDecl:     self.visit(static_cast<VarDeclStmt&>(node)); return;
+            case NodeKind::Assign:      self.visit(static_cast<AssignStmt&>(node)); return;
+            case NodeKind::Block:       self.visit(static_cast<BlockStmt&>(node)); return;
+            case NodeKind::If:          self.visit(static_cast<IfStmt&>(node)); return;
+            case NodeKind::While:       self.visit(static_cast<WhileStmt&>(node)); return;
+            case NodeKind::Break:       self.visit(static_cast<BreakStmt&>(node)); return;
+            case NodeKind::Continue:    self.visit(static_cast<ContinueStmt&>(node)); return;
+            case NodeKind::Return:      self.visit(static_cast<ReturnStmt&>(node)); return;
+            case NodeKind::FunctionDef: self.visit(static_cast<FunctionDef&>(node)); return;
+            case NodeKind::CompUnit:    self.visit(static_cast<CompUnit&>(node)); return;
+        }
+    }
 
+protected:
+    ~StaticASTVisitor() = default;
+};
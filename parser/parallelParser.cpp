@@ -0,0 +1,88 @@
+// parallelParser.cpp - 并行语法分析的实现
+#include "parser/parallelParser.h"
+#include "parser/parser.h"
+#include <sstream>
+
+namespace {
+
+// 单个片段的解析结果
+struct SegmentResult {
+    std::vector<FunctionDef*> functions;  // 片段中的函数定义
+    Arena arena;                          // 这些函数所在的内存池
+    bool hadError = false;
+};
+
+} // namespace
+
+/*
+ * 预扫描Token序列，在花括号深度回到 0 的右大括号之后切分
+ * 片段之间的其它Token（如多余的分号）归入下一个片段，由该片段的解析器报告错误
+ * @return 每个片段的结束下标，最后一个片段延伸到 END_OF_FILE 之前
+*/
+std::vector<size_t> ParallelParser::splitAtFunctions() const {
+    std::vector<size_t> ends;
+    size_t count = tokens.size() - 1;  // 不含最后的 END_OF_FILE
+    int depth = 0;
+    for (size_t i = 0; i < count; i++) {
+        TokenType type = tokens[i].type;
+        if (type == TokenType::LBRACE) {
+            depth++;
+        } else if (type == TokenType::RBRACE && depth > 0) {
+            if (--depth == 0) {
+                ends.push_back(i + 1);
+            }
+        }
+    }
+    if (ends.empty() || ends.back() != count) {
+        ends.push_back(count);
+    }
+    return ends;
+}
+
+/*
+ * 并行解析所有函数定义
+ * 花括号不配对时切分点可能与真实的函数边界不一致，错误恢复的结果也会随之不同，
+ * 因此只要有片段出错，就丢弃各片段缓冲的错误信息，改为顺序重新解析整个序列，
+ * 保证输出的错误信息与顺序解析完全相同
+ * @return 编译单元根节点，有错误时返回空指针
+*/
+std::unique_ptr<CompUnit> ParallelParser::parse() {
+    std::vector<size_t> ends = splitAtFunctions();
+    std::vector<SegmentResult> results(ends.size());
+
+    pool.parallelFor(ends.size(), [&](size_t index) {
+        size_t begin = index == 0 ? 0 : ends[index - 1];
+        size_t end = ends[index];
+        Token endToken(TokenType::END_OF_FILE, tokens[end].offset, 0);
+
+        // 每个解析器的错误信息写入自己的缓冲区，互不干扰
+        std::ostringstream diagnostics;
+        Parser parser(tokens.data() + begin, tokens.data() + end, endToken, sources);
+        parser.setDiagnostics(diagnostics);
+
+        SegmentResult& result = results[index];
+        result.functions = parser.parseFunctions();
+        result.arena = parser.releaseArena();
+        result.hadError = parser.hasError();
+    });
+
+    for (const SegmentResult& result : results) {
+        if (result.hadError) {
+            Parser serial(tokens, sources);
+            std::unique_ptr<CompUnit> ast = serial.parse();
+            hadError = serial.hasError();
+            return ast;
+        }
+    }
+
+    // 按源代码顺序合并函数列表和内存池
+    Arena arena;
+    std::vector<FunctionDef*> functions;
+    for (SegmentResult& result : results) {
+        functions.insert(functions.end(), result.functions.begin(), result.functions.end());
+        arena.adopt(std::move(result.arena));
+    }
+
+    NodeList<FunctionDef*> functionList = arena.copyList(functions);
+    return std::make_unique<CompUnit>(std::move(arena), functionList, tokens.front().offset);
+}
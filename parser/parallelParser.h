@@ -0,0 +1,31 @@
+// parser/parallelParser.h - 按顶层函数拆分Token序列并在线程池上并行解析
+#pragma once
+#include "common/threadPool.h"
+#include "lexer/Token.h"
+#include "parser/ast.h"
+#include <memory>
+#include <vector>
+
+// ParallelParser - 先预扫描Token序列，在每个函数体的顶层右大括号处切分，
+// 再让每个片段由独立的 Parser 解析（各自的内存池和错误缓冲），最后按源代码顺序合并；
+// 有语法错误时退回顺序解析，以得到与顺序解析一致的错误信息
+// ToyC 没有全局变量和嵌套函数，所以函数之间的解析互不依赖
+class ParallelParser {
+private:
+    const std::vector<Token>& tokens;   // 完整的Token序列（以 END_OF_FILE 结尾）
+    const SourceManager& sources;       // 源代码管理器
+    ThreadPool& pool;                   // 执行解析任务的线程池
+    bool hadError = false;              // 是否有片段解析失败
+
+public:
+    ParallelParser(const std::vector<Token>& tokens, const SourceManager& sources, ThreadPool& pool)
+        : tokens(tokens), sources(sources), pool(pool) {}
+
+    // 解析整个编译单元，出错时返回空指针（错误信息已输出）
+    std::unique_ptr<CompUnit> parse();
+    bool hasError() const { return hadError; }
+
+private:
+    // 预扫描：返回每个片段的结束下标（不含最后的 END_OF_FILE）
+    std::vector<size_t> splitAtFunctions() const;
+};
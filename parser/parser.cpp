@@ -1,17 +1,63 @@
 #include "parser.h"
 #include "ast.h"
+#include <charconv>
 #include <iostream>
 
+namespace {
+
+// 二元运算符表项：优先级（数值越大结合越紧，0 表示不是二元运算符）和对应的运算符
+struct BinaryOperatorInfo {
+    int precedence;
+    BinOp op;
+};
+
+// 二元运算符的优先级表，所有二元运算符都是左结合
+// 层次与文法一致：lorExpr < landExpr < relExpr < addExpr < mulExpr
+constexpr BinaryOperatorInfo binaryOperator(TokenType type) {
+    switch (type) {
+        case TokenType::OR:       return {1, BinOp::Or};
+        case TokenType::AND:      return {2, BinOp::And};
+        case TokenType::LT:       return {3, BinOp::Lt};
+        case TokenType::GT:       return {3, BinOp::Gt};
+        case TokenType::LE:       return {3, BinOp::Le};
+        case TokenType::GE:       return {3, BinOp::Ge};
+        case TokenType::EQ:       return {3, BinOp::Eq};
+        case TokenType::NEQ:      return {3, BinOp::Ne};
+        case TokenType::PLUS:     return {4, BinOp::Add};
+        case TokenType::MINUS:    return {4, BinOp::Sub};
+        case TokenType::MULTIPLY: return {5, BinOp::Mul};
+        case TokenType::DIVIDE:   return {5, BinOp::Div};
+        case TokenType::MODULO:   return {5, BinOp::Mod};
+        default:                  return {0, BinOp::Or};
+    }
+}
+
+static_assert(binaryOperator(TokenType::MULTIPLY).precedence > binaryOperator(TokenType::PLUS).precedence,
+              "operator precedence table broken");
+static_assert(binaryOperator(TokenType::ASSIGN).precedence == 0, "operator precedence table broken");
+
+// 将运算符标记映射为一元运算符
+UnOp unaryOp(TokenType type) {
+    switch (type) {
+        case TokenType::MINUS: return UnOp::Neg;
+        case TokenType::NOT:   return UnOp::Not;
+        default:               return UnOp::Plus;
+    }
+}
+
+} // namespace
+
 //前进到下一个Token并返回前一个Token
-Token Parser::advance() {
-    if (!isAtEnd()) current++;
+const Token& Parser::advance() {
+    if (!isAtEnd()) tokens.advance();
     return previous();
 }
 
 //记录解析错误
 ParseError Parser::error(const Token& token, const std::string& message) {
     if (!isRecovering) {  // 只有在不处于恢复状态时才报告错误
-    std::cerr << "[Error at line " << token.line << ", column " << token.column << "] "
+    SourceLocation location = sources.getLocation(token.offset);
+    *diagnostics << "[Error at line " << location.line << ", column " << location.column << "] "
         << message << std::endl;
     errorCount++;
     hadError = true;
@@ -71,14 +117,14 @@ bool Parser::match(std::initializer_list<TokenType> types) {
 }
 
 //消费指定类型的Token
-Token Parser::consume(TokenType type, const std::string& message) {
+const Token& Parser::consume(TokenType type, const std::string& message) {
     if (check(type)) return advance();
     throw error(peek(0), message);
 }
 
 //获取前一个已消费的Token
-Token Parser::previous() const {
-    return tokens[current - 1];
+const Token& Parser::previous() const {
+    return tokens.previous();
 }
 
 //检查当前Token是否匹配指定类型
@@ -88,7 +134,7 @@ bool Parser::check(TokenType type) const {
 }
 
 //开始解析过程,返回解析生成的编译单元AST根节点
-std::shared_ptr<CompUnit> Parser::parse() {
+std::unique_ptr<CompUnit> Parser::parse() {
     try {
         auto result = compUnit();  // 解析整个编译单元
         // 即使compUnit没有抛出异常，也检查是否有错误发生
@@ -103,13 +149,30 @@ std::shared_ptr<CompUnit> Parser::parse() {
     }
 }
 
-//解析编译单元(CompUnit),compUnit → {functionDef}
-std::shared_ptr<CompUnit> Parser::compUnit() {
-    std::vector<std::shared_ptr<FunctionDef>> functions;
+//解析Token流中的全部函数定义（用于并行解析时的单个片段）
+std::vector<FunctionDef*> Parser::parseFunctions() {
+    try {
+        return functionDefs();
+    }
+    catch (const ParseError& error) {
+        return {};
+    }
+}
 
+//解析编译单元(CompUnit),compUnit → {functionDef}
+std::unique_ptr<CompUnit> Parser::compUnit() {
     // 获取编译单元的起始位置（第一个 token）
-    int line = peek(0).line;
-    int column = peek(0).column;
+    SourceOffset offset = peek(0).offset;
+    std::vector<FunctionDef*> functions = functionDefs();
+
+    NodeList<FunctionDef*> functionList = arena.copyList(functions);
+    return std::make_unique<CompUnit>(std::move(arena), functionList, offset);
+}
+
+//逐个解析函数定义直到Token流结束,出错时同步到下一个可恢复点继续
+std::vector<FunctionDef*> Parser::functionDefs() {
+    std::vector<FunctionDef*> functions;
+
     // 解析所有函数定义
     while (!isAtEnd()) {
         isRecovering = false; // 确保每个新函数定义开始时都不处于恢复状态
@@ -136,19 +199,18 @@ std::shared_ptr<CompUnit> Parser::compUnit() {
         }
     }
 
-    return std::make_shared<CompUnit>(functions, line, column);
+    return functions;
 }
 
 //解析函数定义(functionDef)
 //functionDef → type IDENT '(' [params] ')' block
 //params → param {',' param}
 //param → 'int' IDENT
-std::shared_ptr<FunctionDef> Parser::funcDef() {
+FunctionDef* Parser::funcDef() {
     // 记录函数定义的起始位置
-    int line = peek(0).line;
-    int column = peek(0).column;
+    SourceOffset offset = peek(0).offset;
     // 1. 解析返回类型
-    std::string returnTypeStr;
+    std::string_view returnTypeStr;
     if (match({ TokenType::INT })) {
         returnTypeStr = "int";
     }
@@ -160,15 +222,14 @@ std::shared_ptr<FunctionDef> Parser::funcDef() {
     }
 
     // 2. 解析函数名
-    Token nameToken = peek(0);
+    SymbolId name = kNoSymbol;
     try {
-        nameToken = consume(TokenType::IDENTIFIER, "Expected function name.");
+        name = consume(TokenType::IDENTIFIER, "Expected function name.").symbol;
     }
     catch (const ParseError& e) {
         synchronize();
         return nullptr;
     }
-    std::string name = nameToken.lexeme;
 
     // 3. 解析左括号
     try {
@@ -208,8 +269,8 @@ std::shared_ptr<FunctionDef> Parser::funcDef() {
             }
 
             try {
-                Token paramName = consume(TokenType::IDENTIFIER, "Expected parameter name.");
-                params.push_back(Param(paramName.lexeme));
+                const Token& paramName = consume(TokenType::IDENTIFIER, "Expected parameter name.");
+                params.push_back(Param(paramName.symbol, paramName.offset));
             }
             catch (const ParseError& e) {
                 synchronize();
@@ -241,7 +302,7 @@ std::shared_ptr<FunctionDef> Parser::funcDef() {
     }
 
     // 6. 解析函数体
-    std::shared_ptr<BlockStmt> body;
+    BlockStmt* body = nullptr;
     try {
         body = block();
     }
@@ -250,33 +311,31 @@ std::shared_ptr<FunctionDef> Parser::funcDef() {
         return nullptr;
     }
 
-    return std::make_shared<FunctionDef>(returnTypeStr, name, params, body, line, column);
+    return arena.make<FunctionDef>(returnTypeStr, name, arena.copyList(params), body, offset);
 }
 
 //解析函数参数
 Param Parser::param() {
-    int line = peek(0).line;
-    int column = peek(0).column;
+    SourceOffset offset = peek(0).offset;
 
     consume(TokenType::INT, "Parameter type must be 'int'.");
-    Token name = consume(TokenType::IDENTIFIER, "Expected parameter name.");
-    return Param(name.lexeme, line, column);
+    const Token& name = consume(TokenType::IDENTIFIER, "Expected parameter name.");
+    return Param(name.symbol, offset);
 }
 
 //解析代码块,block → '{' {stmt} '}'
-std::shared_ptr<BlockStmt> Parser::block() {
-    int line = peek(0).line;
-    int column = peek(0).column;
+BlockStmt* Parser::block() {
+    SourceOffset offset = peek(0).offset;
     try {
         consume(TokenType::LBRACE, "Expected '{' before block.");
     }
     catch (const ParseError& e) {
         synchronize();
         // 创建一个空的代码块作为替代
-        return std::make_shared<BlockStmt>(std::vector<std::shared_ptr<Stmt>>());
+        return arena.make<BlockStmt>(NodeList<Stmt*>());
     }
 
-    std::vector<std::shared_ptr<Stmt>> statements;
+    std::vector<Stmt*> statements;
     while (!check(TokenType::RBRACE) && !isAtEnd()) {
         try {
             auto statement = stmt();
@@ -300,7 +359,7 @@ std::shared_ptr<BlockStmt> Parser::block() {
         synchronize();
     }
 
-    return std::make_shared<BlockStmt>(statements, line, column);
+    return arena.make<BlockStmt>(arena.copyList(statements), offset);
 }
 
 //解析语句
@@ -314,9 +373,9 @@ std::shared_ptr<BlockStmt> Parser::block() {
            | returnStmt
            | assignStmt
 */
-std::shared_ptr<Stmt> Parser::stmt() {
+Stmt* Parser::stmt() {
     if (match({TokenType::SEMICOLON})) {
-        return std::make_shared<ExprStmt>(nullptr); // 空语句
+        return arena.make<ExprStmt>(nullptr); // 空语句
     }
     
     if (check(TokenType::LBRACE)) {
@@ -357,235 +416,230 @@ std::shared_ptr<Stmt> Parser::stmt() {
 }
 
 //解析表达式语句,exprStmt → expr ';'
-std::shared_ptr<Stmt> Parser::exprStmt() {
-    int line = peek(0).line;
-    int column = peek(0).column;
+Stmt* Parser::exprStmt() {
+    SourceOffset offset = peek(0).offset;
     
     auto expression = expr();
     consume(TokenType::SEMICOLON, "Expected ';' after expression.");
-    return std::make_shared<ExprStmt>(expression);
+    return arena.make<ExprStmt>(expression, offset);
 }
 
 //解析变量声明语句,varDeclStmt → 'int' IDENT '=' expr ';'
-std::shared_ptr<Stmt> Parser::varDeclStmt() {
-    int line = previous().line;
-    int column = previous().column;
+Stmt* Parser::varDeclStmt() {
+    SourceOffset offset = previous().offset;
 
-    Token name = consume(TokenType::IDENTIFIER, "Expected variable name after 'int'.");
+    SymbolId name = consume(TokenType::IDENTIFIER, "Expected variable name after 'int'.").symbol;
     
     // 必须有初始化器
     consume(TokenType::ASSIGN, "Expected '=' after variable name.");
     auto initializer = expr();
     
     consume(TokenType::SEMICOLON, "Expected ';' after variable declaration.");
-    return std::make_shared<VarDeclStmt>(name.lexeme, initializer, line, column);
+    return arena.make<VarDeclStmt>(name, initializer, offset);
 }
 
 //解析赋值语句,assignStmt → IDENT '=' expr ';'
-std::shared_ptr<Stmt> Parser::assignStmt() {
-    int line = peek(0).line;
-    int column = peek(0).column;
+Stmt* Parser::assignStmt() {
+    SourceOffset offset = peek(0).offset;
 
-    Token name = consume(TokenType::IDENTIFIER, "Expected variable name.");
+    SymbolId name = consume(TokenType::IDENTIFIER, "Expected variable name.").symbol;
     consume(TokenType::ASSIGN, "Expected '=' after variable name.");
     
     auto value = expr();
     
     consume(TokenType::SEMICOLON, "Expected ';' after assignment.");
-    return std::make_shared<AssignStmt>(name.lexeme, value, line, column);
+    return arena.make<AssignStmt>(name, value, offset);
 }
 
 //解析if语句,ifStmt → 'if' '(' expr ')' stmt ['else' stmt]
-std::shared_ptr<Stmt> Parser::ifStmt() {
-    int line = previous().line;  // 'if' token 的位置
-    int column = previous().column;
+Stmt* Parser::ifStmt() {
+    SourceOffset offset = previous().offset;  // 'if' token 的位置
 
     consume(TokenType::LPAREN, "Expected '(' after 'if'.");
     auto condition = expr();
     consume(TokenType::RPAREN, "Expected ')' after if condition.");
     
     auto thenBranch = stmt();
-    std::shared_ptr<Stmt> elseBranch = nullptr;
+    Stmt* elseBranch = nullptr;
     
     if (match({TokenType::ELSE})) {
         elseBranch = stmt();
     }
     
-    return std::make_shared<IfStmt>(condition, thenBranch, elseBranch, line, column);
+    return arena.make<IfStmt>(condition, thenBranch, elseBranch, offset);
 }
 
 //解析while语句,whileStmt → 'while' '(' expr ')' stmt
-std::shared_ptr<Stmt> Parser::whileStmt() {
-    int line = previous().line;  // 'while' token 的位置
-    int column = previous().column;
+Stmt* Parser::whileStmt() {
+    SourceOffset offset = previous().offset;  // 'while' token 的位置
     consume(TokenType::LPAREN, "Expected '(' after 'while'.");
     auto condition = expr();
     consume(TokenType::RPAREN, "Expected ')' after while condition.");
     
     auto body = stmt();
     
-    return std::make_shared<WhileStmt>(condition, body, line, column);
+    return arena.make<WhileStmt>(condition, body, offset);
 }
 
 //解析break语句,breakStmt → 'break' ';'
-std::shared_ptr<Stmt> Parser::breakStmt() {
-    int line = previous().line;  // 'break' token 的位置
-    int column = previous().column;
+Stmt* Parser::breakStmt() {
+    SourceOffset offset = previous().offset;  // 'break' token 的位置
 
     consume(TokenType::SEMICOLON, "Expected ';' after 'break'.");
-    return std::make_shared<BreakStmt>(line, column);
+    return arena.make<BreakStmt>(offset);
 }
 
 //解析continue语句,continueStmt → 'continue' ';'
-std::shared_ptr<Stmt> Parser::continueStmt() {
-    int line = previous().line;  // 'continue' token 的位置
-    int column = previous().column;
+Stmt* Parser::continueStmt() {
+    SourceOffset offset = previous().offset;  // 'continue' token 的位置
     consume(TokenType::SEMICOLON, "Expected ';' after 'continue'.");
-    return std::make_shared<ContinueStmt>(line, column);
+    return arena.make<ContinueStmt>(offset);
 }
 
 //解析return语句,returnStmt → 'return' [expr] ';'
-std::shared_ptr<Stmt> Parser::returnStmt() {
-    int line = previous().line;  // 'return' token 的位置
-    int column = previous().column;
+Stmt* Parser::returnStmt() {
+    SourceOffset offset = previous().offset;  // 'return' token 的位置
 
-    std::shared_ptr<Expr> value = nullptr;
+    Expr* value = nullptr;
     if (!check(TokenType::SEMICOLON)) {
         value = expr();
     }
     
     consume(TokenType::SEMICOLON, "Expected ';' after return value.");
-    return std::make_shared<ReturnStmt>(value, line, column);
+    return arena.make<ReturnStmt>(value, offset);
 }
 
-// 表达式解析示例实现,expr → lorExpr
-std::shared_ptr<Expr> Parser::expr() {
-    return lorExpr();
+// 括号、一元运算符和函数调用的最大嵌套层数：语义分析、IR 生成等阶段递归遍历表达式，嵌套过深会耗尽调用栈。
+// 同级的二元运算链（如 a + b + ... + z）不是嵌套，不受限制
+static constexpr int kMaxNestingDepth = 4096;
+
+//表达式,按优先级爬升解析，文法等价于：
+/* expr      → lorExpr
+   lorExpr   → landExpr { '||' landExpr }
+   landExpr  → relExpr { '&&' relExpr }
+   relExpr   → addExpr { ('<' | '>' | '<=' | '>=' | '==' | '!=') addExpr }
+   addExpr   → mulExpr { ('+' | '-') mulExpr }
+   mulExpr   → unaryExpr { ('*' | '/' | '%') unaryExpr }
+   unaryExpr → { ('+' | '-' | '!') } primaryExpr | '(' expr ')'
+*/
+//一元运算符、括号和二元运算符都记录在显式栈上，嵌套再深也不会加深调用栈；
+//只有函数调用的实参会递归调用 climbExpr()
+Expr* Parser::expr() {
+    // 之前的语句出错时栈中可能留有未归约的成分
+    pending.clear();
+    nestingDepth = 0;
+    return climbExpr();
 }
 
-//逻辑或表达式,lorExpr → landExpr { '||' landExpr }
-std::shared_ptr<Expr> Parser::lorExpr() {
-    auto expr = landExpr();
-    
-    while (match({TokenType::OR})) {
-        std::string op = previous().lexeme;
-        auto right = landExpr();
-        expr = std::make_shared<BinaryExpr>(expr, op, right);
+// 进入一层括号、一元运算符或函数调用
+void Parser::enterNesting() {
+    if (++nestingDepth > kMaxNestingDepth) {
+        throw error(previous(), "Expression is nested too deeply.");
     }
-    
-    return expr;
 }
 
-//逻辑与表达式,landExpr → relExpr { '&&' relExpr }
-std::shared_ptr<Expr> Parser::landExpr() {
-    auto expr = relExpr();
-    
-    while (match({TokenType::AND})) {
-        std::string op = previous().lexeme;
-        auto right = relExpr();
-        expr = std::make_shared<BinaryExpr>(expr, op, right);
-    }
-    
-    return expr;
-}
+Expr* Parser::climbExpr() {
+    // 嵌套的 climbExpr()（函数调用的实参）只归约自己压入栈的成分
+    const size_t base = pending.size();
+
+    while (true) {
+        // 1. 前缀：一元运算符和左括号
+        while (true) {
+            if (match({TokenType::PLUS, TokenType::MINUS, TokenType::NOT})) {
+                enterNesting();
+                pending.push_back({PendingOperator::Kind::Unary, 0, BinOp::Or, unaryOp(previous().type),
+                                   nullptr, previous().offset});
+            } else if (match({TokenType::LPAREN})) {
+                enterNesting();
+                pending.push_back({PendingOperator::Kind::Paren, 0, BinOp::Or, UnOp::Plus,
+                                   nullptr, previous().offset});
+            } else {
+                break;
+            }
+        }
 
-//关系表达式,relExpr → addExpr { ('<' | '>' | '<=' | '>=' | '==' | '!=') addExpr }
-std::shared_ptr<Expr> Parser::relExpr() {
-    auto expr = addExpr();
-    
-    while (match({TokenType::LT, TokenType::GT, TokenType::LE, 
-                 TokenType::GE, TokenType::EQ, TokenType::NEQ})) {
-        std::string op = previous().lexeme;
-        auto right = addExpr();
-        expr = std::make_shared<BinaryExpr>(expr, op, right);
-    }
-    
-    return expr;
-}
+        Expr* operand = primaryExpr();
+
+        // 2. 后缀：按优先级归约，直到遇到下一个二元运算符或表达式结束
+        while (true) {
+            BinaryOperatorInfo next = binaryOperator(peek(0).type);
+
+            // 一元运算符总是先归约；二元运算符在优先级不低于下一个运算符时归约（左结合）
+            while (pending.size() > base) {
+                const PendingOperator& top = pending.back();
+                if (top.kind == PendingOperator::Kind::Unary) {
+                    operand = arena.make<UnaryExpr>(top.unaryOp, operand, top.offset);
+                    --nestingDepth;
+                } else if (top.kind == PendingOperator::Kind::Binary && top.precedence >= next.precedence) {
+                    operand = arena.make<BinaryExpr>(top.left, top.binaryOp, operand, top.offset);
+                } else {
+                    break;
+                }
+                pending.pop_back();
+            }
 
-//加减表达式,addExpr → mulExpr { ('+' | '-') mulExpr }
-std::shared_ptr<Expr> Parser::addExpr() {
-    auto expr = mulExpr();
-    
-    while (match({TokenType::PLUS, TokenType::MINUS})) {
-        std::string op = previous().lexeme;
-        auto right = mulExpr();
-        expr = std::make_shared<BinaryExpr>(expr, op, right);
-    }
-    
-    return expr;
-}
+            if (next.precedence > 0) {
+                // 移进二元运算符，继续解析右操作数
+                const Token& op = advance();
+                pending.push_back({PendingOperator::Kind::Binary, next.precedence, next.op, UnOp::Plus,
+                                   operand, op.offset});
+                break;
+            }
 
-//乘除模表达式,mulExpr → unaryExpr { ('*' | '/' | '%') unaryExpr }
-std::shared_ptr<Expr> Parser::mulExpr() {
-    auto expr = unaryExpr();
-    
-    while (match({TokenType::MULTIPLY, TokenType::DIVIDE, TokenType::MODULO})) {
-        std::string op = previous().lexeme;
-        int line = previous().line;
-        int column = previous().column;
-        auto right = unaryExpr();
-        expr = std::make_shared<BinaryExpr>(expr, op, right, line, column);
-    }
-    
-    return expr;
-}
+            if (pending.size() == base) {
+                return operand;
+            }
 
-//一元表达式,unaryExpr → { ('+' | '-' | '!') } primaryExpr
-std::shared_ptr<Expr> Parser::unaryExpr() {
-    if (match({TokenType::PLUS, TokenType::MINUS, TokenType::NOT})) {
-        std::string op = previous().lexeme;
-        int line = previous().line;
-        int column = previous().column;
-        auto right = unaryExpr();
-        return std::make_shared<UnaryExpr>(op, right, line, column);
+            // 栈顶只可能是左括号：括号内的表达式已完整
+            consume(TokenType::RPAREN, "Expected ')' after expression.");
+            pending.pop_back();
+            --nestingDepth;
+        }
     }
-    
-    return primaryExpr();
 }
 
-//基础表达式
+//基础表达式（括号表达式由 climbExpr() 处理）
 /* primaryExpr → NUM
                    | IDENT
                    | IDENT '(' [args] ')'
-                   | '(' expr ')'
 */
-std::shared_ptr<Expr> Parser::primaryExpr() {
+Expr* Parser::primaryExpr() {
     if (match({TokenType::NUMBER})) {
-        int value = std::stoi(previous().lexeme);
-        int line = previous().line;
-        int column = previous().column;
-        return std::make_shared<NumberExpr>(value, line, column);
+        const Token& number = previous();
+        // 直接在源代码视图上解析数值，避免构造临时字符串
+        std::string_view text = lexeme(number);
+        int value = 0;
+        auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+        if (ec != std::errc() || end != text.data() + text.size()) {
+            throw error(number, "Integer literal out of range.");
+        }
+        return arena.make<NumberExpr>(value, number.offset);
     }
     
     if (match({TokenType::IDENTIFIER})) {
-        std::string name = previous().lexeme;
-        int line = previous().line;
-        int column = previous().column;
+        SymbolId name = previous().symbol;
+        SourceOffset offset = previous().offset;
         
         // 检查是否是函数调用
         if (match({TokenType::LPAREN})) {
-            std::vector<std::shared_ptr<Expr>> arguments;
+            std::vector<Expr*> arguments;
+            // 实参递归解析，嵌套层数受限，解析器自身的调用栈也不会过深
+            enterNesting();
             
             if (!check(TokenType::RPAREN)) {
                 do {
-                    arguments.push_back(expr());
+                    arguments.push_back(climbExpr());
                 } while (match({TokenType::COMMA}));
             }
             
             consume(TokenType::RPAREN, "Expected ')' after arguments.");
+            --nestingDepth;
             
-            return std::make_shared<CallExpr>(name, arguments, line, column);
+            return arena.make<CallExpr>(name, arena.copyList(arguments), offset);
         }
         
         // 否则是变量引用
-        return std::make_shared<VariableExpr>(name, line, column);
-    }
-    
-    if (match({TokenType::LPAREN})) {
-        auto expression = expr();
-        consume(TokenType::RPAREN, "Expected ')' after expression.");
-        return expression;
+        return arena.make<VariableExpr>(name, offset);
     }
     
     throw error(peek(0), "Expected expression.");
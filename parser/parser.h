@@ -1,7 +1,9 @@
 // parser/parser.h - 定义了语法分析器的接口和结构
 #pragma once
 #include "lexer/Token.h"
+#include "lexer/tokenStream.h"
 #include "parser/ast.h"
+#include <iostream>
 #include <vector>
 #include <memory>
 #include <stdexcept>
@@ -15,59 +17,81 @@ public:
 //实现了一个自顶向下的语法分析器，根据文法规则解析Token序列生成AST
 class Parser {
 private:
-    std::vector<Token> tokens;
-    int current = 0;
+    TokenStream tokens;  // Token来源（流式或已生成的序列），只保留前瞻所需的少量Token
+    const SourceManager& sources;  // 源代码管理器，用于取词素和输出错误位置
     bool hadError = false;  // 添加一个标记，记录是否遇到过错误
     int errorCount = 0;  // 添加错误计数
     bool isRecovering = false;  // 标记是否正在从错误中恢复
+    Arena arena;  // 节点所在的内存池，解析完成后移交给 CompUnit
+    std::ostream* diagnostics = &std::cerr;  // 错误信息的输出目标
+
+    // 表达式解析中尚未归约的前缀或中缀成分
+    struct PendingOperator {
+        enum class Kind : uint8_t { Unary, Binary, Paren };
+
+        Kind kind;
+        int precedence;       // 二元运算符的优先级
+        BinOp binaryOp;
+        UnOp unaryOp;
+        Expr* left;           // 二元运算符的左操作数
+        SourceOffset offset;  // 运算符的位置
+    };
+    std::vector<PendingOperator> pending;  // 表达式解析的显式栈，各次 climbExpr() 共用，嵌套调用只使用自己压入的部分
+    int nestingDepth = 0;  // 尚未闭合的括号、一元运算符和函数调用层数
 
 public:
-    Parser(const std::vector<Token>& tokens) : tokens(tokens) {}
-    // 开始解析过程，返回编译单元AST根节点
-    std::shared_ptr<CompUnit> parse();
+    // 流式模式：边解析边从词法分析器拉取Token
+    Parser(Lexer& lexer, const SourceManager& sources) : tokens(lexer), sources(sources) {}
+    // 序列模式：读取调用者持有的Token序列，不复制
+    Parser(const std::vector<Token>& tokens, const SourceManager& sources) : tokens(tokens), sources(sources) {}
+    // 片段模式：只解析序列中的 [first, last)，之后视为遇到 end
+    Parser(const Token* first, const Token* last, const Token& end, const SourceManager& sources)
+        : tokens(first, last, end), sources(sources) {}
+    // 开始解析过程，返回编译单元AST根节点（根节点持有整棵树的内存）
+    std::unique_ptr<CompUnit> parse();
     bool hasError() const { return hadError; }  // 公共方法返回是否有错误
 
+    // 片段模式使用：解析全部函数定义，节点留在本解析器的内存池中
+    std::vector<FunctionDef*> parseFunctions();
+    // 交出内存池（与 parseFunctions 配合，由调用者合并到 CompUnit）
+    Arena releaseArena() { return std::move(arena); }
+    // 将错误信息写到指定的流（并行解析时每个解析器各自缓冲）
+    void setDiagnostics(std::ostream& stream) { diagnostics = &stream; }
+
 private:
     // 辅助方法
-    // 查看当前位置向前偏移的标记
-    Token peek(int offset) const {
-        if (current + offset >= tokens.size()) {
-            return tokens.back(); // 返回EOF token
-        }
-        return tokens[current + offset];
-    }
-    Token previous() const;// 返回前一个已处理的标记
+    // 查看当前位置向前偏移的标记（返回引用，前瞻时不复制Token）
+    const Token& peek(int offset) const { return tokens.peek(offset); }
+    const Token& previous() const;// 返回前一个已处理的标记
+    std::string_view lexeme(const Token& token) const { return sources.slice(token.offset, token.length); }// 取标记的词素
     bool isAtEnd() const;// 检查是否已到达标记序列末尾
-    Token advance();// 前进到下一个标记并返回当前标记
+    const Token& advance();// 前进到下一个标记并返回当前标记
     bool check(TokenType type) const;// 检查当前标记是否为指定类型
     bool match(std::initializer_list<TokenType> types);// 尝试匹配指定类型的标记，成功则消费该标记
-    Token consume(TokenType type, const std::string& message);// 消费指定类型的标记，如果类型不匹配则报错
+    const Token& consume(TokenType type, const std::string& message);// 消费指定类型的标记，如果类型不匹配则报错
     ParseError error(const Token& token, const std::string& message);// 生成解析错误
     void synchronize();// 错误恢复：同步到下一个语句或声明的开始
 
     // 递归下降解析方法 - 按照文法从上到下实现
-    std::shared_ptr<CompUnit> compUnit();    // 解析编译单元
-    std::shared_ptr<FunctionDef> funcDef();  // 解析函数定义
+    std::unique_ptr<CompUnit> compUnit();    // 解析编译单元
+    std::vector<FunctionDef*> functionDefs(); // 解析到末尾为止的所有函数定义
+    FunctionDef* funcDef();             // 解析函数定义
     Param param();                           // 解析函数参数
-    std::shared_ptr<Stmt> stmt();           // 解析语句
-    std::shared_ptr<BlockStmt> block();     // 解析语句块
-    std::shared_ptr<Stmt> exprStmt();       // 解析表达式语句
-    std::shared_ptr<Stmt> varDeclStmt();    // 解析变量声明语句
-    std::shared_ptr<Stmt> assignStmt();     // 解析赋值语句
-    std::shared_ptr<Stmt> ifStmt();         // 解析if语句
-    std::shared_ptr<Stmt> whileStmt();      // 解析while语句
-    std::shared_ptr<Stmt> breakStmt();      // 解析break语句
-    std::shared_ptr<Stmt> continueStmt();   // 解析continue语句
-    std::shared_ptr<Stmt> returnStmt();     // 解析return语句
+    Stmt* stmt();                           // 解析语句
+    BlockStmt* block();                // 解析语句块
+    Stmt* exprStmt();                       // 解析表达式语句
+    Stmt* varDeclStmt();                    // 解析变量声明语句
+    Stmt* assignStmt();                     // 解析赋值语句
+    Stmt* ifStmt();                         // 解析if语句
+    Stmt* whileStmt();                      // 解析while语句
+    Stmt* breakStmt();                      // 解析break语句
+    Stmt* continueStmt();                   // 解析continue语句
+    Stmt* returnStmt();                     // 解析return语句
     
     // 表达式解析方法
-    std::shared_ptr<Expr> expr();           // 解析表达式
-    std::shared_ptr<Expr> lorExpr();        // 解析逻辑或表达式
-    std::shared_ptr<Expr> landExpr();       // 解析逻辑与表达式
-    std::shared_ptr<Expr> relExpr();        // 解析关系表达式
-    std::shared_ptr<Expr> addExpr();        // 解析加减表达式
-    std::shared_ptr<Expr> mulExpr();        // 解析乘除模表达式
-    std::shared_ptr<Expr> unaryExpr();      // 解析一元表达式
-    std::shared_ptr<Expr> primaryExpr();    // 解析基础表达式
+    Expr* expr();                           // 解析语句中的表达式
+    Expr* climbExpr();                      // 解析表达式（优先级爬升，显式栈），函数实参也从这里进入
+    void enterNesting();                    // 进入一层嵌套，超过上限时报错
+    Expr* primaryExpr();                    // 解析基础表达式
 };
 
@@ -1,171 +1,158 @@
 // analyzeHelper.cpp - 实现语义分析辅助工具类
 #include "analyzeHelper.h"
 #include "analyzeVisitor.h"
-#include "semantic.h"
+#include "common/wrapArith.h"
+#include <climits>
 #include <iostream>
 
-// 初始化静态成员
-SemanticAnalyzer* analyzeHelper::semanticOwner = nullptr;
-
-// 设置语义分析器
-void analyzeHelper::setSemanticOwner(SemanticAnalyzer& analyzer) {
-    semanticOwner = &analyzer;
-}
-
-// 进入新作用域 - 创建新的符号表
+// 进入新作用域
 void analyzeHelper::enterScope()
 {
-    owner.getSymbolTables().push_back(std::unordered_map<std::string, Symbol>());
+    owner.getSymbolTable().enterScope();
 }
 
-// 退出当前作用域 - 检查未使用变量并移除当前符号表
+// 退出当前作用域 - 检查未使用变量并撤销本作用域的符号
 void analyzeHelper::exitScope()
 {
-    if (!owner.getSymbolTables().empty())
+    if (owner.getSymbolTable().depth() > 0)
     {
         checkUnusedVariables();  // 退出作用域时检查未使用变量
-        owner.getSymbolTables().pop_back();
+        owner.getSymbolTable().exitScope();
     }
 }
 
-// 在当前作用域声明符号
-bool analyzeHelper::declareSymbol(const std::string &name, Symbol symbol)
+// 在当前作用域声明符号，已存在时声明失败
+bool analyzeHelper::declareSymbol(SymbolId name, Symbol symbol)
 {
-    // 检查符号是否已在当前作用域中定义
-    if (owner.getSymbolTables().back().find(name) != owner.getSymbolTables().back().end())
-    {
-        return false; // 已存在，声明失败
+    return owner.getSymbolTable().declare(name, symbol);
+}
+
+// 查找最内层可见的符号
+Symbol *analyzeHelper::findSymbol(SymbolId name)
+{
+    Symbol *symbol = owner.getSymbolTable().find(name);
+    // 标记变量被使用
+    if (symbol && symbol->kind == Symbol::Kind::VARIABLE) {
+        symbol->used = true;
     }
-    // 添加符号到当前作用域
-    owner.getSymbolTables().back()[name] = symbol;
-    return true;
+    return symbol;
 }
 
-// 在所有可见作用域中查找符号
-Symbol *analyzeHelper::findSymbol(const std::string &name)
+// 尝试在编译时计算表达式的值，结果缓存在表达式节点上
+OptionalInt analyzeHelper::evaluateConstant(Expr* expr)
 {
-    // 从当前作用域向上查找符号（反向遍历）
-    for (auto tableIt = owner.getSymbolTables().rbegin(); tableIt != owner.getSymbolTables().rend(); ++tableIt)
-    {
-        auto symIt = tableIt->find(name);
-        if (symIt != tableIt->end())
-        {
-            // 标记变量被使用
-            if (symIt->second.kind == Symbol::Kind::VARIABLE) {
-                symIt->second.used = true;
-            }
-            return &symIt->second;
-        }
+    if (expr->constState == ConstState::Unevaluated) {
+        OptionalInt value = computeConstant(expr);
+        expr->constState = value ? ConstState::Constant : ConstState::NotConstant;
+        expr->constValue = value.value;
+    }
+    if (expr->constState == ConstState::Constant) {
+        return OptionalInt(expr->constValue);
     }
-    return nullptr;
+    return OptionalInt();
 }
 
-// 尝试在编译时计算表达式的值
-OptionalInt analyzeHelper::evaluateConstant(const std::shared_ptr<Expr>& expr)
+// 计算表达式的值（子表达式仍通过缓存求值）
+OptionalInt analyzeHelper::computeConstant(Expr* expr)
 {
     // 数字字面量
-    if (auto numExpr = std::dynamic_pointer_cast<NumberExpr>(expr)) {
+    if (auto numExpr = nodeCast<NumberExpr>(expr)) {
         return OptionalInt(numExpr->value);
     }
     
     // 一元表达式
-    if (auto unaryExpr = std::dynamic_pointer_cast<UnaryExpr>(expr)) {
+    if (auto unaryExpr = nodeCast<UnaryExpr>(expr)) {
         OptionalInt operandValue = evaluateConstant(unaryExpr->operand);
         if (!operandValue.has_value()) return OptionalInt();
         
-        if (unaryExpr->op == "+") return OptionalInt(*operandValue);
-        if (unaryExpr->op == "-") return OptionalInt(-(*operandValue));
-        if (unaryExpr->op == "!") return OptionalInt(!(*operandValue));
+        switch (unaryExpr->op) {
+            case UnOp::Plus: return OptionalInt(*operandValue);
+            case UnOp::Neg:  return OptionalInt(wrapSub(0, *operandValue));
+            case UnOp::Not:  return OptionalInt(!(*operandValue));
+        }
         
         return OptionalInt();
     }
     
     // 二元表达式
-    if (auto binaryExpr = std::dynamic_pointer_cast<BinaryExpr>(expr)) {
+    if (auto binaryExpr = nodeCast<BinaryExpr>(expr)) {
         OptionalInt leftValue = evaluateConstant(binaryExpr->left);
         OptionalInt rightValue = evaluateConstant(binaryExpr->right);
         
         if (!leftValue.has_value() || !rightValue.has_value()) return OptionalInt();
         
-        if (binaryExpr->op == "+") return OptionalInt(*leftValue + *rightValue);
-        if (binaryExpr->op == "-") return OptionalInt(*leftValue - *rightValue);
-        if (binaryExpr->op == "*") return OptionalInt(*leftValue * *rightValue);
-        if (binaryExpr->op == "/") {
-            if (*rightValue == 0) return OptionalInt(); // 避免除以零
-            return OptionalInt(*leftValue / *rightValue);
-        }
-        if (binaryExpr->op == "%") {
-            if (*rightValue == 0) return OptionalInt(); // 避免除以零
-            return OptionalInt(*leftValue % *rightValue);
+        switch (binaryExpr->op) {
+            case BinOp::Add: return OptionalInt(wrapAdd(*leftValue, *rightValue));
+            case BinOp::Sub: return OptionalInt(wrapSub(*leftValue, *rightValue));
+            case BinOp::Mul: return OptionalInt(wrapMul(*leftValue, *rightValue));
+            case BinOp::Div:
+                if (*rightValue == 0) return OptionalInt(); // 避免除以零
+                if (*leftValue == INT_MIN && *rightValue == -1) return OptionalInt(); // 溢出，留给运行时
+                return OptionalInt(*leftValue / *rightValue);
+            case BinOp::Mod:
+                if (*rightValue == 0) return OptionalInt(); // 避免除以零
+                if (*leftValue == INT_MIN && *rightValue == -1) return OptionalInt();
+                return OptionalInt(*leftValue % *rightValue);
+            case BinOp::Lt:  return OptionalInt(*leftValue < *rightValue ? 1 : 0);
+            case BinOp::Gt:  return OptionalInt(*leftValue > *rightValue ? 1 : 0);
+            case BinOp::Le:  return OptionalInt(*leftValue <= *rightValue ? 1 : 0);
+            case BinOp::Ge:  return OptionalInt(*leftValue >= *rightValue ? 1 : 0);
+            case BinOp::Eq:  return OptionalInt(*leftValue == *rightValue ? 1 : 0);
+            case BinOp::Ne:  return OptionalInt(*leftValue != *rightValue ? 1 : 0);
+            case BinOp::And: return OptionalInt((*leftValue && *rightValue) ? 1 : 0);
+            case BinOp::Or:  return OptionalInt((*leftValue || *rightValue) ? 1 : 0);
         }
-        if (binaryExpr->op == "<") return OptionalInt(*leftValue < *rightValue ? 1 : 0);
-        if (binaryExpr->op == ">") return OptionalInt(*leftValue > *rightValue ? 1 : 0);
-        if (binaryExpr->op == "<=") return OptionalInt(*leftValue <= *rightValue ? 1 : 0);
-        if (binaryExpr->op == ">=") return OptionalInt(*leftValue >= *rightValue ? 1 : 0);
-        if (binaryExpr->op == "==") return OptionalInt(*leftValue == *rightValue ? 1 : 0);
-        if (binaryExpr->op == "!=") return OptionalInt(*leftValue != *rightValue ? 1 : 0);
-        if (binaryExpr->op == "&&") return OptionalInt((*leftValue && *rightValue) ? 1 : 0);
-        if (binaryExpr->op == "||") return OptionalInt((*leftValue || *rightValue) ? 1 : 0);
     }
     
     // 不是常量表达式
     return OptionalInt();
 }
 
-// 报告错误
-void analyzeHelper::error(const std::string &message, int line, int column)
+// 为消息附加位置信息，只有真正输出诊断时才计算行列号
+std::string analyzeHelper::withLocation(const std::string &message, SourceOffset offset) const
 {
-    // 设置错误标志
-    owner.success = false;
-    // 构建完整错误消息
     std::string fullMessage = message;
-    if (line > 0)
+    const SourceManager* sources = owner.getSourceManager();
+    if (offset != kNoLocation && sources)
     {
-        fullMessage += " at line " + std::to_string(line);
-        if (column > 0)
-        {
-            fullMessage += ", column " + std::to_string(column);
-        }
+        SourceLocation location = sources->getLocation(offset);
+        fullMessage += " at line " + std::to_string(location.line) + ", column " + std::to_string(location.column);
     }
+    return fullMessage;
+}
 
-     // 检查是否已报告过相同错误
-    if (reportedErrors.find(fullMessage) == reportedErrors.end()) {
-     // 将错误添加到集合中
-     reportedErrors.insert(fullMessage);
-     owner.errorMessages.push_back(fullMessage);
-
-     // 同时添加到语义分析器的错误集合中（如果设置了）
-     if (semanticOwner) {
-         semanticOwner->success = false;
-         semanticOwner->errorMessages.push_back(fullMessage);
-     }
- }
+// 报告错误
+void analyzeHelper::error(const std::string &message, SourceOffset offset)
+{
+    // 构建完整错误消息
+    addError(withLocation(message, offset));
 }
 
 // 报告警告
-void analyzeHelper::warning(const std::string &message, int line, int column)
+void analyzeHelper::warning(const std::string &message, SourceOffset offset)
 {
     // 构建完整警告消息
-    std::string fullMessage = message;
-    if (line > 0)
-    {
-        fullMessage += " at line " + std::to_string(line);
-        if (column > 0)
-        {
-            fullMessage += ", column " + std::to_string(column);
-        }
-    }
-    // 检查是否已报告过相同警告
-    if (reportedWarnings.find(fullMessage) == reportedWarnings.end()) {
-    // 将警告添加到集合中
-    reportedWarnings.insert(fullMessage);
-    owner.warningMessages.push_back(fullMessage);
+    addWarning(withLocation(message, offset));
+}
 
-    // 同时添加到语义分析器的警告集合中（如果设置了）
-    if (semanticOwner) {
-        semanticOwner->warningMessages.push_back(fullMessage);
+// 记录完整的错误消息
+void analyzeHelper::addError(const std::string &fullMessage)
+{
+    // 设置错误标志
+    owner.success = false;
+    // 检查是否已报告过相同错误
+    if (reportedErrors.insert(fullMessage).second) {
+        owner.errorMessages.push_back(fullMessage);
     }
 }
+
+// 记录完整的警告消息
+void analyzeHelper::addWarning(const std::string &fullMessage)
+{
+    // 检查是否已报告过相同警告
+    if (reportedWarnings.insert(fullMessage).second) {
+        owner.warningMessages.push_back(fullMessage);
+    }
 }
 // 进入循环
 void analyzeHelper::enterLoop()
@@ -188,13 +175,13 @@ bool analyzeHelper::isValidMainFunction(FunctionDef &funcDef)
     // 检查main函数是否合法
     if (funcDef.returnType != "int")
     {
-        error("main function must return int", funcDef.line, funcDef.column);
+        error("main function must return int", funcDef.offset);
         return false;
     }
     // main函数不能有参数
     if (!funcDef.params.empty())
     {
-        error("main function cannot have parameters", funcDef.line, funcDef.column);
+        error("main function cannot have parameters", funcDef.offset);
         return false;
     }
     return true;
@@ -204,69 +191,66 @@ bool analyzeHelper::isValidMainFunction(FunctionDef &funcDef)
 void analyzeHelper::checkUnusedVariables()
 {
     // 检查当前作用域中的所有变量
-    if (!owner.getSymbolTables().empty()) {
-        auto& currentScope = owner.getSymbolTables().back();
-        for (const auto& [name, symbol] : currentScope) {
+    if (owner.getSymbolTable().depth() > 0) {
+        for (const auto& [name, symbol, shadowed] : owner.getSymbolTable().currentScope()) {
             // 只检查变量，不检查函数
             if (symbol.kind == Symbol::Kind::VARIABLE && !symbol.used) {
-                warning("Variable '" + name + "' declared but never used", symbol.line, symbol.column);
+                warning("Variable '" + owner.nameOf(name) + "' declared but never used", symbol.offset);
             }
         }
     }
 }
 
 // 死代码检测实现
-void analyzeHelper::detectDeadCode(const std::shared_ptr<Stmt>& stmt)
+void analyzeHelper::detectDeadCode(Stmt* stmt)
 {
     // 检查if语句中恒为真或恒为假的条件
-    if (auto ifStmt = dynamic_cast<IfStmt*>(stmt.get())) {
+    if (auto ifStmt = nodeCast<IfStmt>(stmt)) {
         if (auto constValue = evaluateConstant(ifStmt->condition)) {
             if (*constValue) {
                 // 条件恒为真，else分支永远不会执行
                 if (ifStmt->elseBranch) {
                     warning("This else branch will never execute (condition always true)", 
-                            getLineNumber(ifStmt->elseBranch), 
-                            ifStmt->elseBranch->column);
+                            ifStmt->elseBranch->offset);
                 }
             } else {
                 // 条件恒为假，then分支永远不会执行
                 warning("This if branch will never execute (condition always false)", 
-                        getLineNumber(ifStmt->thenBranch), 
-                        ifStmt->thenBranch->column);
+                        ifStmt->thenBranch->offset);
             }
         }
     }
     
     // 检查while语句中恒为假的条件
-    if (auto whileStmt = dynamic_cast<WhileStmt*>(stmt.get())) {
+    if (auto whileStmt = nodeCast<WhileStmt>(stmt)) {
         if (auto constValue = evaluateConstant(whileStmt->condition)) {
             if (!(*constValue)) {
                 warning("This while loop will never execute (condition always false)", 
-                        whileStmt->line, whileStmt->column);
+                        whileStmt->offset);
             }
         }
     }
 }
 
 // 增强函数调用分析
-bool analyzeHelper::validateFunctionCall(const std::string& name, const std::vector<std::shared_ptr<Expr>>& args, int line, int column)
+bool analyzeHelper::validateFunctionCall(SymbolId name, const NodeList<Expr*>& args, SourceOffset offset)
 {
     // 查找函数符号
     Symbol* symbol = findSymbol(name);
     if (!symbol) {
-        error("Call to undeclared function '" + name + "'", line, column);
+        error("Call to undeclared function '" + owner.nameOf(name) + "'", offset);
         return false;
     }
     
     if (symbol->kind != Symbol::Kind::FUNCTION) {
-        error("'" + name + "' is not a function", line, column);
+        error("'" + owner.nameOf(name) + "' is not a function", offset);
         return false;
     }
     
     // 检查参数数量是否匹配
     if (symbol->params.size() != args.size()) {
-        error("Function '" + name + "' expects " + std::to_string(symbol->params.size()) + 
-              " arguments but got " + std::to_string(args.size()) + " 个", line, column);
+        error("Function '" + owner.nameOf(name) + "' expects " + std::to_string(symbol->params.size()) + 
+              " arguments but got " + std::to_string(args.size()) + " 个", offset);
         return false;
     }
     
@@ -277,11 +261,11 @@ bool analyzeHelper::validateFunctionCall(const std::string& name, const std::vec
 }
 
 // 增强类型检查
-bool analyzeHelper::checkTypeCompatibility(const std::shared_ptr<Expr>& expr, const std::string& expectedType, int line, int column)
+bool analyzeHelper::checkTypeCompatibility(const Expr* expr, const std::string& expectedType, SourceOffset offset)
 {
     // 在这个简单的语言中，所有表达式都是int类型，所以只需检查expectedType是否为int
     if (expectedType != "int") {
-        error("Type mismatch: expected '" + expectedType + "' type", line, column);
+        error("Type mismatch: expected '" + expectedType + "' type", offset);
         return false;
     }
     
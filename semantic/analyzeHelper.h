@@ -4,6 +4,7 @@
 #include <optional>
 #include <unordered_map>
 #include <stdexcept>
+#include <algorithm>
 #include <memory>
 #include <vector>
 #include <set>
@@ -11,7 +12,6 @@
 #include "parser/ast.h"
 
 class analyzeVisitor;
-class SemanticAnalyzer;
 
 // OptionalInt - 替代 std::optional<int> 的简单结构体
 // 用于表示可能存在也可能不存在的整数值
@@ -35,23 +35,40 @@ struct OptionalInt {
     explicit operator bool() const { return hasValue; }
 };
 
+// 按源代码位置排列函数表中的条目
+// 表以标识符编号为键，遍历顺序与源代码无关，输出诊断前先排序以保证结果稳定
+template <typename Table>
+std::vector<const typename Table::value_type*> inSourceOrder(const Table& table) {
+    std::vector<const typename Table::value_type*> entries;
+    entries.reserve(table.size());
+    for (const auto& entry : table) {
+        entries.push_back(&entry);
+    }
+    std::sort(entries.begin(), entries.end(), [](const auto* a, const auto* b) {
+        return a->second.offset < b->second.offset;
+    });
+    return entries;
+}
+
 // analyzeHelper - 语义分析辅助工具类
 class analyzeHelper
 {
 private: 
     analyzeVisitor &owner;                  // 所属的分析访问者
-    static SemanticAnalyzer* semanticOwner; // 添加指向语义分析器的指针
 
     // 用于跟踪已报告的错误和警告，防止重复
     std::set<std::string> reportedErrors;  // 已报告的错误集合
     std::set<std::string> reportedWarnings;// 已报告的警告集合
 
+    // 计算表达式的常量值，不查缓存（由 evaluateConstant 调用）
+    static OptionalInt computeConstant(Expr* expr);
+
+    // 在消息后附加 " at line L, column C"（按需由偏移量计算行列号）
+    std::string withLocation(const std::string &message, SourceOffset offset) const;
+
 public:
     explicit analyzeHelper(analyzeVisitor &owner) : owner(owner) {}
 
-    // 设置语义分析器
-    static void setSemanticOwner(SemanticAnalyzer& analyzer);
-
     // === 作用域管理 ===
     
     // 进入新作用域
@@ -68,10 +85,10 @@ public:
     // === 符号表操作 ===
     
     // 在当前作用域声明符号
-    bool declareSymbol(const std::string &name, Symbol symbol); 
+    bool declareSymbol(SymbolId name, Symbol symbol);             
     
     // 在所有可见作用域中查找符号
-    Symbol *findSymbol(const std::string &name);                  
+    Symbol *findSymbol(SymbolId name);                              
 
     // === 循环控制流检查 ===
     
@@ -88,16 +105,21 @@ public:
 
     // === 常量表达式求值 ===
     
-    // 尝试在编译时计算表达式的值（用于除零检查和死代码检测）
-    OptionalInt evaluateConstant(const std::shared_ptr<Expr>& expr);
+    // 尝试在编译时计算表达式的值（用于除零检查、死代码检测和常量折叠）
+    // 结果缓存在表达式节点上，同一棵子树只计算一次
+    static OptionalInt evaluateConstant(Expr* expr);
 
     // === 错误和警告处理 ===
     
     // 报告错误
-    void error(const std::string &message, int line = 0, int column = 0);
+    void error(const std::string &message, SourceOffset offset = kNoLocation);
     
     // 报告警告
-    void warning(const std::string &message, int line = 0, int column = 0);
+    void warning(const std::string &message, SourceOffset offset = kNoLocation);
+
+    // 记录已附加位置信息的错误/警告（用于合并其它访问者的诊断）
+    void addError(const std::string &fullMessage);
+    void addWarning(const std::string &fullMessage);
 
 
     // === 高级检查 ===
@@ -106,35 +128,15 @@ public:
     void checkUnusedVariables();
 
     // 死代码检测
-    void detectDeadCode(const std::shared_ptr<Stmt>& stmt);
+    void detectDeadCode(Stmt* stmt);
     
     // 函数调用验证
-    bool validateFunctionCall(const std::string& name, const std::vector<std::shared_ptr<Expr>>& args, int line, int column);
+    bool validateFunctionCall(SymbolId name, const NodeList<Expr*>& args, SourceOffset offset);
     
     // 类型兼容性检查
-    bool checkTypeCompatibility(const std::shared_ptr<Expr>& expr, const std::string& expectedType, int line, int column);
+    bool checkTypeCompatibility(const Expr* expr, const std::string& expectedType, SourceOffset offset);
 
      // === 辅助方法 ===
-    
-    // 获取表达式的行号
-    int getLineNumber(Expr &expr) {
-        return expr.line;
-    }
-
-    // 获取语句的行号
-    int getLineNumber(Stmt &stmt) {
-        return stmt.line;
-    }
-    
-    // 获取语句指针的行号
-    int getLineNumber(const std::shared_ptr<Stmt> &stmt)
-    {
-        if (stmt)
-        {
-            return getLineNumber(*stmt);
-        }
-        return 0;
-    }
 
     // 重置错误和警告跟踪
     void resetReports() {
@@ -147,9 +149,8 @@ public:
 class SemanticError : public std::runtime_error
 {
 public:
-    int line;
-    int column;
+    SourceOffset offset;
 
-    SemanticError(const std::string &message, int line = 0, int column = 0)
-        : std::runtime_error(message), line(line), column(column) {}
+    SemanticError(const std::string &message, SourceOffset offset = kNoLocation)
+        : std::runtime_error(message), offset(offset) {}
 };
@@ -2,8 +2,14 @@
 #include <string>
 #include "analyzeVisitor.h"
 
+// 函数定义中声明的返回类型
+static ExprType declaredReturnType(const FunctionDef &funcDef)
+{
+    return funcDef.returnType == "void" ? ExprType::Void : ExprType::Int;
+}
+
 // 构造
-analyzeVisitor::analyzeVisitor() : typeChecker(*this), helper(*this)
+analyzeVisitor::analyzeVisitor() : helper(*this)
 {
     // 初始全局作用域
     helper.enterScope();
@@ -13,7 +19,7 @@ analyzeVisitor::analyzeVisitor() : typeChecker(*this), helper(*this)
 analyzeVisitor::~analyzeVisitor()
 {
     // 清理所有作用域
-    while (!symbolTables.empty())
+    while (symbolTable.depth() > 0)
     {
         helper.exitScope();
     }
@@ -22,14 +28,11 @@ analyzeVisitor::~analyzeVisitor()
 // 未使用变量检查
 void analyzeVisitor::checkUnusedVariables()
 {
-    // 遍历所有符号表检查未使用的变量
-    for (size_t scopeIndex = 0; scopeIndex < symbolTables.size(); ++scopeIndex) {
-        const auto& scope = symbolTables[scopeIndex];
-        for (const auto& [name, symbol] : scope) {
-            if ((symbol.kind == Symbol::Kind::VARIABLE || symbol.kind == Symbol::Kind::PARAMETER) && 
-                !symbol.used) {
-                helper.warning("Variable '" + name + "' declared but never used", symbol.line, symbol.column);
-            }
+    // 遍历所有作用域中的符号检查未使用的变量（绑定按声明顺序排列）
+    for (const auto& [name, symbol, shadowed] : symbolTable.all()) {
+        if ((symbol.kind == Symbol::Kind::VARIABLE || symbol.kind == Symbol::Kind::PARAMETER) && 
+            !symbol.used) {
+            helper.warning("Variable '" + nameOf(name) + "' declared but never used", symbol.offset);
         }
     }
 }
@@ -38,18 +41,18 @@ void analyzeVisitor::checkUnusedVariables()
 void analyzeVisitor::detectDeadCode()
 {
     // 遍历函数表检查未使用的函数
-    for (const auto& [name, info] : functionTable) {
-        if (name != "main") {
+    for (const auto* entry : inSourceOrder(*functions)) {
+        const auto& [name, info] = *entry;
+        if (name != mainSymbol) {
             bool used = false;
-            for (const auto& scope : symbolTables) {
-                auto it = scope.find(name);
-                if (it != scope.end() && it->second.kind == Symbol::Kind::FUNCTION && it->second.used) {
+            for (const auto& binding : symbolTable.all()) {
+                if (binding.name == name && binding.value.kind == Symbol::Kind::FUNCTION && binding.value.used) {
                     used = true;
                     break;
                 }
             }
             if (!used) {
-                helper.warning("Function '" + name + "' defined but never used", info.line);
+                helper.warning("Function '" + nameOf(name) + "' defined but never used", info.offset);
             }
         }
     }
@@ -59,6 +62,7 @@ void analyzeVisitor::detectDeadCode()
 void analyzeVisitor::visit(NumberExpr &expr)
 {
     // 数字字面量总是int类型，无需额外检查
+    expr.type = ExprType::Int;
 }
 // 访问变量引用
 void analyzeVisitor::visit(VariableExpr &expr)
@@ -67,41 +71,44 @@ void analyzeVisitor::visit(VariableExpr &expr)
     Symbol *symbol = helper.findSymbol(expr.name);
     if (!symbol)
     {
-        helper.error("Undefined variable: " + expr.name, expr.line, expr.column);
+        helper.error("Undefined variable: " + nameOf(expr.name), expr.offset);
+        expr.type = ExprType::Error;
         return;
     }
 
     // 标记变量为已使用
     symbol->used = true;
+    expr.type = symbol->type;
 }
 // 访问二元表达式
 void analyzeVisitor::visit(BinaryExpr &expr)
 {
     // 检查操作数子节点
-    expr.left->accept(*this);
-    expr.right->accept(*this);
-    // 类型检查
-    std::string leftType = typeChecker.getExprType(*expr.left);
-    std::string rightType = typeChecker.getExprType(*expr.right);
-    if (leftType != "int" || rightType != "int")
+    dispatch(*expr.left);
+    dispatch(*expr.right);
+    // 类型检查（操作数的类型已在访问子节点时算出）
+    if (expr.left->type != ExprType::Int || expr.right->type != ExprType::Int)
+    {
+        helper.error("Binary operator '" + std::string(toString(expr.op)) + "' requires int operands", expr.offset);
+        expr.type = ExprType::Error;
+    }
+    else
     {
-        helper.error("Binary operator '" + expr.op + "' requires int operands", expr.line, expr.column);
+        expr.type = ExprType::Int;
     }
     // 除以0检查（不包含调用函数的情况）
-    if (expr.op == "/" || expr.op == "%")
+    if (expr.op == BinOp::Div || expr.op == BinOp::Mod)
     {
         if (auto rval = helper.evaluateConstant(expr.right))
         {
             if (*rval == 0)
             {
-                helper.error("Division by zero", expr.line, expr.column);
+                helper.error("Division by zero", expr.offset);
             }
         }
     }
     // 检查恒为真或恒为假的条件表达式
-    if (expr.op == "==" || expr.op == "!=" || expr.op == "<" || 
-        expr.op == ">" || expr.op == "<=" || expr.op == ">=" ||
-        expr.op == "&&" || expr.op == "||") {
+    if (isConditionOp(expr.op)) {
         auto leftVal = helper.evaluateConstant(expr.left);
         auto rightVal = helper.evaluateConstant(expr.right);
         
@@ -110,21 +117,24 @@ void analyzeVisitor::visit(BinaryExpr &expr)
             bool isAlwaysTrue = false;
             bool isAlwaysFalse = false;
             
-            if (expr.op == "==") isAlwaysTrue = (*leftVal == *rightVal);
-            else if (expr.op == "!=") isAlwaysTrue = (*leftVal != *rightVal);
-            else if (expr.op == "<") isAlwaysTrue = (*leftVal < *rightVal);
-            else if (expr.op == ">") isAlwaysTrue = (*leftVal > *rightVal);
-            else if (expr.op == "<=") isAlwaysTrue = (*leftVal <= *rightVal);
-            else if (expr.op == ">=") isAlwaysTrue = (*leftVal >= *rightVal);
-            else if (expr.op == "&&") isAlwaysTrue = (*leftVal && *rightVal);
-            else if (expr.op == "||") isAlwaysTrue = (*leftVal || *rightVal);
+            switch (expr.op) {
+                case BinOp::Eq:  isAlwaysTrue = (*leftVal == *rightVal); break;
+                case BinOp::Ne:  isAlwaysTrue = (*leftVal != *rightVal); break;
+                case BinOp::Lt:  isAlwaysTrue = (*leftVal < *rightVal); break;
+                case BinOp::Gt:  isAlwaysTrue = (*leftVal > *rightVal); break;
+                case BinOp::Le:  isAlwaysTrue = (*leftVal <= *rightVal); break;
+                case BinOp::Ge:  isAlwaysTrue = (*leftVal >= *rightVal); break;
+                case BinOp::And: isAlwaysTrue = (*leftVal && *rightVal); break;
+                case BinOp::Or:  isAlwaysTrue = (*leftVal || *rightVal); break;
+                default: break;
+            }
             
             isAlwaysFalse = !isAlwaysTrue;
             
             if (isAlwaysTrue) {
-                helper.warning("Condition expression is always true", expr.line, expr.column);
+                helper.warning("Condition expression is always true", expr.offset);
             } else if (isAlwaysFalse) {
-                helper.warning("Condition expression is always false", expr.line, expr.column);
+                helper.warning("Condition expression is always false", expr.offset);
             }
         }
     }
@@ -133,22 +143,28 @@ void analyzeVisitor::visit(BinaryExpr &expr)
 void analyzeVisitor::visit(UnaryExpr &expr)
 {
     // 检查操作数子节点
-    expr.operand->accept(*this);
+    dispatch(*expr.operand);
     // 类型检查
-    std::string operandType = typeChecker.getExprType(*expr.operand);
-    if (operandType != "int")
+    if (expr.operand->type != ExprType::Int)
+    {
+        helper.error("Unary operator '" + std::string(toString(expr.op)) + "' requires int operand", expr.offset);
+        expr.type = ExprType::Error;
+    }
+    else
     {
-        helper.error("Unary operator '" + expr.op + "' requires int operand", expr.line, expr.column);
+        expr.type = ExprType::Int;
     }
 }
 // 访问函数调用表达式
 void analyzeVisitor::visit(CallExpr &expr)
 {
-    // 函数是否被定义
-    std::string callee = expr.callee;
-    if (functionTable.find(callee) == functionTable.end() && callee != currentFunction)
+    // 函数是否被定义（只能调用在当前函数之前定义的函数和当前函数自身）
+    SymbolId callee = expr.callee;
+    auto calleeIt = functions->find(callee);
+    if (calleeIt == functions->end() || calleeIt->second.offset > currentFunctionOffset)
     {
-        helper.error("Undefined function: " + expr.callee, expr.line, expr.column);
+        helper.error("Undefined function: " + nameOf(expr.callee), expr.offset);
+        expr.type = ExprType::Error;
         return;
     }
 
@@ -158,33 +174,30 @@ void analyzeVisitor::visit(CallExpr &expr)
         symbol->used = true;
     }
 
-    FunctionInfo *funcInfo = &(functionTable.find(callee)->second);
+    const FunctionInfo *funcInfo = &calleeIt->second;
     // 参数数量
     if (funcInfo->paramTypes.size() != expr.arguments.size())
     {
-        helper.error("Incorrect number of arguments for function '" + expr.callee + "'", expr.line, expr.column);
+        helper.error("Incorrect number of arguments for function '" + nameOf(expr.callee) + "'", expr.offset);
     }
     // 实参
     for (size_t i = 0; i < expr.arguments.size(); i++)
     {
-        expr.arguments[i]->accept(*this);
+        dispatch(*expr.arguments[i]);
 
          // 增强类型检查 - 检查实参类型
         if (i < funcInfo->paramTypes.size()) {
-            std::string argType = typeChecker.getExprType(*expr.arguments[i]);
+            ExprType argType = expr.arguments[i]->type;
             if (argType != funcInfo->paramTypes[i]) {
-                helper.error("Function '" + expr.callee + "' argument " + std::to_string(i+1) + 
-                          " type mismatch, expected '" + funcInfo->paramTypes[i] + 
-                          "', got '" + argType + "'", 
-                          expr.line, expr.column);
+                helper.error("Function '" + nameOf(expr.callee) + "' argument " + std::to_string(i+1) + 
+                          " type mismatch, expected '" + std::string(toString(funcInfo->paramTypes[i])) + 
+                          "', got '" + std::string(toString(argType)) + "'", 
+                          expr.offset);
             }
         }
     }
-    // 实参类型+返回值类型
-    if (typeChecker.getExprType(expr) != funcInfo->returnType)
-    {
-         helper.error("Function '" + expr.callee + "' return type mismatch", expr.line, expr.column);
-    }
+    // 调用表达式的类型就是函数的返回类型（参数有误时也如此，避免连锁报错）
+    expr.type = funcInfo->returnType;
 }
 
 // 访问表达式语句
@@ -192,30 +205,29 @@ void analyzeVisitor::visit(ExprStmt &stmt)
 {
     if (stmt.expression)
     {
-        stmt.expression->accept(*this);
+        dispatch(*stmt.expression);
     }
 }
 // 访问变量声明语句
 void analyzeVisitor::visit(VarDeclStmt &stmt)
 {
     // 检查变量是否已声明
-    std::string name = stmt.name;
-    if (symbolTables.back().find(name) != symbolTables.back().end())
+    SymbolId name = stmt.name;
+    if (symbolTable.findInCurrentScope(name))
     {
-        helper.error("Variable '" + stmt.name + "' already declared in current scope", stmt.line, stmt.column);
+        helper.error("Variable '" + nameOf(stmt.name) + "' already declared in current scope", stmt.offset);
     }
     // 检查初始值类型
     if (stmt.initializer)
     {
-        stmt.initializer->accept(*this);
-        std::string initType = typeChecker.getExprType(*stmt.initializer);
-        if (initType != "int")
+        dispatch(*stmt.initializer);
+        if (stmt.initializer->type != ExprType::Int)
         {
-            helper.error("Cannot initialize int variable with non-integer expression", stmt.line, stmt.column);
+            helper.error("Cannot initialize int variable with non-integer expression", stmt.offset);
         }
     }
     // 声明变量
-    Symbol symbol(Symbol::Kind::VARIABLE, "int", stmt.line, stmt.column);
+    Symbol symbol(Symbol::Kind::VARIABLE, ExprType::Int, stmt.offset);
     symbol.used = false; // 初始设置为未使用
     helper.declareSymbol(stmt.name, symbol);
 }
@@ -226,7 +238,7 @@ void analyzeVisitor::visit(AssignStmt &stmt)
     Symbol *symbol = helper.findSymbol(stmt.name);
     if (!symbol)
     {
-        helper.error("Undefined variable: " + stmt.name, stmt.line, stmt.column);
+        helper.error("Undefined variable: " + nameOf(stmt.name), stmt.offset);
         return;
     }
     
@@ -236,14 +248,13 @@ void analyzeVisitor::visit(AssignStmt &stmt)
     // 检查变量类型
     if (symbol->kind != Symbol::Kind::VARIABLE && symbol->kind != Symbol::Kind::PARAMETER)
     {
-        helper.error("Cannot assign to '" + stmt.name + "' (not a variable)", stmt.line, stmt.column);
+        helper.error("Cannot assign to '" + nameOf(stmt.name) + "' (not a variable)", stmt.offset);
     }
     // 检查所赋值的类型（避免void函数调用的情况）
-    stmt.value->accept(*this);
-    std::string valueType = typeChecker.getExprType(*stmt.value);
-    if (valueType != "int")
+    dispatch(*stmt.value);
+    if (stmt.value->type != ExprType::Int)
     {
-        helper.error("Type mismatch in assignment to '" + stmt.name + "'", stmt.line, stmt.column);
+        helper.error("Type mismatch in assignment to '" + nameOf(stmt.name) + "'", stmt.offset);
     }
 }
 // 访问语句块
@@ -254,7 +265,7 @@ void analyzeVisitor::visit(BlockStmt &stmt)
     // 分析块中的每个语句
     for (auto &s : stmt.statements)
     {
-        s->accept(*this);
+        dispatch(*s);
     }
     // 离开作用域
     helper.exitScope();
@@ -263,11 +274,10 @@ void analyzeVisitor::visit(BlockStmt &stmt)
 void analyzeVisitor::visit(IfStmt &stmt)
 {
     // 检查条件表达式
-    stmt.condition->accept(*this);
-    std::string condType = typeChecker.getExprType(*stmt.condition);
-    if (condType != "int")
+    dispatch(*stmt.condition);
+    if (stmt.condition->type != ExprType::Int)
     {
-        helper.error("If condition must be integer (used as boolean)", stmt.line, stmt.column);
+        helper.error("If condition must be integer (used as boolean)", stmt.offset);
     }
     
     // 检查恒为真或恒为假的条件
@@ -277,44 +287,43 @@ void analyzeVisitor::visit(IfStmt &stmt)
             // 条件恒为真，else分支是死代码
             if (stmt.elseBranch) {
                 helper.warning("This else branch will never execute (condition always true)", 
-                             stmt.elseBranch->line, stmt.elseBranch->column);
+                             stmt.elseBranch->offset);
             }
         } else {
             // 条件恒为假，then分支是死代码
             helper.warning("This if branch will never execute (condition always false)", 
-                         stmt.thenBranch->line, stmt.thenBranch->column);
+                         stmt.thenBranch->offset);
         }
     }
     
     // 分析then分支
-    stmt.thenBranch->accept(*this);
+    dispatch(*stmt.thenBranch);
     // 分析else分支(如果有)
     if (stmt.elseBranch)
     {
-        stmt.elseBranch->accept(*this);
+        dispatch(*stmt.elseBranch);
     }
 }
 // 访问while语句
 void analyzeVisitor::visit(WhileStmt &stmt)
 {
     // 检查条件表达式
-    stmt.condition->accept(*this);
-    std::string condType = typeChecker.getExprType(*stmt.condition);
-    if (condType != "int")
+    dispatch(*stmt.condition);
+    if (stmt.condition->type != ExprType::Int)
     {
-        helper.error("While condition must be integer (used as boolean)", stmt.line, stmt.column);
+        helper.error("While condition must be integer (used as boolean)", stmt.offset);
     }
     
     // 检查恒为假的条件
     auto condValue = helper.evaluateConstant(stmt.condition);
     if (condValue && *condValue == 0) {
-        helper.warning("This while loop will never execute (condition always false)", stmt.line, stmt.column);
+        helper.warning("This while loop will never execute (condition always false)", stmt.offset);
     }
     
     // 进入循环
     helper.enterLoop();
     // 分析循环体
-    stmt.body->accept(*this);
+    dispatch(*stmt.body);
     // 离开循环
     helper.exitLoop();
 }
@@ -324,7 +333,7 @@ void analyzeVisitor::visit(BreakStmt &stmt)
     // 检查break语句是否在循环内
     if (!helper.isInLoop())
     {
-        helper.error("Break statement must be inside loop", stmt.line, stmt.column);
+        helper.error("Break statement must be inside loop", stmt.offset);
     }
 }
 // 访问continue语句
@@ -333,7 +342,7 @@ void analyzeVisitor::visit(ContinueStmt &stmt)
     // 检查continue语句是否在循环内
     if (!helper.isInLoop())
     {
-        helper.error("Continue statement must be inside loop", stmt.line, stmt.column);
+        helper.error("Continue statement must be inside loop", stmt.offset);
     }
 }
 // 访问return语句
@@ -342,19 +351,19 @@ void analyzeVisitor::visit(ReturnStmt &stmt)
     // return后有非空表达式
     if (stmt.value)
     {
-        stmt.value->accept(*this);
-        std::string returnType = typeChecker.getExprType(*stmt.value);
+        dispatch(*stmt.value);
+        ExprType returnType = stmt.value->type;
         if (returnType != currentFunctionReturnType)
         {
-            helper.error("Return type mismatch: expected '" + currentFunctionReturnType +
-                          "', got '" + returnType + "'", stmt.line, stmt.column);
+            helper.error("Return type mismatch: expected '" + std::string(toString(currentFunctionReturnType)) +
+                          "', got '" + std::string(toString(returnType)) + "'", stmt.offset);
         }
     }
     // 检查不带返回值的return语句
-    else if (currentFunctionReturnType != "void")
+    else if (currentFunctionReturnType != ExprType::Void)
     {
-        helper.error("Function with return type '" + currentFunctionReturnType +
-                      "' must return a value", stmt.line, stmt.column);
+        helper.error("Function with return type '" + std::string(toString(currentFunctionReturnType)) +
+                      "' must return a value", stmt.offset);
     }
 
     hasReturn = true;
@@ -363,62 +372,39 @@ void analyzeVisitor::visit(ReturnStmt &stmt)
 // 访问函数定义
 void analyzeVisitor::visit(FunctionDef &funcDef)
 {
-    int line = funcDef.line;
-    int column = funcDef.column;
-    std::string name = funcDef.name;
+    SourceOffset offset = funcDef.offset;
+    SymbolId name = funcDef.name;
 
-    // 函数名不能重复
-    if (functionTable.count(name)) {
-        helper.error("Duplicate function name", line, column);
-    }
-
-    // 构建函数信息（完整）
-    FunctionInfo info;
-    info.returnType = funcDef.returnType;
-    info.line = line;
-    info.column = column;
-    for (const auto &param : funcDef.params) {
-        info.paramTypes.push_back("int");
-        info.paramNames.push_back(param.name);
-    }
-
-    // 提前注册函数信息（支持递归）
-    functionTable[name] = info;
-
-    // 检查 main 函数合法性
-    if (name == "main" && !helper.isValidMainFunction(funcDef)) {
-        helper.error("Invalid main function declaration", line, column);
-    }
-
-    // 设置当前上下文
+    // 设置当前上下文（签名已在 declareFunctions 中登记）
     currentFunction = name;
-    currentFunctionReturnType = funcDef.returnType;
+    currentFunctionOffset = offset;
+    currentFunctionReturnType = declaredReturnType(funcDef);
     hasReturn = false;
 
     // 进入新作用域
     helper.enterScope();
 
     // 注册函数符号
-    Symbol funcSymbol(Symbol::Kind::FUNCTION, funcDef.returnType, line, column);
-    funcSymbol.used = (name == "main");
+    Symbol funcSymbol(Symbol::Kind::FUNCTION, currentFunctionReturnType, offset);
+    funcSymbol.used = (name == mainSymbol);
     helper.declareSymbol(name, funcSymbol);
 
     // 注册参数符号
     for (size_t i = 0; i < funcDef.params.size(); i++) {
         const auto &param = funcDef.params[i];
-        Symbol paramSymbol(Symbol::Kind::PARAMETER, "int", line, column, i);
+        Symbol paramSymbol(Symbol::Kind::PARAMETER, ExprType::Int, param.offset, i);
         paramSymbol.used = false;
         if (!helper.declareSymbol(param.name, paramSymbol)) {
-            helper.error("Parameter '" + param.name + "' already declared", line, column);
+            helper.error("Parameter '" + nameOf(param.name) + "' already declared", param.offset);
         }
     }
 
     // 访问函数体
-    funcDef.body->accept(*this);
+    dispatch(*funcDef.body);
 
     // 检查 return 语句是否遗漏
-    if (funcDef.returnType != "void" && !hasReturn) {
-        helper.error("Function '" + name + "' has no return statement", line, column);
+    if (currentFunctionReturnType != ExprType::Void && !hasReturn) {
+        helper.error("Function '" + nameOf(name) + "' has no return statement", offset);
     }
 
     // 检查未使用的局部变量和参数
@@ -428,18 +414,35 @@ void analyzeVisitor::visit(FunctionDef &funcDef)
     helper.exitScope();
 
     // 清除上下文
-    currentFunction = "";
-    currentFunctionReturnType = "";
+    currentFunction = kNoSymbol;
+    currentFunctionOffset = kNoLocation;
+    currentFunctionReturnType = ExprType::Unknown;
     hasReturn = false;
 }
 // 访问编译单元
 void analyzeVisitor::visit(CompUnit &compUnit)
+{
+    // 先收集所有函数签名
+    declareFunctions(compUnit);
+    // 再分析每个函数体
+    for (const auto &func : compUnit.functions)
+    {
+        dispatch(*func);
+    }
+    
+    // 检查未使用的函数
+    detectDeadCode();
+}
+
+// 签名收集：登记所有函数的返回类型和参数，检查 main 函数和重复定义
+void analyzeVisitor::declareFunctions(CompUnit &compUnit)
 {
     // 检查是否有main函数
+    mainSymbol = identifiers->lookup("main");
     bool hasMain = false;
     for (const auto &func : compUnit.functions)
     {
-        if (func->name == "main")
+        if (func->name == mainSymbol)
         {
             hasMain = true;
         }
@@ -448,12 +451,50 @@ void analyzeVisitor::visit(CompUnit &compUnit)
     {
         helper.error("Program must have a main function");
     }
-    // 分析每个函数定义(main函数的检查包含在内)
+
     for (const auto &func : compUnit.functions)
     {
-        func->accept(*this);
+        FunctionDef &funcDef = *func;
+        SourceOffset offset = funcDef.offset;
+        SymbolId name = funcDef.name;
+
+        // 函数名不能重复（保留第一个定义）
+        if (functionTable.count(name)) {
+            helper.error("Duplicate function name", offset);
+        } else {
+            FunctionInfo info;
+            info.returnType = declaredReturnType(funcDef);
+            info.offset = offset;
+            for (const auto &param : funcDef.params) {
+                info.paramTypes.push_back(ExprType::Int);
+                info.paramNames.push_back(param.name);
+            }
+            functionTable[name] = info;
+        }
+
+        // 检查 main 函数合法性
+        if (name == mainSymbol && !helper.isValidMainFunction(funcDef)) {
+            helper.error("Invalid main function declaration", offset);
+        }
+    }
+}
+
+// 共享签名收集的结果，用于并行检查函数体的访问者
+void analyzeVisitor::shareSignatures(const analyzeVisitor &collector)
+{
+    functions = collector.functions;
+    mainSymbol = collector.mainSymbol;
+    sourceManager = collector.sourceManager;
+    identifiers = collector.identifiers;
+}
+
+// 并入另一个访问者的诊断信息（仍按完整消息去重）
+void analyzeVisitor::mergeDiagnostics(const analyzeVisitor &other)
+{
+    for (const auto &message : other.errorMessages) {
+        helper.addError(message);
+    }
+    for (const auto &message : other.warningMessages) {
+        helper.addWarning(message);
     }
-    
-    // 检查未使用的函数
-    detectDeadCode();
 }
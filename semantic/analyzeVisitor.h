@@ -3,28 +3,40 @@
 #include <vector>
 #include <unordered_map>
 #include <string>
+#include "common/scopedTable.h"
+#include "common/stringInterner.h"
 #include "parser/astVisitor.h"
-#include "typeVisitor.h"
 #include "analyzeHelper.h"
 #include "infos.h"
 
 // analyzeVisitor - 进行语义分析的AST访问者类
-class analyzeVisitor : public ASTVisitor
+// 类型推导与语义检查在同一次遍历中完成：访问表达式时先访问子节点，
+// 再根据子节点记录的类型计算并记录自身的类型。
+// 分析分两个阶段：先顺序收集所有函数签名，再逐个检查函数体；
+// 函数体之间只共享只读的函数表，因此可以交给多个访问者并行检查
+class analyzeVisitor : public StaticASTVisitor<analyzeVisitor>
 {
 private:
-    // 符号表栈，用于处理作用域
-    std::vector<std::unordered_map<std::string, Symbol>> symbolTables;
-    // 函数表
-    std::unordered_map<std::string, FunctionInfo> functionTable;
+    // 符号表，所有作用域共用一张以标识符编号为键的表
+    ScopedTable<Symbol> symbolTable;
+    // 函数表（由本访问者收集签名时填写）
+    FunctionTable functionTable;
+    // 检查函数体时使用的函数表，并行检查时指向收集签名的访问者的表
+    const FunctionTable* functions = &functionTable;
     // 正在分析的函数
-    std::string currentFunction;
+    SymbolId currentFunction = kNoSymbol;
+    // 正在分析的函数的定义位置，只能调用在此之前定义的函数
+    SourceOffset currentFunctionOffset = kNoLocation;
     // 正在分析的函数的返回类型
-    std::string currentFunctionReturnType;
+    ExprType currentFunctionReturnType = ExprType::Unknown;
     // 当前函数是否有return语句
     bool hasReturn = false;
-
-    // 类型检查器
-    typeVisitor typeChecker;
+    // 源代码管理器，用于在诊断信息中计算行列号
+    const SourceManager* sourceManager = nullptr;
+    // 标识符驻留表，用于在诊断信息中还原名字
+    const StringInterner* identifiers = nullptr;
+    // "main" 的标识符编号，进入编译单元时查找，源代码中没有出现时为 kNoSymbol
+    SymbolId mainSymbol = kNoSymbol;
 
 public:
     bool success = true;
@@ -34,35 +46,55 @@ public:
     // 警告信息集合
     std::vector<std::string> warningMessages;
 
-    // 辅助函数类 （给typeVisitor用,故设为公用）
+    // 辅助函数类
     analyzeHelper helper;
 
     analyzeVisitor();
     ~analyzeVisitor();
+    analyzeVisitor(const analyzeVisitor&) = delete;
+    analyzeVisitor& operator=(const analyzeVisitor&) = delete;
 
     // 表达式
-    void visit(NumberExpr &expr) override;
-    void visit(VariableExpr &expr) override;
-    void visit(BinaryExpr &expr) override;
-    void visit(UnaryExpr &expr) override;
-    void visit(CallExpr &expr) override;
+    void visit(NumberExpr &expr);
+    void visit(VariableExpr &expr);
+    void visit(BinaryExpr &expr);
+    void visit(UnaryExpr &expr);
+    void visit(CallExpr &expr);
     // 语句
-    void visit(ExprStmt &stmt) override;
-    void visit(VarDeclStmt &stmt) override;
-    void visit(AssignStmt &stmt) override;
-    void visit(BlockStmt &stmt) override;
-    void visit(IfStmt &stmt) override;
-    void visit(WhileStmt &stmt) override;
-    void visit(BreakStmt &stmt) override;
-    void visit(ContinueStmt &stmt) override;
-    void visit(ReturnStmt &stmt) override;
+    void visit(ExprStmt &stmt);
+    void visit(VarDeclStmt &stmt);
+    void visit(AssignStmt &stmt);
+    void visit(BlockStmt &stmt);
+    void visit(IfStmt &stmt);
+    void visit(WhileStmt &stmt);
+    void visit(BreakStmt &stmt);
+    void visit(ContinueStmt &stmt);
+    void visit(ReturnStmt &stmt);
     // 其它
-    void visit(FunctionDef &funcDef) override;
-    void visit(CompUnit &compUnit) override;
+    void visit(FunctionDef &funcDef);
+    void visit(CompUnit &compUnit);
+
+    // 设置/获取源代码管理器
+    void setSourceManager(const SourceManager* sources) { sourceManager = sources; }
+    const SourceManager* getSourceManager() const { return sourceManager; }
+
+    // 设置标识符驻留表
+    void setIdentifiers(const StringInterner* names) { identifiers = names; }
+    // 取标识符的文本，用于拼接诊断信息
+    std::string nameOf(SymbolId id) const { return std::string(identifiers->spelling(id)); }
 
     // 暴露符号表、函数表给辅助函数
-    std::vector<std::unordered_map<std::string, Symbol>> &getSymbolTables() { return symbolTables; }
-    std::unordered_map<std::string, FunctionInfo> &getFunctionTable() { return functionTable; }
+    ScopedTable<Symbol> &getSymbolTable() { return symbolTable; }
+    const FunctionTable &getFunctionTable() const { return *functions; }
+
+    // 签名收集阶段：检查 main 函数和重复定义，建立函数表
+    void declareFunctions(CompUnit &compUnit);
+
+    // 使用 collector 收集的函数表检查函数体（collector 须比本访问者存活更久）
+    void shareSignatures(const analyzeVisitor &collector);
+
+    // 按顺序并入另一个访问者的错误和警告
+    void mergeDiagnostics(const analyzeVisitor &other);
 
      // 未使用变量检查
     void checkUnusedVariables();
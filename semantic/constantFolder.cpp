@@ -0,0 +1,197 @@
+// constantFolder.cpp - 实现AST常量折叠与代数化简
+#include "constantFolder.h"
+#include "analyzeHelper.h"
+
+// 是否为数字字面量
+static bool isNumber(Expr *expr)
+{
+    return expr->kind == NodeKind::Number;
+}
+
+// 是否为值等于 expected 的数字字面量
+static bool isNumber(Expr *expr, int expected)
+{
+    auto number = nodeCast<NumberExpr>(expr);
+    return number && number->value == expected;
+}
+
+// 化简整个编译单元
+void ConstantFolder::fold(CompUnit &compUnit)
+{
+    dispatch(compUnit);
+}
+
+// 化简表达式，condition 表示其值是否只用作真假判断
+Expr *ConstantFolder::fold(Expr *expr, bool condition)
+{
+    bool outerCondition = inCondition;
+    inCondition = condition;
+    replacement = expr;
+    dispatch(*expr);
+    inCondition = outerCondition;
+    return replacement;
+}
+
+// 创建数字字面量，类型和常量值直接填好
+Expr *ConstantFolder::makeNumber(int value, SourceOffset offset)
+{
+    NumberExpr *number = unit->arena.make<NumberExpr>(value, offset);
+    number->type = ExprType::Int;
+    number->constState = ConstState::Constant;
+    number->constValue = value;
+    return number;
+}
+
+// 数字字面量无需处理
+void ConstantFolder::visit(NumberExpr &) {}
+// 变量引用无需处理
+void ConstantFolder::visit(VariableExpr &) {}
+
+// 二元表达式：先化简操作数，再尝试整体折叠或应用恒等式
+void ConstantFolder::visit(BinaryExpr &expr)
+{
+    bool logical = expr.op == BinOp::And || expr.op == BinOp::Or;
+    // 逻辑运算的左操作数只用于判断真假；右操作数的值在值上下文中就是整个表达式的值
+    expr.left = fold(expr.left, logical);
+    expr.right = fold(expr.right, logical && inCondition);
+    // 化简子表达式时 replacement 被改写，这里恢复为自身
+    replacement = &expr;
+
+    // 两个操作数都是常量时整体折叠。
+    // 值上下文中的 && 和 || 不折叠：短路求值以右操作数的值作为结果（见 IRGenerator::generateShortCircuitAnd），
+    // 与 evaluateConstant 得到的 0/1 不一定相同
+    if (isNumber(expr.left) && isNumber(expr.right) && (!logical || inCondition)) {
+        if (OptionalInt value = analyzeHelper::evaluateConstant(&expr)) {
+            replacement = makeNumber(*value, expr.offset);
+        }
+        return;
+    }
+
+    // 代数恒等式：x*1、1*x、x/1、x+0、0+x、x-0
+    switch (expr.op) {
+        case BinOp::Mul:
+            if (isNumber(expr.right, 1)) replacement = expr.left;
+            else if (isNumber(expr.left, 1)) replacement = expr.right;
+            break;
+        case BinOp::Div:
+            if (isNumber(expr.right, 1)) replacement = expr.left;
+            break;
+        case BinOp::Add:
+            if (isNumber(expr.right, 0)) replacement = expr.left;
+            else if (isNumber(expr.left, 0)) replacement = expr.right;
+            break;
+        case BinOp::Sub:
+            if (isNumber(expr.right, 0)) replacement = expr.left;
+            break;
+        default:
+            break;
+    }
+}
+
+// 一元表达式
+void ConstantFolder::visit(UnaryExpr &expr)
+{
+    switch (expr.op) {
+        case UnOp::Plus:
+            // +x 就是 x，保持所在的上下文
+            replacement = fold(expr.operand, inCondition);
+            return;
+        case UnOp::Not:
+            // !x 只关心 x 的真假
+            expr.operand = fold(expr.operand, true);
+            break;
+        case UnOp::Neg:
+            expr.operand = fold(expr.operand, false);
+            break;
+    }
+    replacement = &expr;
+
+    if (isNumber(expr.operand)) {
+        if (OptionalInt value = analyzeHelper::evaluateConstant(&expr)) {
+            replacement = makeNumber(*value, expr.offset);
+        }
+        return;
+    }
+
+    // 条件上下文中 !!x 与 x 的真假相同
+    if (expr.op == UnOp::Not && inCondition) {
+        auto inner = nodeCast<UnaryExpr>(expr.operand);
+        if (inner && inner->op == UnOp::Not) {
+            replacement = inner->operand;
+        }
+    }
+}
+
+// 函数调用：化简每个实参
+void ConstantFolder::visit(CallExpr &expr)
+{
+    for (size_t i = 0; i < expr.arguments.size(); ++i) {
+        expr.arguments[i] = fold(expr.arguments[i]);
+    }
+    replacement = &expr;
+}
+
+// 表达式语句
+void ConstantFolder::visit(ExprStmt &stmt)
+{
+    if (stmt.expression) {
+        stmt.expression = fold(stmt.expression);
+    }
+}
+// 变量声明语句
+void ConstantFolder::visit(VarDeclStmt &stmt)
+{
+    if (stmt.initializer) {
+        stmt.initializer = fold(stmt.initializer);
+    }
+}
+// 赋值语句
+void ConstantFolder::visit(AssignStmt &stmt)
+{
+    stmt.value = fold(stmt.value);
+}
+// 语句块
+void ConstantFolder::visit(BlockStmt &stmt)
+{
+    for (auto &s : stmt.statements) {
+        dispatch(*s);
+    }
+}
+// if语句：条件只用于判断真假
+void ConstantFolder::visit(IfStmt &stmt)
+{
+    stmt.condition = fold(stmt.condition, true);
+    dispatch(*stmt.thenBranch);
+    if (stmt.elseBranch) {
+        dispatch(*stmt.elseBranch);
+    }
+}
+// while语句：条件只用于判断真假
+void ConstantFolder::visit(WhileStmt &stmt)
+{
+    stmt.condition = fold(stmt.condition, true);
+    dispatch(*stmt.body);
+}
+void ConstantFolder::visit(BreakStmt &) {}
+void ConstantFolder::visit(ContinueStmt &) {}
+// return语句
+void ConstantFolder::visit(ReturnStmt &stmt)
+{
+    if (stmt.value) {
+        stmt.value = fold(stmt.value);
+    }
+}
+// 函数定义
+void ConstantFolder::visit(FunctionDef &funcDef)
+{
+    dispatch(*funcDef.body);
+}
+// 编译单元
+void ConstantFolder::visit(CompUnit &compUnit)
+{
+    unit = &compUnit;
+    for (auto &func : compUnit.functions) {
+        dispatch(*func);
+    }
+    unit = nullptr;
+}
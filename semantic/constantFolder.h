@@ -0,0 +1,46 @@
+// constantFolder.h - 语义分析之后、IR生成之前在AST上进行的常量折叠与代数化简
+#pragma once
+#include "parser/astVisitor.h"
+
+// ConstantFolder - 就地改写AST的访问者
+// 自底向上处理表达式：子表达式化简后，若整个表达式是常量（evaluateConstant 的结果已缓存在节点上），
+// 就用新的数字字面量替换它；否则应用代数恒等式 x*1、x/1、x+0、x-0、+x，
+// 以及只关心真假的条件上下文中的 !!x -> x。
+// 新节点分配在编译单元的内存池中。必须在语义分析通过之后运行（依赖表达式类型，且不产生诊断信息）
+class ConstantFolder : public StaticASTVisitor<ConstantFolder>
+{
+private:
+    CompUnit *unit = nullptr;   // 正在处理的编译单元（提供内存池）
+    Expr *replacement = nullptr;// 访问表达式后得到的替换结果
+    bool inCondition = false;   // 当前表达式的值是否只用作真假判断
+
+    // 化简表达式，返回替换后的表达式（可能就是原表达式）
+    Expr *fold(Expr *expr, bool condition = false);
+
+    // 创建一个数字字面量节点
+    Expr *makeNumber(int value, SourceOffset offset);
+
+public:
+    // 化简整个编译单元
+    void fold(CompUnit &compUnit);
+
+    // 表达式
+    void visit(NumberExpr &expr);
+    void visit(VariableExpr &expr);
+    void visit(BinaryExpr &expr);
+    void visit(UnaryExpr &expr);
+    void visit(CallExpr &expr);
+    // 语句
+    void visit(ExprStmt &stmt);
+    void visit(VarDeclStmt &stmt);
+    void visit(AssignStmt &stmt);
+    void visit(BlockStmt &stmt);
+    void visit(IfStmt &stmt);
+    void visit(WhileStmt &stmt);
+    void visit(BreakStmt &stmt);
+    void visit(ContinueStmt &stmt);
+    void visit(ReturnStmt &stmt);
+    // 其它
+    void visit(FunctionDef &funcDef);
+    void visit(CompUnit &compUnit);
+};
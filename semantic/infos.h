@@ -2,6 +2,10 @@
 #pragma once
 #include <string>
 #include <vector>
+#include <unordered_map>
+#include "common/stringInterner.h"
+#include "lexer/sourceManager.h"
+#include "parser/ast.h"
 
 // Symbol - 符号表条目，表示变量、函数或参数
 struct Symbol
@@ -15,9 +19,8 @@ struct Symbol
     };
 
     Kind kind;                 // 符号种类
-    std::string type;          // 符号类型 ("int" 或 "void")
-    int line;                  // 符号在源代码中的行号
-    int column;                // 符号在源代码中的列号
+    ExprType type = ExprType::Int; // 符号类型（变量和参数为 int，函数为返回类型）
+    SourceOffset offset = kNoLocation; // 符号在源代码中的位置
     int paramIndex;            // 参数索引（仅用于函数参数）
 
     // 函数相关信息
@@ -30,30 +33,33 @@ struct Symbol
     Symbol() {}
 
     // 普通变量或参数的构造函数
-    Symbol(Kind kind, const std::string &type,
-           int line = 0, int column = 0, int paramIndex = -1)
+    Symbol(Kind kind, ExprType type,
+           SourceOffset offset = kNoLocation, int paramIndex = -1)
         : kind(kind), type(type),
-          line(line), column(column), paramIndex(paramIndex), used(false) {}
+          offset(offset), paramIndex(paramIndex), used(false) {}
           
     // 函数的构造函数
-    Symbol(Kind kind, const std::string &type,
+    Symbol(Kind kind, ExprType type,
            const std::vector<std::pair<std::string, std::string>>& parameters,
-           int line = 0, int column = 0)
+           SourceOffset offset = kNoLocation)
         : kind(kind), type(type),
-          line(line), column(column), paramIndex(-1), params(parameters), used(false) {}
+          offset(offset), paramIndex(-1), params(parameters), used(false) {}
 };
 
 // FunctionInfo - 保存函数相关信息的结构体
+// 签名收集阶段填写，之后只读（函数体检查可以并行进行）
 struct FunctionInfo
 {
-    std::string returnType;              // 函数返回类型
-    std::vector<std::string> paramTypes; // 参数类型列表
-    std::vector<std::string> paramNames; // 参数名称列表
-    int line;                            // 函数在源代码中的行号
-    int column;                          // 函数在源代码中的列号
+    ExprType returnType;                 // 函数返回类型
+    std::vector<ExprType> paramTypes;    // 参数类型列表
+    std::vector<SymbolId> paramNames;    // 参数名称列表
+    SourceOffset offset;                 // 函数在源代码中的位置
     bool used = false;                   // 函数是否被调用（用于未使用函数警告）
 
-    FunctionInfo(const std::string &returnType = "void",
-                 bool defined = false, int line = 0, int column = 0)
-        : returnType(returnType), line(line), column(column), used(false) {}
+    FunctionInfo(ExprType returnType = ExprType::Void,
+                 bool defined = false, SourceOffset offset = kNoLocation)
+        : returnType(returnType), offset(offset), used(false) {}
 };
+
+// 函数表：函数名编号 -> 函数信息
+using FunctionTable = std::unordered_map<SymbolId, FunctionInfo>;
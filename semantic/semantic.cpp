@@ -1,29 +1,37 @@
 // semantic.cpp - 实现语义分析器
 #include "semantic.h"
 #include "analyzeHelper.h"
+#include "common/threadPool.h"
 #include <iostream>
+#include <memory>
 #include <sstream>
 
 // 语义分析入口
-bool SemanticAnalyzer::analyze(std::shared_ptr<CompUnit> ast)
+bool SemanticAnalyzer::analyze(CompUnit& ast, ThreadPool* pool)
 {
     // 清空上次分析的错误和警告
     clearMessages();
     
-    // 设置analyzeHelper的owner
-    analyzeHelper::setSemanticOwner(*this);
-    
     // 遍历AST进行语义分析
-    ast->accept(visitor);
+    if (pool) {
+        analyzeFunctionsInParallel(ast, *pool);
+    } else {
+        visitor.dispatch(ast);
+    }
     
     // 执行额外的检查
-    if (success) {
+    if (visitor.success) {
         // 检查未使用的变量
         checkUnusedVariables();
         
         // 检查死代码
         detectDeadCode();
     }
+
+    // 收集访问者记录的错误和警告
+    success = visitor.success;
+    errorMessages = visitor.errorMessages;
+    warningMessages = visitor.warningMessages;
     
     // 输出所有收集到的错误
     for (const auto& error : errorMessages) {
@@ -38,6 +46,29 @@ bool SemanticAnalyzer::analyze(std::shared_ptr<CompUnit> ast)
     return success;
 }
 
+// 并行检查函数体
+void SemanticAnalyzer::analyzeFunctionsInParallel(CompUnit& ast, ThreadPool& pool)
+{
+    // 签名收集必须在所有函数体检查之前完成，之后函数表只读
+    visitor.declareFunctions(ast);
+
+    std::vector<std::unique_ptr<analyzeVisitor>> workers(ast.functions.size());
+    pool.parallelFor(ast.functions.size(), [&](size_t index) {
+        auto worker = std::make_unique<analyzeVisitor>();
+        worker->shareSignatures(visitor);
+        worker->dispatch(*ast.functions[index]);
+        workers[index] = std::move(worker);
+    });
+
+    // 按函数在源代码中的顺序合并诊断信息，结果与线程调度无关
+    for (const auto& worker : workers) {
+        visitor.mergeDiagnostics(*worker);
+    }
+
+    // 检查未使用的函数
+    visitor.detectDeadCode();
+}
+
 // 检查未使用的变量
 void SemanticAnalyzer::checkUnusedVariables()
 {
@@ -6,14 +6,22 @@
 #include "parser/astVisitor.h"
 #include "analyzeVisitor.h"
 
+class ThreadPool;
+
 // SemanticAnalyzer - 语义分析器类，协调整个语义分析过程
 class SemanticAnalyzer
 {
 private:
     analyzeVisitor visitor;
 
+    // 并行检查函数体：每个函数由独立的访问者检查，诊断信息按函数顺序合并
+    void analyzeFunctionsInParallel(CompUnit& ast, ThreadPool& pool);
+
 public:
-    SemanticAnalyzer() : visitor() {}
+    SemanticAnalyzer(const SourceManager& sources, const StringInterner& identifiers) : visitor() {
+        visitor.setSourceManager(&sources);
+        visitor.setIdentifiers(&identifiers);
+    }
     
     bool success = true;
     // 错误信息集合
@@ -21,8 +29,13 @@ public:
     // 警告信息集合
     std::vector<std::string> warningMessages;
 
-    // 分析入口（自顶向下扫ast）
-    bool analyze(std::shared_ptr<CompUnit> ast);
+    /*
+     * 分析入口（自顶向下扫ast）
+     * @param ast 编译单元
+     * @param pool 线程池，非空时在签名收集之后并行检查各函数体
+     * @return 是否没有语义错误
+    */
+    bool analyze(CompUnit& ast, ThreadPool* pool = nullptr);
 
     // 获取错误信息
     const std::vector<std::string>& getErrors() const { return errorMessages; }